@@ -46,6 +46,8 @@ ZenEvents about sensor discovery results and incoming measurement data.
 #include <cstddef>
 #include <cstring>
 #include <cassert>
+#include <functional>
+#include <memory>
 #include <string>
 #include <thread>
 #include <utility>
@@ -167,6 +169,28 @@ namespace zen
             return ZenSensorComponentType(m_clientHandle, m_sensorHandle, m_componentHandle);
         }
 
+        /**
+         * Copies the most recent IMU sample of this component without draining the event queue.
+         * Returns the error and the number of samples published so far, which is zero if no
+         * sample arrived yet.
+         */
+        std::pair<ZenError, uint64_t> getLatestImuData(ZenImuData& outData) noexcept
+        {
+            auto result = std::make_pair(ZenError_None, uint64_t(0));
+            result.first = ZenSensorComponentGetLatestImuData(m_clientHandle, m_sensorHandle, m_componentHandle, &outData, &result.second);
+            return result;
+        }
+
+        /**
+         * Copies the most recent GNSS sample of this component, see getLatestImuData
+         */
+        std::pair<ZenError, uint64_t> getLatestGnssData(ZenGnssData& outData) noexcept
+        {
+            auto result = std::make_pair(ZenError_None, uint64_t(0));
+            result.first = ZenSensorComponentGetLatestGnssData(m_clientHandle, m_sensorHandle, m_componentHandle, &outData, &result.second);
+            return result;
+        }
+
         /**
          * Triggers the execution of a property that supports that feature, for example the
          * ZenImuProperty_CalibrateGyro property to start the Gyro calibration.
@@ -319,9 +343,18 @@ namespace zen
     {
         friend class ZenClient;
 
+    public:
+        using EventCallback = std::function<void(const ZenEvent&)>;
+
     private:
         ZenClientHandle_t m_clientHandle;
         ZenSensorHandle_t m_sensorHandle;
+        std::shared_ptr<EventCallback> m_eventCallback;
+
+        static void invokeEventCallback(ZenClientHandle_t, const ZenEvent* event, void* userData)
+        {
+            (*static_cast<EventCallback*>(userData))(*event);
+        }
 
     protected:
         ZenSensor(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle)
@@ -335,6 +368,7 @@ namespace zen
         ZenSensor(ZenSensor&& other)
             : m_clientHandle(other.m_clientHandle)
             , m_sensorHandle(other.m_sensorHandle)
+            , m_eventCallback(std::move(other.m_eventCallback))
         {
             other.m_sensorHandle.handle = 0;
         }
@@ -360,6 +394,76 @@ namespace zen
             return err;
         }
 
+        /**
+         * Filters the events of this sensor which are queued for the client, for example to
+         * receive only the events of one component.
+         */
+        ZenError setEventFilter(const ZenEventFilter& filter) noexcept
+        {
+            return ZenSetSensorEventFilter(m_clientHandle, m_sensorHandle, &filter);
+        }
+
+        /** Restores the filter of the client for this sensor */
+        ZenError resetEventFilter() noexcept
+        {
+            return ZenSetSensorEventFilter(m_clientHandle, m_sensorHandle, nullptr);
+        }
+
+        /**
+         * Delivers the events of this sensor to the callback instead of the event queue of the client.
+         * The callback is invoked on the IO thread of the sensor, so it must return quickly, must not
+         * block and must not call OpenZen functions. Passing an empty function delivers events to the
+         * event queue again. The callback is unregistered when the sensor is released.
+         */
+        ZenError onEvent(EventCallback callback) noexcept
+        {
+            if (!callback)
+            {
+                auto error = ZenRegisterEventCallback(m_clientHandle, m_sensorHandle, nullptr, nullptr);
+                if (error == ZenError_None)
+                    m_eventCallback.reset();
+                return error;
+            }
+
+            // The previous callback is only destroyed after it was replaced, so it cannot be running anymore
+            auto eventCallback = std::make_shared<EventCallback>(std::move(callback));
+            auto error = ZenRegisterEventCallback(m_clientHandle, m_sensorHandle, &ZenSensor::invokeEventCallback, eventCallback.get());
+            if (error == ZenError_None)
+                m_eventCallback = std::move(eventCallback);
+            return error;
+        }
+
+        /**
+         * Returns the number of events of this sensor which were dropped because the event queue
+         * of a subscriber was full.
+         */
+        std::pair<ZenError, uint64_t> droppedEventCount() noexcept
+        {
+            auto result = std::make_pair(ZenError_None, uint64_t(0));
+            result.first = ZenSensorDroppedEventCount(m_clientHandle, m_sensorHandle, &result.second);
+            return result;
+        }
+
+        /**
+         * Returns statistics of the reads from the sensor's IO interface, see ZenSensorIoStatistics
+         */
+        std::pair<ZenError, ZenIoStatistics> ioStatistics() noexcept
+        {
+            auto result = std::make_pair(ZenError_None, ZenIoStatistics{});
+            result.first = ZenSensorIoStatistics(m_clientHandle, m_sensorHandle, &result.second);
+            return result;
+        }
+
+        /**
+         * Returns the errors of the data received from the sensor, see ZenSensorFrameStatistics
+         */
+        std::pair<ZenError, ZenFrameStatistics> frameStatistics() noexcept
+        {
+            auto result = std::make_pair(ZenError_None, ZenFrameStatistics{});
+            result.first = ZenSensorFrameStatistics(m_clientHandle, m_sensorHandle, &result.second);
+            return result;
+        }
+
         /** On first call, tries to initialises a firmware update, and returns an error on failure.
          * Subsequent calls do not require a valid buffer and buffer size, and only report the current status:
          * Returns ZenAsync_Updating while busy updating firmware.
@@ -417,6 +521,23 @@ namespace zen
             return ZenPublishEvents(m_clientHandle, m_sensorHandle, endpoint.c_str());
         }
 
+        /**
+         * Publish the data events from this sensor over a network interface at a reduced rate
+         */
+        ZenError publishEvents(std::string const& endpoint, const ZenEventDecimation& decimation) noexcept {
+            return ZenPublishEventsDecimated(m_clientHandle, m_sensorHandle, endpoint.c_str(), &decimation);
+        }
+
+        /**
+         * Publish the data events from this sensor over a network interface, buffering at most queueCapacity
+         * events (0 for the default) which are handled by the overflow policy if the network falls behind
+         */
+        ZenError publishEvents(std::string const& endpoint, const ZenEventDecimation& decimation, size_t queueCapacity,
+            ZenEventQueueOverflowPolicy overflowPolicy) noexcept {
+            return ZenPublishEventsQueued(m_clientHandle, m_sensorHandle, endpoint.c_str(), &decimation,
+                queueCapacity, overflowPolicy);
+        }
+
         /**
          * Execute a sensor property which supports to be executed
          */
@@ -642,6 +763,68 @@ namespace zen
             return err;
         }
 
+        /**
+         * Selects the container of this client's event queue. Needs to be called before any
+         * sensor is listed or obtained, afterwards it fails with ZenError_AlreadyInitialized. With ZenEventQueueType_LockFree, at most capacity events
+         * are queued and new events are dropped if the queue is not drained fast enough.
+         * ZenEventQueueType_Conflating only keeps the newest unread sample of each sensor component.
+         */
+        ZenError setEventQueueType(ZenEventQueueType type, size_t capacity = 0) noexcept
+        {
+            return ZenSetEventQueueType(m_handle, type, capacity);
+        }
+
+        /**
+         * Selects what happens when a sensor publishes an event while the bounded event queue
+         * of this client is full. The default is ZenEventQueueOverflowPolicy_DropNewest.
+         */
+        ZenError setEventQueueOverflowPolicy(ZenEventQueueOverflowPolicy policy) noexcept
+        {
+            return ZenSetEventQueueOverflowPolicy(m_handle, policy);
+        }
+
+        /**
+         * Filters the events which are queued for this client, for all of its sensors and for the
+         * sensor listing. Rejected events are discarded before they are queued.
+         */
+        ZenError setEventFilter(const ZenEventFilter& filter) noexcept
+        {
+            return ZenSetEventFilter(m_handle, &filter);
+        }
+
+        /** Accepts all events again */
+        ZenError resetEventFilter() noexcept
+        {
+            return ZenSetEventFilter(m_handle, nullptr);
+        }
+
+        /**
+         * Reduces the rate of samples which are queued for this client, for example to
+         * receive a 800 Hz IMU stream at 60 Hz with a minimum interval of 16667 microseconds.
+         */
+        ZenError setEventDecimation(const ZenEventDecimation& decimation) noexcept
+        {
+            return ZenSetEventDecimation(m_handle, &decimation);
+        }
+
+        /** Keeps all samples again */
+        ZenError resetEventDecimation() noexcept
+        {
+            return ZenSetEventDecimation(m_handle, nullptr);
+        }
+
+        /**
+         * Returns a file descriptor which becomes readable when events are queued, to integrate
+         * the client into an epoll or asio reactor. Drain the queue with pollNextEvents whenever
+         * it is readable. Only supported on Linux, see ZenClientGetEventFd.
+         */
+        std::pair<ZenError, int> eventFd() noexcept
+        {
+            int fd = -1;
+            const auto error = ZenClientGetEventFd(m_handle, &fd);
+            return std::make_pair(error, fd);
+        }
+
         /** call the method ZenClient::listSensorsAsync to start the query for available sensors.
          * Depending on the IO systems, it can take a couple of seconds for the listing to be complete.
          * The ZenClient::listSensorsAsync method will return immediately and the information
@@ -650,7 +833,9 @@ namespace zen
          * do this on your applications main thread or use a background thread to retrieve the event
          * listing data.
          * The event types ZenSensorEvent_SensorListingProgress and ZenSensorEvent_SensorFound will contain
-         * provide the progress of the listing and report if a sensor has been found.
+         * provide the progress of the listing and report if a sensor has been found. Afterwards,
+         * ZenSensorEvent_SensorFound and ZenSensorEvent_SensorRemoved events report sensors which
+         * are plugged in or out, if their IO system monitors hotplugging.
          */
         ZenError listSensorsAsync() noexcept
         {
@@ -797,6 +982,56 @@ namespace zen
             }
         }
 #endif
+
+        /**
+         * Moves up to maxEvents events from the queue of this ZenClient to the events
+         * array and returns how many were moved. This method will return immediately.
+         * Draining the queue in batches is cheaper than calling pollNextEvent per event.
+         */
+        size_t pollNextEvents(ZenEvent* const events, size_t maxEvents) noexcept
+        {
+            size_t count = 0;
+            ZenPollNextEvents(m_handle, events, maxEvents, &count);
+            return count;
+        }
+
+        /**
+         * Returns up to maxEvents events from the queue of this ZenClient. This method will
+         * return immediately. If no event is available on the queue, the vector will be empty.
+         */
+        std::vector<ZenEvent> pollNextEvents(size_t maxEvents) noexcept
+        {
+            std::vector<ZenEvent> events(maxEvents);
+            events.resize(pollNextEvents(events.data(), events.size()));
+            return events;
+        }
+
+        /**
+         * Wait until at least one event is available on the queue of this ZenClient or the
+         * waitTime passes, then move up to maxEvents events to the events array. Returns how
+         * many events were moved, which is zero on timeout or if the client is closed on another thread.
+         */
+        template<class Rep, class Period>
+        size_t waitForNextEventsFor(ZenEvent* const events, size_t maxEvents, std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            size_t count = 0;
+            ZenWaitForNextEventsForMs(m_handle, std::chrono::duration_cast<std::chrono::milliseconds>(waitTime).count(),
+                events, maxEvents, &count);
+            return count;
+        }
+
+        /**
+         * Wait until at least one event is available on the queue of this ZenClient or the
+         * waitTime passes, then return up to maxEvents events. The vector will be empty on timeout
+         * or if the client is closed on another thread.
+         */
+        template<class Rep, class Period>
+        std::vector<ZenEvent> waitForNextEventsFor(size_t maxEvents, std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            std::vector<ZenEvent> events(maxEvents);
+            events.resize(waitForNextEventsFor(events.data(), events.size(), waitTime));
+            return events;
+        }
     };
 
     /**
@@ -810,6 +1045,15 @@ namespace zen
         const auto error = ZenInit(&handle);
         return std::make_pair(error, ZenClient(handle));
     }
+
+    /**
+    Returns the monotonic host time on the clock of ZenEvent::receivedTimestampNs and
+    ZenEvent::queuedTimestampNs. Compare it to these stamps to measure the latency of an event.
+    */
+    inline std::chrono::nanoseconds hostTimestamp() noexcept
+    {
+        return std::chrono::nanoseconds(ZenGetHostTimestampNs());
+    }
 }
 
 #endif
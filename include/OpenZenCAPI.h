@@ -48,9 +48,73 @@ extern "C" {
     */
     ZEN_API ZenError ZenSetLogLevel(ZenLogLevel logLevel);
 
+    /**
+    Returns the current monotonic host time in nanoseconds, on the same clock as the receivedTimestampNs
+    and queuedTimestampNs of ZenEvent. Compare it to these stamps to measure the latency of an event.
+    */
+    ZEN_API uint64_t ZenGetHostTimestampNs(void);
+
+    /**
+    Sets the number of threads which read from all serial devices of the process. The threads are started
+    when the first serial sensor is obtained and stopped when the last one is released, so the count applies
+    from the next start on. Only supported on Linux, fails with ZenError_NotSupported on other platforms.
+    */
+    ZEN_API ZenError ZenSetIoThreadCount(uint32_t count);
+
+    /**
+    Records the raw data received from and sent to every sensor obtained from now on into a file in the
+    directory, which is named after the sensor's IO type and the time it was obtained. A capture can be
+    replayed by obtaining a sensor with the IO type "Replay" and the path of the file as identifier, prefixed
+    with "fast:" to replay it as fast as possible instead of at its original timing. A relative path is looked
+    up in the capture directory, identifiers are limited to 63 characters.
+    @param directory Existing directory for the captures, NULL or an empty string disables capturing
+    */
+    ZEN_API ZenError ZenSetIoCaptureDirectory(const char* directory);
+
+    /**
+    Selects the container of the client's event queue. ZenEventQueueType_LockFree avoids taking a
+    mutex for every event published by a sensor, but always holds a limited number of events.
+    ZenEventQueueType_Conflating overwrites an unread sample with the newer sample of the same sensor
+    component, so a slow consumer always receives the latest values.
+    This needs to be called before any sensor is listed or obtained with this client. It fails with
+    ZenError_AlreadyInitialized while the client holds sensors, and after ZenListSensorsAsync was called.
+    @param capacity Maximum number of queued events. Rounded up to the next power of two for
+                    ZenEventQueueType_LockFree. Use 0 for an unbounded ZenEventQueueType_Locking queue,
+                    or for the default capacity of ZenEventQueueType_LockFree.
+    */
+    ZEN_API ZenError ZenSetEventQueueType(ZenClientHandle_t handle, ZenEventQueueType type, size_t capacity);
+
+    /**
+    Selects what happens when a sensor publishes an event while the client's bounded event queue is full.
+    The default is ZenEventQueueOverflowPolicy_DropNewest. With ZenEventQueueOverflowPolicy_Block, a client
+    which does not drain its queue stalls the IO of all its sensors.
+    */
+    ZEN_API ZenError ZenSetEventQueueOverflowPolicy(ZenClientHandle_t handle, ZenEventQueueOverflowPolicy policy);
+
+    /** Filters the events which are queued for this client. The filter applies to all sensors obtained by the client,
+    including sensors obtained later, and to the events of ZenListSensorsAsync. It replaces any filter set by
+    ZenSetSensorEventFilter. Passing NULL accepts all events again.
+    */
+    ZEN_API ZenError ZenSetEventFilter(ZenClientHandle_t handle, const ZenEventFilter* const filter);
+
+    /** Reduces the rate of samples which are queued for this client, separately for each sensor component.
+    Passing NULL keeps all samples again.
+    */
+    ZEN_API ZenError ZenSetEventDecimation(ZenClientHandle_t handle, const ZenEventDecimation* const decimation);
+
+    /** Returns a file descriptor which becomes readable when events are queued for this client, to wait for
+    events with epoll or select next to other descriptors. A burst of events wakes up the reactor once. The
+    descriptor stays readable until a call to ZenPollNextEvent or ZenPollNextEvents finds the queue empty,
+    so drain the queue whenever it is readable. The descriptor is owned by the client and closed by ZenShutdown.
+    Only supported on Linux, fails with ZenError_NotSupported on other platforms.
+    */
+    ZEN_API ZenError ZenClientGetEventFd(ZenClientHandle_t handle, int* const outFd);
+
     /** Opts in to an asynchronous process that lists available sensors.
      * ZenEventData_SensorListingProgress events will be queued to indicate progress.
      * ZenEventData_SensorFound events will be queued to signal sensor descriptions.
+     * Afterwards, sensors which are plugged in or out are reported with ZenEventData_SensorFound
+     * and ZenEventData_SensorRemoved events, if their IO system monitors hotplugging.
      */
     ZEN_API ZenError ZenListSensorsAsync(ZenClientHandle_t handle);
 
@@ -91,9 +155,44 @@ extern "C" {
         or after the given timeout in milliseconds  */
     ZEN_API bool ZenWaitForNextEventForMs(ZenClientHandle_t handle, long long waitTimeMs, ZenEvent* const outEvent);
 
+    /** Moves up to maxEvents queued events to outEvents and sets outCount to the number of events moved.
+        Returns immediately, outCount is zero if no event is queued. The event queue is accessed only once
+        per call, which makes this cheaper than repeated calls to ZenPollNextEvent when draining high-rate streams. */
+    ZEN_API ZenError ZenPollNextEvents(ZenClientHandle_t handle, ZenEvent* const outEvents, size_t maxEvents, size_t* const outCount);
+
+    /** Waits until at least one event is queued, then moves up to maxEvents queued events to outEvents and
+        sets outCount to the number of events moved. outCount is zero after the given timeout in milliseconds
+        or upon a call to ZenShutdown() */
+    ZEN_API ZenError ZenWaitForNextEventsForMs(ZenClientHandle_t handle, long long waitTimeMs, ZenEvent* const outEvents, size_t maxEvents, size_t* const outCount);
+
+    /** Filters the events of one sensor which are queued for this client. Use a filter with an empty event type
+        range to receive no events of the sensor at all. Passing NULL restores the filter set by ZenSetEventFilter. */
+    ZEN_API ZenError ZenSetSensorEventFilter(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const ZenEventFilter* const filter);
+
+    /** Delivers the events of a sensor to the callback instead of the event queue of the client. The callback is
+        invoked on the IO thread of the sensor as soon as an event was decoded, which avoids the latency of the queue.
+        It must return quickly, must not block and must not call back into the OpenZen API, otherwise it stalls or
+        deadlocks the sensor. Passing a NULL callback delivers events to the event queue again. Releasing the sensor
+        unregisters the callback. */
+    ZEN_API ZenError ZenRegisterEventCallback(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenEventCallback callback, void* userData);
+
     /** Publish all data events encountered by OpenZen over a network interface */
     ZEN_API ZenError ZenPublishEvents(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* endpoint);
 
+    /** Publish the data events of a sensor over a network interface at a reduced rate */
+    ZEN_API ZenError ZenPublishEventsDecimated(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* endpoint,
+        const ZenEventDecimation* const decimation);
+
+    /**
+    Publish the data events of a sensor over a network interface, with a chosen queue between the sensor and the network.
+    @param decimation Reduces the rate of samples, NULL publishes all of them
+    @param queueCapacity Maximum number of events which wait to be sent, 0 for the default of 1024 events
+    @param overflowPolicy What happens when the sensor publishes while the queue is full. ZenPublishEvents uses
+                          ZenEventQueueOverflowPolicy_DropOldest, ZenEventQueueOverflowPolicy_Block stalls the sensor's IO.
+    */
+    ZEN_API ZenError ZenPublishEventsQueued(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* endpoint,
+        const ZenEventDecimation* const decimation, size_t queueCapacity, ZenEventQueueOverflowPolicy overflowPolicy);
+
     /** If successful, directs the outComponents pointer to a list of sensor components and sets its length to outLength, otherwise, returns an error.
      * If the type variable points to a string, only components of that type are returned. If it is a nullptr, all components are returned, irrespective of type.
      */
@@ -110,6 +209,19 @@ extern "C" {
     /** Returns the sensor's device name */
     ZEN_API const char* ZenSensorName(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle);
 
+    /** Returns the number of events of this sensor which were dropped because a subscribed event queue was full */
+    ZEN_API ZenError ZenSensorDroppedEventCount(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, uint64_t* const outCount);
+
+    /** Returns statistics of the reads from the sensor's IO interface.
+     * Returns ZenError_NotSupported if the IO interface does not measure them, currently only serial devices on Linux do.
+     */
+    ZEN_API ZenError ZenSensorIoStatistics(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenIoStatistics* const outStatistics);
+
+    /** Returns the number of corrupted frames and discarded bytes in the data received from the sensor.
+     * Returns ZenError_NotSupported if the sensor is not connected by a data stream.
+     */
+    ZEN_API ZenError ZenSensorFrameStatistics(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenFrameStatistics* const outStatistics);
+
     /** Returns whether the sensor is equal to the sensor description */
     ZEN_API bool ZenSensorEquals(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const ZenSensorDesc* const desc);
 
@@ -179,6 +291,17 @@ extern "C" {
     /** Returns the type of the sensor component */
     ZEN_API const char* ZenSensorComponentType(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle);
 
+    /** Copies the most recent IMU sample of the component, independent of the event queue. The sample is read
+        without locking out the IO thread of the sensor. outSeq is set to the number of samples the component
+        published so far, so a changed value signals new data. If it is zero, no sample arrived yet and
+        outData is left untouched. Returns ZenError_WrongDataType if the component does not publish IMU data. */
+    ZEN_API ZenError ZenSensorComponentGetLatestImuData(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle,
+        ZenImuData* const outData, uint64_t* const outSeq);
+
+    /** Copies the most recent GNSS sample of the component, see ZenSensorComponentGetLatestImuData */
+    ZEN_API ZenError ZenSensorComponentGetLatestGnssData(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle,
+        ZenGnssData* const outData, uint64_t* const outSeq);
+
     /** If successful executes the property, otherwise returns an error. */
     ZEN_API ZenError ZenSensorComponentExecuteProperty(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle, ZenProperty_t property);
 
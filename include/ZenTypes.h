@@ -163,6 +163,24 @@ typedef enum ZenLogLevel
     ZenLogLevel_Max
 } ZenLogLevel;
 
+typedef enum ZenEventQueueType
+{
+    ZenEventQueueType_Locking,      // Queue protected by a mutex, unbounded unless a capacity is set (default)
+    ZenEventQueueType_LockFree,     // Bounded lock-free ring buffer
+    ZenEventQueueType_Conflating,   // Locking queue which holds only the newest unread sample of each sensor component
+
+    ZenEventQueueType_Max
+} ZenEventQueueType;
+
+typedef enum ZenEventQueueOverflowPolicy
+{
+    ZenEventQueueOverflowPolicy_DropNewest,     // Discard the new event if the queue is full (default)
+    ZenEventQueueOverflowPolicy_DropOldest,     // Discard the oldest queued event to make room for the new one
+    ZenEventQueueOverflowPolicy_Block,          // Block the sensor's IO thread until the queue has room
+
+    ZenEventQueueOverflowPolicy_Max
+} ZenEventQueueOverflowPolicy;
+
 typedef struct ZenImuData
 {
     /// Index of the data frame.
@@ -387,6 +405,69 @@ typedef struct ZenGnssData
 
 typedef ZenGnssData ZenEventData_Gnss;
 
+typedef enum ZenSerialIoFlags
+{
+    ZenSerialIoFlags_None = 0,
+
+    // Sets ASYNC_LOW_LATENCY on the serial port, so the driver hands over received bytes
+    // without batching them, and opens it without O_SYNC, so commands are not delayed
+    // until the previous write was transmitted
+    ZenSerialIoFlags_LowLatency = 1
+} ZenSerialIoFlags;
+
+/**
+ Options for sensors connected by a serial port, currently only applied on Linux.
+ A zero-initialized struct keeps the default behaviour.
+ */
+typedef struct ZenSerialIoOptions
+{
+    /// Combination of ZenSerialIoFlags
+    uint32_t flags;
+
+    /// Number of bytes requested by each read from the device.
+    /// Zero sizes the reads for the baud rate.
+    /// Unit: bytes
+    uint32_t readChunkSize;
+
+    /// Latency timer of FTDI USB adapters, which collect received bytes for this long before
+    /// they are passed on to the host. Zero keeps the default of the driver.
+    /// Unit: ms
+    uint32_t usbLatencyTimerMs;
+} ZenSerialIoOptions;
+
+/**
+ Statistics of the reads from the IO interface of a sensor, see ZenSensorIoStatistics
+ */
+typedef struct ZenIoStatistics
+{
+    /// Number of reads which returned data
+    uint64_t readCount;
+
+    /// Number of bytes received
+    uint64_t bytesRead;
+
+    /// Mean and maximum time from the moment the IO thread was woken up for available
+    /// data until the read completed.
+    /// Unit: nanoseconds
+    uint64_t meanReadLatencyNs;
+    uint64_t maxReadLatencyNs;
+} ZenIoStatistics;
+
+/**
+ Errors of the data stream received from a sensor, see ZenSensorFrameStatistics
+ */
+typedef struct ZenFrameStatistics
+{
+    /// Number of frames with an invalid checksum
+    uint64_t checksumErrors;
+
+    /// Number of frames with a missing end or an invalid length
+    uint64_t framingErrors;
+
+    /// Number of received bytes which did not belong to a valid frame
+    uint64_t bytesDiscarded;
+} ZenFrameStatistics;
+
 typedef struct ZenSensorDesc
 {
     /**
@@ -418,6 +499,12 @@ typedef struct ZenSensorDesc
      suitable baud rate with the device.
      */
     uint32_t baudRate;
+
+    /**
+     Options for sensors connected by a serial port. Zero-initialize them
+     to keep the default behaviour.
+     */
+    ZenSerialIoOptions serialOptions;
 } ZenSensorDesc;
 
 typedef struct ZenEventData_SensorDisconnected
@@ -427,11 +514,18 @@ typedef struct ZenEventData_SensorDisconnected
 
 typedef ZenSensorDesc ZenEventData_SensorFound;
 
+/* Description of a listed sensor which was unplugged */
+typedef ZenSensorDesc ZenEventData_SensorRemoved;
+
 typedef struct ZenEventData_SensorListingProgress
 {
     float progress;
     /* This variable is != zero if the search for sensors in complete */
     char complete;
+    /* IO system which finished listing its sensors, empty for the event which completes the search */
+    char ioType[64];
+    /* This variable is != zero if the IO system did not finish listing its sensors in time */
+    char timedOut;
 } ZenEventData_SensorListingProgress;
 
 typedef union
@@ -441,6 +535,7 @@ typedef union
     ZenEventData_SensorDisconnected sensorDisconnected;
     ZenEventData_SensorFound sensorFound;
     ZenEventData_SensorListingProgress sensorListingProgress;
+    ZenEventData_SensorRemoved sensorRemoved;
 } ZenEventData;
 
 typedef enum ZenEventType
@@ -450,6 +545,9 @@ typedef enum ZenEventType
     ZenEventType_SensorFound = 1,
     ZenEventType_SensorListingProgress = 2,
     ZenEventType_SensorDisconnected = 3,
+    /* Clients which listed sensors receive ZenEventType_SensorFound and ZenEventType_SensorRemoved
+       events when sensors are plugged in or out later, if the IO system monitors hotplugging */
+    ZenEventType_SensorRemoved = 4,
 
     ZenEventType_ImuData = 100,
 
@@ -476,8 +574,51 @@ typedef struct ZenEvent
     ZenSensorHandle_t sensor;
     ZenComponentHandle_t component;
     ZenEventData data;
+
+    /// Monotonic host time at which the bytes carrying this event were read from the OS,
+    /// see ZenGetHostTimestampNs. Zero for events which were not received from a sensor.
+    /// Unit: nanoseconds
+    uint64_t receivedTimestampNs;
+
+    /// Monotonic host time at which the event was handed to the client's event queue
+    /// or event callback, see ZenGetHostTimestampNs.
+    /// Unit: nanoseconds
+    uint64_t queuedTimestampNs;
 } ZenEvent;
 
+/**
+ Selects the events a client receives, see ZenSetEventFilter. Rejected events are
+ discarded by the sensor before they reach the event queue.
+ */
+typedef struct ZenEventFilter
+{
+    /* Only events of this component are accepted. A handle of 0 accepts all components */
+    ZenComponentHandle_t component;
+
+    /* Only events with a type between the two types, inclusive, are accepted */
+    ZenEventType minEventType;
+    ZenEventType maxEventType;
+} ZenEventFilter;
+
+/**
+ Reduces the rate of sample events, i.e. events with a type of ZenEventType_ImuData or
+ above, which a client receives from each sensor component, see ZenSetEventDecimation.
+ */
+typedef struct ZenEventDecimation
+{
+    /* Only every Nth sample is kept. 0 and 1 keep all samples */
+    uint32_t keepEveryNth;
+
+    /* Minimum time between two kept samples in microseconds. 0 disables the limit */
+    uint32_t minIntervalUs;
+} ZenEventDecimation;
+
+/**
+ Function which is called for each event of a sensor, see ZenRegisterEventCallback.
+ The event is only valid for the duration of the call.
+ */
+typedef void (*ZenEventCallback)(ZenClientHandle_t clientHandle, const ZenEvent* event, void* userData);
+
 typedef int ZenProperty_t;
 
 typedef enum EZenSensorProperty
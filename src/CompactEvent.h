@@ -0,0 +1,127 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_COMPACTEVENT_H_
+#define ZEN_COMPACTEVENT_H_
+
+#include <cstdint>
+#include <cstring>
+
+#include "ZenTypes.h"
+
+namespace zen
+{
+    /** Payloads which are carried by event queues. The sensor description of
+     * ZenEventType_SensorFound and ZenEventType_SensorRemoved is too large and is
+     * delivered next to the queue, see SensorClient::notifyEvent.
+     */
+    union CompactEventData
+    {
+        ZenEventData_Imu imuData;
+        ZenEventData_Gnss gnssData;
+        ZenEventData_SensorDisconnected sensorDisconnected;
+        ZenEventData_SensorListingProgress sensorListingProgress;
+
+        // Identifies the sensor description of a ZenEventType_SensorFound or ZenEventType_SensorRemoved event
+        uint64_t sensorFoundId;
+    };
+
+    /** Internal counterpart of ZenEvent, which is only half as large */
+    struct CompactEvent
+    {
+        ZenEventType eventType;
+        ZenSensorHandle_t sensor;
+        ZenComponentHandle_t component;
+        CompactEventData data;
+        uint64_t receivedTimestampNs;
+        uint64_t queuedTimestampNs;
+    };
+
+    /** Copies only the payload that belongs to the event type */
+    inline void toCompactEvent(const ZenEvent& event, CompactEvent& compact) noexcept
+    {
+        compact.eventType = event.eventType;
+        compact.sensor = event.sensor;
+        compact.component = event.component;
+        compact.receivedTimestampNs = event.receivedTimestampNs;
+        compact.queuedTimestampNs = event.queuedTimestampNs;
+
+        switch (event.eventType)
+        {
+        case ZenEventType_ImuData:
+            compact.data.imuData = event.data.imuData;
+            break;
+
+        case ZenEventType_GnssData:
+            compact.data.gnssData = event.data.gnssData;
+            break;
+
+        case ZenEventType_SensorDisconnected:
+            compact.data.sensorDisconnected = event.data.sensorDisconnected;
+            break;
+
+        case ZenEventType_SensorListingProgress:
+            compact.data.sensorListingProgress = event.data.sensorListingProgress;
+            break;
+
+        case ZenEventType_SensorFound:
+        case ZenEventType_SensorRemoved:
+            compact.data.sensorFoundId = 0;
+            break;
+
+        default:
+            // Sensor and component specific events keep as much of their payload as fits
+            std::memcpy(&compact.data, &event.data, sizeof(CompactEventData));
+            break;
+        }
+    }
+
+    /** Copies only the payload that belongs to the event type. The sensor description
+     * of ZenEventType_SensorFound and ZenEventType_SensorRemoved is not part of the compact event
+     * and is left untouched.
+     */
+    inline void toZenEvent(const CompactEvent& compact, ZenEvent& event) noexcept
+    {
+        event.eventType = compact.eventType;
+        event.sensor = compact.sensor;
+        event.component = compact.component;
+        event.receivedTimestampNs = compact.receivedTimestampNs;
+        event.queuedTimestampNs = compact.queuedTimestampNs;
+
+        switch (compact.eventType)
+        {
+        case ZenEventType_ImuData:
+            event.data.imuData = compact.data.imuData;
+            break;
+
+        case ZenEventType_GnssData:
+            event.data.gnssData = compact.data.gnssData;
+            break;
+
+        case ZenEventType_SensorDisconnected:
+            event.data.sensorDisconnected = compact.data.sensorDisconnected;
+            break;
+
+        case ZenEventType_SensorListingProgress:
+            event.data.sensorListingProgress = compact.data.sensorListingProgress;
+            break;
+
+        case ZenEventType_SensorFound:
+        case ZenEventType_SensorRemoved:
+            break;
+
+        default:
+            std::memcpy(&event.data, &compact.data, sizeof(CompactEventData));
+            break;
+        }
+    }
+}
+
+#endif
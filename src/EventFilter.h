@@ -0,0 +1,98 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_EVENTFILTER_H_
+#define ZEN_EVENTFILTER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "ZenTypes.h"
+
+namespace zen
+{
+    constexpr ZenEventFilter c_acceptAllEventsFilter{ {0}, ZenEventType_None, ZenEventType_Max };
+
+    inline bool acceptsEvent(const ZenEventFilter& filter, const ZenEvent& event) noexcept
+    {
+        if (event.eventType < filter.minEventType || event.eventType > filter.maxEventType)
+            return false;
+
+        return filter.component.handle == 0 || filter.component.handle == event.component.handle;
+    }
+
+    constexpr ZenEventDecimation c_keepAllSamplesDecimation{ 0, 0 };
+
+    /** Samples are measurement events, as opposed to control events like ZenEventType_SensorDisconnected */
+    inline bool isSampleEvent(ZenEventType eventType) noexcept
+    {
+        return eventType >= ZenEventType_ImuData;
+    }
+
+    /** Decides which samples of a sensor pass a decimation, separately for each component.
+        Not thread-safe, every subscription of a sensor owns one. */
+    class EventDecimator
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        bool accept(const ZenEvent& event, const ZenEventDecimation& decimation) noexcept
+        {
+            return accept(event, decimation, decimation.minIntervalUs != 0 ? Clock::now() : Clock::time_point());
+        }
+
+        bool accept(const ZenEvent& event, const ZenEventDecimation& decimation, Clock::time_point now) noexcept
+        {
+            if (!isSampleEvent(event.eventType) || (decimation.keepEveryNth <= 1 && decimation.minIntervalUs == 0))
+                return true;
+
+            auto& state = stateOf(event.component);
+            const uint64_t index = state.nSamples++;
+            if (decimation.keepEveryNth > 1 && index % decimation.keepEveryNth != 0)
+                return false;
+
+            if (decimation.minIntervalUs != 0)
+            {
+                if (state.hasKept && now - state.lastKept < std::chrono::microseconds(decimation.minIntervalUs))
+                    return false;
+
+                state.lastKept = now;
+                state.hasKept = true;
+            }
+
+            return true;
+        }
+
+    private:
+        struct ComponentState
+        {
+            uintptr_t component;
+            uint64_t nSamples;
+            Clock::time_point lastKept;
+            bool hasKept;
+        };
+
+        ComponentState& stateOf(ZenComponentHandle_t component)
+        {
+            // Sensors have very few components, so a linear search beats hashing
+            for (auto& state : m_states)
+                if (state.component == component.handle)
+                    return state;
+
+            m_states.push_back(ComponentState{ component.handle, 0, Clock::time_point(), false });
+            return m_states.back();
+        }
+
+        std::vector<ComponentState> m_states;
+    };
+}
+
+#endif
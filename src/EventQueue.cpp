@@ -0,0 +1,271 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "EventQueue.h"
+
+#include <thread>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+namespace zen
+{
+    namespace
+    {
+        QueueOverflowPolicy toQueueOverflowPolicy(ZenEventQueueOverflowPolicy policy) noexcept
+        {
+            switch (policy)
+            {
+            case ZenEventQueueOverflowPolicy_DropOldest:
+                return QueueOverflowPolicy::DropOldest;
+
+            case ZenEventQueueOverflowPolicy_Block:
+                return QueueOverflowPolicy::Block;
+
+            default:
+                return QueueOverflowPolicy::DropNewest;
+            }
+        }
+    }
+
+    EventQueue::EventQueue() noexcept
+        : m_type(ZenEventQueueType_Locking)
+        , m_capacity(0)
+        , m_policy(ZenEventQueueOverflowPolicy_DropNewest)
+        , m_nInterrupts(0)
+        , m_decimation(0)
+        , m_notificationFd(-1)
+        , m_notificationPending(false)
+    {}
+
+    EventQueue::~EventQueue()
+    {
+#ifdef __linux__
+        if (m_notificationFd >= 0)
+            ::close(m_notificationFd);
+#endif
+    }
+
+    ZenError EventQueue::setType(ZenEventQueueType type, size_t capacity) noexcept
+    {
+        if (type < 0 || type >= ZenEventQueueType_Max)
+            return ZenError_InvalidArgument;
+
+        clear();
+
+        if (type == ZenEventQueueType_LockFree)
+        {
+            m_ringBuffer = std::make_unique<RingBufferQueue<SharedEvent>>(capacity == 0 ? c_defaultEventQueueCapacity : capacity);
+            m_capacity = m_ringBuffer->capacity();
+        }
+        else
+        {
+            m_ringBuffer.reset();
+            m_capacity = capacity;
+        }
+
+        m_lockingQueue.setCapacity(m_ringBuffer ? 0 : m_capacity);
+        m_type = type;
+        return ZenError_None;
+    }
+
+    ZenError EventQueue::setOverflowPolicy(ZenEventQueueOverflowPolicy policy) noexcept
+    {
+        if (policy < 0 || policy >= ZenEventQueueOverflowPolicy_Max)
+            return ZenError_InvalidArgument;
+
+        m_policy = policy;
+        m_lockingQueue.setOverflowPolicy(toQueueOverflowPolicy(policy));
+        return ZenError_None;
+    }
+
+    void EventQueue::setDecimation(const ZenEventDecimation& decimation) noexcept
+    {
+        m_decimation = (uint64_t(decimation.keepEveryNth) << 32) | decimation.minIntervalUs;
+    }
+
+    ZenEventDecimation EventQueue::decimation() const noexcept
+    {
+        const uint64_t decimation = m_decimation.load(std::memory_order_relaxed);
+        return ZenEventDecimation{ uint32_t(decimation >> 32), uint32_t(decimation) };
+    }
+
+    void EventQueue::interruptBlockingPush() noexcept
+    {
+        ++m_nInterrupts;
+        m_lockingQueue.interruptBlockingPush();
+    }
+
+    void EventQueue::resumeBlockingPush() noexcept
+    {
+        m_lockingQueue.resumeBlockingPush();
+        --m_nInterrupts;
+    }
+
+    bool EventQueue::push(const ZenEvent& event) noexcept
+    {
+        return push(SharedEvent::make(event));
+    }
+
+    bool EventQueue::push(const CompactEvent& event) noexcept
+    {
+        return push(SharedEvent::make(event));
+    }
+
+    bool EventQueue::push(const SharedEvent& event) noexcept
+    {
+        const bool pushed = pushToContainer(event);
+        signalNotification();
+        return pushed;
+    }
+
+    bool EventQueue::pushToContainer(const SharedEvent& event) noexcept
+    {
+        if (m_ringBuffer)
+            return pushToRingBuffer(event);
+
+        if (m_type == ZenEventQueueType_Conflating && isSampleEvent(event->eventType))
+        {
+            // Overwrite the unread sample of the same sensor component in place
+            return m_lockingQueue.pushOrReplace(event, [&event](const SharedEvent& queued) {
+                return queued->eventType == event->eventType
+                    && queued->sensor.handle == event->sensor.handle
+                    && queued->component.handle == event->component.handle;
+            });
+        }
+
+        return m_lockingQueue.push(event);
+    }
+
+    bool EventQueue::pushToRingBuffer(const SharedEvent& event) noexcept
+    {
+        if (m_ringBuffer->push(event))
+            return true;
+
+        switch (m_policy.load())
+        {
+        case ZenEventQueueOverflowPolicy_DropOldest:
+            // The ring buffer supports multiple consumers, so the producer can discard the oldest event itself
+            do
+            {
+                m_ringBuffer->tryToPop();
+            } while (!m_ringBuffer->push(event));
+            return false;
+
+        case ZenEventQueueOverflowPolicy_Block:
+            // Producers of the ring buffer never wait on the consumer, so poll until it made room
+            while (!m_ringBuffer->push(event))
+            {
+                if (m_nInterrupts.load() != 0 || m_policy.load() != ZenEventQueueOverflowPolicy_Block)
+                    return false;
+
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    std::optional<SharedEvent> EventQueue::tryToPop() noexcept
+    {
+        auto event = m_ringBuffer ? m_ringBuffer->tryToPop() : m_lockingQueue.tryToPop();
+        if (!event)
+            rearmNotification();
+
+        return event;
+    }
+
+    std::optional<SharedEvent> EventQueue::waitToPop() noexcept
+    {
+        auto event = m_ringBuffer ? m_ringBuffer->waitToPop() : m_lockingQueue.waitToPop();
+        if (!event)
+            rearmNotification();
+
+        return event;
+    }
+
+    void EventQueue::clear() noexcept
+    {
+        if (m_ringBuffer)
+            m_ringBuffer->clear();
+        else
+            m_lockingQueue.clear();
+
+        rearmNotification();
+    }
+
+    bool EventQueue::empty() const noexcept
+    {
+        if (m_ringBuffer)
+            return m_ringBuffer->empty();
+
+        return m_lockingQueue.empty();
+    }
+
+    nonstd::expected<int, ZenError> EventQueue::notificationFd() noexcept
+    {
+#ifdef __linux__
+        std::lock_guard<std::mutex> lock(m_notificationMutex);
+        if (m_notificationFd < 0)
+        {
+            const int fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (fd == -1)
+                return nonstd::make_unexpected(ZenError_Unknown);
+
+            m_notificationFd = fd;
+
+            // Events which were queued before the eventfd existed need a wakeup as well
+            if (!empty())
+                signalNotification();
+        }
+        return m_notificationFd.load();
+#else
+        return nonstd::make_unexpected(ZenError_NotSupported);
+#endif
+    }
+
+    void EventQueue::signalNotification() noexcept
+    {
+#ifdef __linux__
+        const int fd = m_notificationFd.load(std::memory_order_acquire);
+        if (fd < 0)
+            return;
+
+        // Only the first push after the consumer drained the queue writes to the eventfd
+        if (!m_notificationPending.exchange(true))
+        {
+            const uint64_t increment = 1;
+            [[maybe_unused]] const auto result = ::write(fd, &increment, sizeof(increment));
+        }
+#endif
+    }
+
+    void EventQueue::rearmNotification() noexcept
+    {
+#ifdef __linux__
+        const int fd = m_notificationFd.load(std::memory_order_acquire);
+        if (fd < 0 || !m_notificationPending.load())
+            return;
+
+        uint64_t counter;
+        [[maybe_unused]] const auto result = ::read(fd, &counter, sizeof(counter));
+        m_notificationPending.store(false);
+
+        // A push which saw the pending flag before it was cleared did not write, so check again
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!empty())
+            signalNotification();
+#endif
+    }
+}
@@ -0,0 +1,165 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_EVENTQUEUE_H_
+#define ZEN_EVENTQUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include <nonstd/expected.hpp>
+
+#include "EventFilter.h"
+#include "SharedEvent.h"
+#include "ZenTypes.h"
+#include "utility/LockingQueue.h"
+#include "utility/RingBufferQueue.h"
+
+namespace zen
+{
+    /** Capacity of the lock-free ring buffer if none is specified */
+    constexpr size_t c_defaultEventQueueCapacity = 4096;
+
+    /**
+    Queue which carries events from sensors to their subscribers, i.e. SensorClient and
+    DataProcessor instances. By default it is backed by an unbounded LockingQueue, but it
+    can be bounded or switched to a lock-free RingBufferQueue. The overflow policy decides
+    what happens when a sensor publishes into a full queue. A conflating queue only keeps the
+    newest unread sample of each sensor component. The decimation of the queue is applied by
+    the sensors before they publish.
+
+    Events are queued as SharedEvent handles to compact events, so an event published to
+    several queues is stored once. Consumers convert it to a ZenEvent when they hand it out.
+
+    On Linux, the queue can signal an eventfd whenever it becomes non-empty, so consumers can
+    wait for events in their own reactor instead of blocking in waitToPop.
+    */
+    class EventQueue
+    {
+    public:
+        EventQueue() noexcept;
+        ~EventQueue();
+
+        /** Selects the container backing this queue. Queued events are dropped and waiting
+         * consumers are released. Must not be called while any sensor is subscribed to the queue.
+         * \param capacity Maximum number of queued events. A capacity of zero means unbounded for
+         * ZenEventQueueType_Locking and c_defaultEventQueueCapacity for ZenEventQueueType_LockFree.
+         */
+        ZenError setType(ZenEventQueueType type, size_t capacity = 0) noexcept;
+
+        ZenEventQueueType type() const noexcept { return m_type; }
+
+        /** Maximum number of queued events, zero if unbounded */
+        size_t capacity() const noexcept { return m_capacity; }
+
+        /** Selects what happens when an event is pushed to the full queue. Can be changed at any time */
+        ZenError setOverflowPolicy(ZenEventQueueOverflowPolicy policy) noexcept;
+
+        ZenEventQueueOverflowPolicy overflowPolicy() const noexcept { return m_policy; }
+
+        /** Reduces the rate of samples which sensors publish to this queue. Can be changed at any time */
+        void setDecimation(const ZenEventDecimation& decimation) noexcept;
+
+        ZenEventDecimation decimation() const noexcept;
+
+        /** While interrupted, pushes with ZenEventQueueOverflowPolicy_Block drop the event instead of
+         * waiting for room. Used to make sure a blocked sensor can be unsubscribed from the queue.
+         */
+        void interruptBlockingPush() noexcept;
+
+        void resumeBlockingPush() noexcept;
+
+        /** Returns an eventfd which is readable while events are queued, creating it on first use.
+         * A burst of pushes writes to it once, it is reset as soon as a pop finds the queue empty.
+         * The queue owns the descriptor. Fails with ZenError_NotSupported on platforms without eventfd.
+         */
+        nonstd::expected<int, ZenError> notificationFd() noexcept;
+
+        /** Returns false if an event was dropped, either the pushed one or the oldest queued one */
+        bool push(const ZenEvent& event) noexcept;
+
+        bool push(const CompactEvent& event) noexcept;
+
+        /** Queues a handle to an event which may also be queued by other subscribers */
+        bool push(const SharedEvent& event) noexcept;
+
+        std::optional<SharedEvent> tryToPop() noexcept;
+
+        std::optional<SharedEvent> waitToPop() noexcept;
+
+        template <class Rep, class Period>
+        std::optional<SharedEvent> waitToPopFor(std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            auto event = m_ringBuffer ? m_ringBuffer->waitToPopFor(waitTime) : m_lockingQueue.waitToPopFor(waitTime);
+            if (!event)
+                rearmNotification();
+
+            return event;
+        }
+
+        /** Moves up to maxCount queued events to out and returns how many were moved */
+        template <class OutputIt>
+        size_t tryToPopMany(OutputIt out, size_t maxCount) noexcept
+        {
+            const size_t count = m_ringBuffer ? m_ringBuffer->tryToPopMany(out, maxCount) : m_lockingQueue.tryToPopMany(out, maxCount);
+            if (count < maxCount)
+                rearmNotification();
+
+            return count;
+        }
+
+        /** Waits until at least one event is queued, then moves up to maxCount events to out */
+        template <class OutputIt, class Rep, class Period>
+        size_t waitToPopManyFor(OutputIt out, size_t maxCount, std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            const size_t count = m_ringBuffer ? m_ringBuffer->waitToPopManyFor(out, maxCount, waitTime)
+                : m_lockingQueue.waitToPopManyFor(out, maxCount, waitTime);
+            if (count < maxCount)
+                rearmNotification();
+
+            return count;
+        }
+
+        void clear() noexcept;
+
+        bool empty() const noexcept;
+
+    private:
+        bool pushToContainer(const SharedEvent& event) noexcept;
+
+        bool pushToRingBuffer(const SharedEvent& event) noexcept;
+
+        /** Writes to the eventfd, unless a previous write was not reset yet */
+        void signalNotification() noexcept;
+
+        /** Resets the eventfd after a pop found the queue empty */
+        void rearmNotification() noexcept;
+
+        ZenEventQueueType m_type;
+        size_t m_capacity;
+        std::atomic<ZenEventQueueOverflowPolicy> m_policy;
+        std::atomic_uint m_nInterrupts;
+        // Both fields of ZenEventDecimation, packed to be read consistently by the sensors
+        std::atomic_uint64_t m_decimation;
+
+        LockingQueue<SharedEvent> m_lockingQueue;
+        std::unique_ptr<RingBufferQueue<SharedEvent>> m_ringBuffer;
+
+        std::mutex m_notificationMutex;
+        std::atomic_int m_notificationFd;
+        // Set by the push which wrote to the eventfd, cleared when the eventfd was reset
+        std::atomic_bool m_notificationPending;
+    };
+}
+
+#endif
@@ -20,6 +20,12 @@
 
 #include "SensorClient.h"
 #include "components/GnssComponent.h"
+#include "io/IoCapture.h"
+#include "utility/HostClock.h"
+
+#ifdef __linux__
+#include "io/interfaces/linux/EpollReactor.h"
+#endif
 
 namespace
 {
@@ -46,6 +52,43 @@ namespace
 
         return components[idx].get();
     }
+    template <typename T>
+    ZenError getLatestSample(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle,
+        ZenEventType eventType, T zen::CompactEventData::* member, T* const outData, uint64_t* const outSeq) noexcept
+    {
+        if (outData == nullptr || outSeq == nullptr)
+            return ZenError_IsNull;
+
+        if (auto client = getClient(clientHandle))
+        {
+            if (auto sensor = client->findSensor(sensorHandle))
+            {
+                zen::CompactEvent sample;
+                uint64_t seq;
+                if (!sensor->latestSample(componentHandle, sample, seq))
+                    return ZenError_InvalidComponentHandle;
+
+                *outSeq = seq;
+                if (seq == 0)
+                    return ZenError_None;
+
+                if (sample.eventType != eventType)
+                    return ZenError_WrongDataType;
+
+                *outData = sample.data.*member;
+                return ZenError_None;
+            }
+            else
+            {
+                return ZenError_InvalidSensorHandle;
+            }
+        }
+        else
+        {
+            return ZenError_InvalidClientHandle;
+        }
+    }
+
     size_t countComponentsOfType(const std::vector<std::unique_ptr<zen::SensorComponent>>& components, std::string_view type)
     {
         return std::accumulate(components.cbegin(), components.cend(), static_cast<size_t>(0), [=](size_t count, const auto& component) {
@@ -106,6 +149,92 @@ ZEN_API ZenError ZenSetLogLevel(ZenLogLevel logLevel) {
     return ZenError_None;
 }
 
+ZEN_API uint64_t ZenGetHostTimestampNs(void)
+{
+    return zen::hostTimestampNs();
+}
+
+ZEN_API ZenError ZenSetIoThreadCount(uint32_t count)
+{
+#ifdef __linux__
+    return zen::EpollReactor::setThreadCount(count);
+#else
+    (void)count;
+    return ZenError_NotSupported;
+#endif
+}
+
+ZEN_API ZenError ZenSetIoCaptureDirectory(const char* directory)
+{
+    zen::IoCapture::setDirectory(directory == nullptr ? std::string() : std::string(directory));
+    return ZenError_None;
+}
+
+ZEN_API ZenError ZenSetEventQueueType(ZenClientHandle_t handle, ZenEventQueueType type, size_t capacity)
+{
+    if (auto client = getClient(handle))
+        return client->setEventQueueType(type, capacity);
+    else
+        return ZenError_InvalidClientHandle;
+}
+
+ZEN_API ZenError ZenSetEventQueueOverflowPolicy(ZenClientHandle_t handle, ZenEventQueueOverflowPolicy policy)
+{
+    if (auto client = getClient(handle))
+        return client->setEventQueueOverflowPolicy(policy);
+    else
+        return ZenError_InvalidClientHandle;
+}
+
+ZEN_API ZenError ZenSetEventFilter(ZenClientHandle_t handle, const ZenEventFilter* const filter)
+{
+    if (auto client = getClient(handle))
+    {
+        client->setEventFilter(filter ? *filter : zen::c_acceptAllEventsFilter);
+        return ZenError_None;
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenSetEventDecimation(ZenClientHandle_t handle, const ZenEventDecimation* const decimation)
+{
+    if (auto client = getClient(handle))
+    {
+        client->setEventDecimation(decimation ? *decimation : zen::c_keepAllSamplesDecimation);
+        return ZenError_None;
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenClientGetEventFd(ZenClientHandle_t handle, int* const outFd)
+{
+    if (!outFd)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(handle))
+    {
+        if (auto fd = client->eventFd())
+        {
+            *outFd = *fd;
+            return ZenError_None;
+        }
+        else
+        {
+            return fd.error();
+        }
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
 ZEN_API ZenError ZenListSensorsAsync(ZenClientHandle_t handle)
 {
     if (auto client = getClient(handle))
@@ -266,6 +395,51 @@ ZEN_API bool ZenWaitForNextEventForMs(ZenClientHandle_t handle, long long waitTi
     }
 }
 
+ZEN_API ZenError ZenPollNextEvents(ZenClientHandle_t handle, ZenEvent* const outEvents, size_t maxEvents, size_t* const outCount)
+{
+    if (outCount == nullptr)
+        return ZenError_IsNull;
+
+    *outCount = 0;
+    if (outEvents == nullptr && maxEvents != 0)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(handle))
+    {
+        *outCount = client->pollNextEvents(gsl::make_span(outEvents, maxEvents));
+        return ZenError_None;
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenWaitForNextEventsForMs(ZenClientHandle_t handle, long long waitTimeMs, ZenEvent* const outEvents, size_t maxEvents, size_t* const outCount)
+{
+    if (outCount == nullptr)
+        return ZenError_IsNull;
+
+    *outCount = 0;
+    if (outEvents == nullptr && maxEvents != 0)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(handle))
+    {
+        // Prevent the thread from holding on to the client resource.
+        // The SensorClient destructor guarantees that waiting threads are released before the resource is destroyed
+        auto& clientRef = *client.get();
+        client.reset();
+
+        *outCount = clientRef.waitForNextEventsFor(gsl::make_span(outEvents, maxEvents), std::chrono::milliseconds(waitTimeMs));
+        return ZenError_None;
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
 ZEN_API ZenError ZenSensorComponents(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* const type, ZenComponentHandle_t** outComponentHandles, size_t* const outLength)
 {
     if (outLength == nullptr)
@@ -354,6 +528,83 @@ ZEN_API const char* ZenSensorName(ZenClientHandle_t clientHandle, ZenSensorHandl
     }
 }
 
+ZEN_API ZenError ZenSensorDroppedEventCount(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, uint64_t* const outCount)
+{
+    if (outCount == nullptr)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+        {
+            *outCount = sensor->droppedEvents();
+            return ZenError_None;
+        }
+        else
+        {
+            return ZenError_InvalidSensorHandle;
+        }
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenSensorIoStatistics(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenIoStatistics* const outStatistics)
+{
+    if (outStatistics == nullptr)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+        {
+            auto statistics = sensor->ioStatistics();
+            if (!statistics)
+                return statistics.error();
+
+            *outStatistics = *statistics;
+            return ZenError_None;
+        }
+        else
+        {
+            return ZenError_InvalidSensorHandle;
+        }
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenSensorFrameStatistics(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenFrameStatistics* const outStatistics)
+{
+    if (outStatistics == nullptr)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+        {
+            auto statistics = sensor->frameStatistics();
+            if (!statistics)
+                return statistics.error();
+
+            *outStatistics = *statistics;
+            return ZenError_None;
+        }
+        else
+        {
+            return ZenError_InvalidSensorHandle;
+        }
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
 ZEN_API bool ZenSensorEquals(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const ZenSensorDesc* const desc)
 {
     if (desc == nullptr)
@@ -402,6 +653,53 @@ ZEN_API ZenAsyncStatus ZenSensorUpdateIAPAsync(ZenClientHandle_t clientHandle, Z
     }
 }
 
+ZEN_API ZenError ZenSetSensorEventFilter(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const ZenEventFilter* const filter)
+{
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+        {
+            if (filter == nullptr)
+                return client->resetSensorEventFilter(*sensor);
+
+            return client->setSensorEventFilter(*sensor, *filter);
+        }
+        else
+        {
+            return ZenError_InvalidSensorHandle;
+        }
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenRegisterEventCallback(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenEventCallback callback, void* userData)
+{
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+        {
+            zen::Sensor::EventCallback eventCallback;
+            if (callback != nullptr)
+                eventCallback = [clientHandle, callback, userData](const ZenEvent& event) {
+                    callback(clientHandle, &event, userData);
+                };
+
+            return client->setEventCallback(*sensor, std::move(eventCallback));
+        }
+        else
+        {
+            return ZenError_InvalidSensorHandle;
+        }
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
 ZEN_API ZenError ZenPublishEvents(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* endpoint) {
     if (auto client = getClient(clientHandle))
     {
@@ -416,6 +714,42 @@ ZEN_API ZenError ZenPublishEvents(ZenClientHandle_t clientHandle, ZenSensorHandl
     }
 }
 
+ZEN_API ZenError ZenPublishEventsDecimated(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* endpoint,
+    const ZenEventDecimation* const decimation)
+{
+    if (decimation == nullptr)
+        return ZenError_IsNull;
+
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+            return client->publishEvents(sensor, endpoint, *decimation);
+        else
+            return ZenError_InvalidSensorHandle;
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
+ZEN_API ZenError ZenPublishEventsQueued(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, const char* endpoint,
+    const ZenEventDecimation* const decimation, size_t queueCapacity, ZenEventQueueOverflowPolicy overflowPolicy)
+{
+    if (auto client = getClient(clientHandle))
+    {
+        if (auto sensor = client->findSensor(sensorHandle))
+            return client->publishEvents(sensor, endpoint, decimation ? *decimation : zen::c_keepAllSamplesDecimation,
+                queueCapacity, overflowPolicy);
+        else
+            return ZenError_InvalidSensorHandle;
+    }
+    else
+    {
+        return ZenError_InvalidClientHandle;
+    }
+}
+
 ZEN_API ZenError ZenSensorExecuteProperty(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenProperty_t property)
 {
     if (auto client = getClient(clientHandle))
@@ -735,6 +1069,18 @@ ZEN_API const char* ZenSensorComponentType(ZenClientHandle_t clientHandle, ZenSe
     }
 }
 
+ZEN_API ZenError ZenSensorComponentGetLatestImuData(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle,
+    ZenImuData* const outData, uint64_t* const outSeq)
+{
+    return getLatestSample(clientHandle, sensorHandle, componentHandle, ZenEventType_ImuData, &zen::CompactEventData::imuData, outData, outSeq);
+}
+
+ZEN_API ZenError ZenSensorComponentGetLatestGnssData(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle,
+    ZenGnssData* const outData, uint64_t* const outSeq)
+{
+    return getLatestSample(clientHandle, sensorHandle, componentHandle, ZenEventType_GnssData, &zen::CompactEventData::gnssData, outData, outSeq);
+}
+
 ZEN_API ZenError ZenSensorComponentExecuteProperty(ZenClientHandle_t clientHandle, ZenSensorHandle_t sensorHandle, ZenComponentHandle_t componentHandle, ZenProperty_t property)
 {
     if (auto client = getClient(clientHandle))
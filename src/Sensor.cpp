@@ -32,6 +32,7 @@
 #include "properties/LegacyCoreProperties.h"
 #include "properties/Ig1CoreProperties.h"
 #include "utility/Finally.h"
+#include "utility/HostClock.h"
 
 namespace zen
 {
@@ -111,6 +112,7 @@ namespace zen
         : m_config(std::move(config))
         , m_token(token)
         , m_initialized(false)
+        , m_droppedEvents(0)
         , m_communicator(moveCommunicator(std::move(communicator), *this, m_config.version))
         , m_updatingFirmware(false)
         , m_updatedFirmware(false)
@@ -124,6 +126,7 @@ namespace zen
         uintptr_t token) : m_config(std::move(config))
         , m_token(token)
         , m_initialized(false)
+        , m_droppedEvents(0)
         , m_eventCommunicator(std::move(eventCommunicator))
         , m_updatingFirmware(false)
         , m_updatedFirmware(false)
@@ -158,10 +161,8 @@ namespace zen
         // After that we can guarantee to subscribers that the sensor has shut down
         ZenEventData eventData{};
         eventData.sensorDisconnected.error = ZenError_None;
-        ZenEvent disconnected{ ZenEventType_SensorDisconnected, {m_token}, {0}, eventData };
-
-        for (auto subscriber : m_subscribers)
-            subscriber.get().push(disconnected);
+        ZenEvent event{ ZenEventType_SensorDisconnected, {m_token}, {0}, eventData, 0, 0 };
+        publishEvent(event);
     }
 
     void Sensor::addProcessor(std::unique_ptr<DataProcessor> processor) noexcept {
@@ -302,6 +303,22 @@ namespace zen
         return ZenAsync_Updating;
     }
 
+    nonstd::expected<ZenIoStatistics, ZenError> Sensor::ioStatistics() const noexcept
+    {
+        if (m_communicator)
+            return m_communicator->ioStatistics();
+
+        return nonstd::make_unexpected(ZenError_NotSupported);
+    }
+
+    nonstd::expected<ZenFrameStatistics, ZenError> Sensor::frameStatistics() const noexcept
+    {
+        if (m_communicator)
+            return m_communicator->frameStatistics();
+
+        return nonstd::make_unexpected(ZenError_NotSupported);
+    }
+
     bool Sensor::equals(const ZenSensorDesc& desc) const
     {
         if (m_communicator) {
@@ -315,15 +332,22 @@ namespace zen
         }
     }
 
-    bool Sensor::subscribe(LockingQueue<ZenEvent>& queue) noexcept
+    bool Sensor::subscribe(EventQueue& queue, const ZenEventFilter& filter) noexcept
     {
         std::lock_guard<std::mutex> lock(m_subscribersMutex);
-        const auto inserted = m_subscribers.insert(queue);
+        const auto inserted = m_subscribers.emplace(queue, Subscription{ filter, EventCallback(), EventDecimator() });
         return inserted.second;
     }
 
-    void Sensor::unsubscribe(LockingQueue<ZenEvent>& queue) noexcept
+    void Sensor::unsubscribe(EventQueue& queue) noexcept
     {
+        // A full queue with the blocking overflow policy would otherwise keep the
+        // subscribers mutex locked until the consumer drains it
+        queue.interruptBlockingPush();
+        auto guard = finally([&queue]() {
+            queue.resumeBlockingPush();
+        });
+
         std::lock_guard<std::mutex> lock(m_subscribersMutex);
         m_subscribers.erase(queue);
 
@@ -331,7 +355,29 @@ namespace zen
             SensorManager::get().release({ m_token });
     }
 
-    ZenError Sensor::processReceivedData(uint8_t, uint16_t function, gsl::span<const std::byte> data) noexcept
+    bool Sensor::setEventCallback(EventQueue& queue, EventCallback callback) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_subscribersMutex);
+        auto it = m_subscribers.find(queue);
+        if (it == m_subscribers.end())
+            return false;
+
+        it->second.callback = std::move(callback);
+        return true;
+    }
+
+    bool Sensor::setEventFilter(EventQueue& queue, const ZenEventFilter& filter) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_subscribersMutex);
+        auto it = m_subscribers.find(queue);
+        if (it == m_subscribers.end())
+            return false;
+
+        it->second.filter = filter;
+        return true;
+    }
+
+    ZenError Sensor::processReceivedData(uint8_t, uint16_t function, gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept
     {
         if (m_config.version == 0)
         {
@@ -388,7 +434,10 @@ namespace zen
                     if (m_initialized)
                     {
                         if (auto eventData = m_components[0]->processEventData(ZenEventType_ImuData, data))
-                            publishEvent({ ZenEventType_ImuData, {m_token}, {1}, std::move(*eventData) });
+                        {
+                            ZenEvent event{ ZenEventType_ImuData, {m_token}, {1}, *eventData, receivedTimestampNs, 0 };
+                            publishEvent(event);
+                        }
                         else
                             return eventData.error();
                     }
@@ -455,7 +504,10 @@ namespace zen
                     if (m_initialized)
                     {
                         if (auto eventData = m_components[0]->processEventData(ZenEventType_ImuData, data))
-                            publishEvent({ ZenEventType_ImuData, {m_token}, {1}, std::move(*eventData) });
+                        {
+                            ZenEvent event{ ZenEventType_ImuData, {m_token}, {1}, *eventData, receivedTimestampNs, 0 };
+                            publishEvent(event);
+                        }
                         else
                             return eventData.error();
                     }
@@ -465,7 +517,10 @@ namespace zen
                     if (m_initialized)
                     {
                         if (auto eventData = m_components[1]->processEventData(ZenEventType_GnssData, data))
-                            publishEvent({ ZenEventType_GnssData, {m_token}, {2}, std::move(*eventData) });
+                        {
+                            ZenEvent event{ ZenEventType_GnssData, {m_token}, {2}, *eventData, receivedTimestampNs, 0 };
+                            publishEvent(event);
+                        }
                         else
                             return eventData.error();
                     }
@@ -485,11 +540,52 @@ namespace zen
         return ZenError_Sensor_VersionNotSupported;
     }
 
-    void Sensor::publishEvent(const ZenEvent& event) noexcept
+    bool Sensor::latestSample(ZenComponentHandle_t component, CompactEvent& outSample, uint64_t& outSeq) const noexcept
+    {
+        const size_t idx = component.handle - 1;
+        if (idx >= m_latestSamples.size())
+            return false;
+
+        outSeq = m_latestSamples[idx].load(outSample);
+        return true;
+    }
+
+    void Sensor::publishEvent(ZenEvent& event) noexcept
     {
+        event.queuedTimestampNs = hostTimestampNs();
+
+        if (event.eventType == ZenEventType_ImuData || event.eventType == ZenEventType_GnssData)
+        {
+            const size_t idx = event.component.handle - 1;
+            if (idx < m_latestSamples.size())
+                m_latestSamples[idx].update([&event](CompactEvent& sample) { toCompactEvent(event, sample); });
+        }
+
+        // The event is written to the pool once and all queued subscribers share it
+        SharedEvent shared;
+
         std::lock_guard<std::mutex> lock(m_subscribersMutex);
-        for (auto subscriber : m_subscribers)
-            subscriber.get().push(event);
+        for (auto& subscriber : m_subscribers)
+        {
+            auto& subscription = subscriber.second;
+            if (!acceptsEvent(subscription.filter, event))
+                continue;
+
+            if (!subscription.decimator.accept(event, subscriber.first.get().decimation()))
+                continue;
+
+            if (subscription.callback)
+            {
+                subscription.callback(event);
+                continue;
+            }
+
+            if (!shared)
+                shared = SharedEvent::make(event);
+
+            if (!subscriber.first.get().push(shared))
+                m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
     }
 
     void Sensor::upload(std::vector<std::byte> firmware)
@@ -529,6 +625,8 @@ namespace zen
     }
 
     ZenError Sensor::processReceivedEvent(ZenEvent evt) noexcept {
+        // the IO interface does not know the handle of the sensor
+        evt.sensor.handle = m_token;
         publishEvent(evt);
 
         return ZenError_None;
@@ -11,24 +11,28 @@
 #ifndef ZEN_SENSOR_H_
 #define ZEN_SENSOR_H_
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <set>
 #include <thread>
 #include <vector>
 
 #include "nonstd/expected.hpp"
 
+#include "EventFilter.h"
+#include "EventQueue.h"
 #include "InternalTypes.h"
 
 #include "SensorConfig.h"
 #include "SensorComponent.h"
 #include "communication/SyncedModbusCommunicator.h"
 #include "communication/EventCommunicator.h"
-#include "utility/LockingQueue.h"
 #include "utility/ReferenceCmp.h"
+#include "utility/SeqLock.h"
 #include "processors/DataProcessor.h"
 
 
@@ -83,14 +87,41 @@ namespace zen
         /** Returns whether the sensor is equal to the sensor description */
         bool equals(const ZenSensorDesc& desc) const;
 
+        /** Returns statistics of the reads from the sensor's IO interface */
+        nonstd::expected<ZenIoStatistics, ZenError> ioStatistics() const noexcept;
+
+        /** Returns the errors of the data stream received from the sensor */
+        nonstd::expected<ZenFrameStatistics, ZenError> frameStatistics() const noexcept;
+
         /** Returns the sensor's unique token */
         uintptr_t token() const noexcept { return m_token; }
 
-        /** Subscribe an event queue to the sensor */
-        bool subscribe(LockingQueue<ZenEvent>& queue) noexcept;
+        /** Subscribe an event queue to the sensor, only events accepted by the filter are pushed to it */
+        bool subscribe(EventQueue& queue, const ZenEventFilter& filter = c_acceptAllEventsFilter) noexcept;
 
         /** Unsubscribe an event queue from the sensor */
-        void unsubscribe(LockingQueue<ZenEvent>& queue) noexcept;
+        void unsubscribe(EventQueue& queue) noexcept;
+
+        using EventCallback = std::function<void(const ZenEvent&)>;
+
+        /** Delivers the events for a subscribed queue to the callback instead. The callback is invoked
+            on the IO thread while the subscribers are locked, so it must not block or call into the
+            sensor. An empty callback restores delivery to the queue. Returns false if the queue is not
+            subscribed. */
+        bool setEventCallback(EventQueue& queue, EventCallback callback) noexcept;
+
+        /** Replaces the filter of a subscribed queue. Returns false if the queue is not subscribed */
+        bool setEventFilter(EventQueue& queue, const ZenEventFilter& filter) noexcept;
+
+        /** Copies the latest IMU or GNSS sample of a component without blocking the IO thread.
+            Returns false if the component handle is out of range, otherwise outSeq is the number of
+            samples the component published so far, zero if there is none yet. */
+        bool latestSample(ZenComponentHandle_t component, CompactEvent& outSample, uint64_t& outSeq) const noexcept;
+
+        /** Returns how many events were dropped because a subscriber's event queue was full when this
+            sensor published to it. With ZenEventQueueOverflowPolicy_DropOldest, the dropped event can also
+            be an older event of another sensor which shares the queue */
+        uint64_t droppedEvents() const noexcept { return m_droppedEvents.load(std::memory_order_relaxed); }
 
         /** An data processor associated with this Sensor. It will be destroyed once the sensor
             is destroyed */
@@ -104,11 +135,13 @@ namespace zen
         std::string m_deviceName = "*";
 
     private:
-        ZenError processReceivedData(uint8_t address, uint16_t function, gsl::span<const std::byte> data) noexcept override;
+        ZenError processReceivedData(uint8_t address, uint16_t function, gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept override;
 
         ZenError processReceivedEvent(ZenEvent) noexcept override;
 
-        void publishEvent(const ZenEvent& event) noexcept;
+        /** Stamps the event with its queued time and delivers it to all subscribers. The event is
+            taken by reference, so it is only copied once more when it is converted into the pooled slot */
+        void publishEvent(ZenEvent& event) noexcept;
 
         void upload(std::vector<std::byte> firmware);
 
@@ -117,8 +150,20 @@ namespace zen
         // [LEGACY]
         std::atomic_bool m_initialized;
 
+        std::atomic_uint64_t m_droppedEvents;
+
+        // Latest IMU or GNSS sample per component, indexed by the component handle minus one
+        std::array<SeqLock<CompactEvent>, 4> m_latestSamples;
+
         std::mutex m_subscribersMutex;
-        std::set<std::reference_wrapper<LockingQueue<ZenEvent>>, ReferenceWrapperCmp<LockingQueue<ZenEvent>>> m_subscribers;
+        struct Subscription
+        {
+            ZenEventFilter filter;
+            EventCallback callback;
+            EventDecimator decimator;
+        };
+
+        std::map<std::reference_wrapper<EventQueue>, Subscription, ReferenceWrapperCmp<EventQueue>> m_subscribers;
 
         std::vector<std::unique_ptr<SensorComponent>> m_components;
         std::unique_ptr<ISensorProperties> m_properties;
@@ -11,6 +11,7 @@
 #include "SensorClient.h"
 
 #include "SensorManager.h"
+#include "utility/HostClock.h"
 
 #include <spdlog/spdlog.h>
 
@@ -28,10 +29,16 @@ namespace {
 namespace zen
 {
     SensorClient::SensorClient(uintptr_t) noexcept
+        : m_eventFilter(c_acceptAllEventsFilter)
+        , m_nextSensorFoundId(1)
+        , m_listedSensors(false)
     {}
 
     SensorClient::~SensorClient() noexcept
     {
+        if (m_listedSensors)
+            SensorManager::get().unsubscribeFromSensorDiscovery(*this);
+
         for (auto& pair : m_sensors)
             if (auto sensor = pair.second.lock())
                 sensor->unsubscribe(m_eventQueue);
@@ -39,12 +46,17 @@ namespace zen
 
     void SensorClient::listSensorsAsync() noexcept
     {
+        m_listedSensors = true;
         SensorManager::get().subscribeToSensorDiscovery(*this);
     }
 
 #ifdef ZEN_NETWORK
-    ZenError SensorClient::publishEvents(std::shared_ptr<Sensor> sensor, const std::string & endpoint) {
-        auto processor = std::make_unique<ZmqDataProcessor>();
+    ZenError SensorClient::publishEvents(std::shared_ptr<Sensor> sensor, const std::string & endpoint,
+        const ZenEventDecimation& decimation, size_t queueCapacity, ZenEventQueueOverflowPolicy overflowPolicy) {
+        auto processor = std::make_unique<ZmqDataProcessor>(queueCapacity == 0 ? c_zmqDataProcessorQueueCapacity : queueCapacity);
+        if (auto error = processor->getEventQueue().setOverflowPolicy(overflowPolicy))
+            return error;
+        processor->getEventQueue().setDecimation(decimation);
 
         if (!processor->connect(endpoint)) {
             return ZenError_InvalidArgument;
@@ -54,12 +66,63 @@ namespace zen
         return ZenError_None;
     }
 #else
-    ZenError SensorClient::publishEvents(std::shared_ptr<Sensor>, const std::string&) {
+    ZenError SensorClient::publishEvents(std::shared_ptr<Sensor>, const std::string&, const ZenEventDecimation&,
+        size_t, ZenEventQueueOverflowPolicy) {
         spdlog::error("ZeroMQ support not available in OpenZen build, cannot publish events");
         return ZenError_NotSupported;
     }
 #endif
 
+    ZenError SensorClient::setEventQueueType(ZenEventQueueType type, size_t capacity) noexcept
+    {
+        // sensors and the sensor discovery publish to the queue from their threads, while it is replaced
+        if (!m_sensors.empty() || m_listedSensors)
+            return ZenError_AlreadyInitialized;
+
+        return m_eventQueue.setType(type, capacity);
+    }
+
+    ZenError SensorClient::setEventQueueOverflowPolicy(ZenEventQueueOverflowPolicy policy) noexcept
+    {
+        return m_eventQueue.setOverflowPolicy(policy);
+    }
+
+    void SensorClient::setEventDecimation(const ZenEventDecimation& decimation) noexcept
+    {
+        m_eventQueue.setDecimation(decimation);
+    }
+
+    void SensorClient::setEventFilter(const ZenEventFilter& filter) noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_eventFilterMutex);
+            m_eventFilter = filter;
+        }
+
+        for (auto& pair : m_sensors)
+            if (auto sensor = pair.second.lock())
+                sensor->setEventFilter(m_eventQueue, filter);
+    }
+
+    ZenError SensorClient::setSensorEventFilter(Sensor& sensor, const ZenEventFilter& filter) noexcept
+    {
+        if (!sensor.setEventFilter(m_eventQueue, filter))
+            return ZenError_InvalidSensorHandle;
+
+        return ZenError_None;
+    }
+
+    ZenError SensorClient::resetSensorEventFilter(Sensor& sensor) noexcept
+    {
+        return setSensorEventFilter(sensor, eventFilter());
+    }
+
+    ZenEventFilter SensorClient::eventFilter() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_eventFilterMutex);
+        return m_eventFilter;
+    }
+
     std::shared_ptr<Sensor> SensorClient::findSensor(ZenSensorHandle_t handle) noexcept
     {
         auto it = m_sensors.find(handle.handle);
@@ -79,7 +142,7 @@ namespace zen
         auto& manager = SensorManager::get();
         if (auto sensor = manager.obtain(desc))
         {
-            if (sensor.value()->subscribe(m_eventQueue))
+            if (sensor.value()->subscribe(m_eventQueue, eventFilter()))
                 m_sensors.emplace(sensor.value()->token(), *sensor);
 
             return std::move(*sensor);
@@ -93,11 +156,20 @@ namespace zen
     nonstd::expected<std::shared_ptr<Sensor>, ZenSensorInitError> SensorClient::obtain(const std::string& ioType,
         const std::string& identifier, uint32_t baudRate) noexcept {
 
-        ZenSensorDesc desc;
+        ZenSensorDesc desc{};
+        if (ioType.size() >= sizeof(desc.ioType)) {
+            spdlog::error("IO type {} is too long", ioType);
+            return nonstd::make_unexpected(ZenSensorInitError_UnsupportedIoType);
+        }
+        if (identifier.size() >= sizeof(desc.identifier)) {
+            spdlog::error("Sensor identifier {} is longer than {} characters", identifier, sizeof(desc.identifier) - 1);
+            return nonstd::make_unexpected(ZenSensorInitError_UnknownIdentifier);
+        }
+
         desc.serialNumber[0] = 0;
         desc.baudRate = baudRate;
-        safeStringToChar(ioType, desc.ioType, size_t(64));
-        safeStringToChar(identifier, desc.identifier, size_t(64));
+        safeStringToChar(ioType, desc.ioType, sizeof(desc.ioType));
+        safeStringToChar(identifier, desc.identifier, sizeof(desc.identifier));
 
         return obtain(desc);
     }
@@ -110,18 +182,73 @@ namespace zen
         return ZenError_None;
     }
 
+    ZenError SensorClient::setEventCallback(Sensor& sensor, Sensor::EventCallback callback) noexcept
+    {
+        if (!sensor.setEventCallback(m_eventQueue, std::move(callback)))
+            return ZenError_InvalidSensorHandle;
+
+        return ZenError_None;
+    }
+
     std::optional<ZenEvent> SensorClient::pollNextEvent() noexcept
     {
-        return m_eventQueue.tryToPop();
+        return toZenEvent(m_eventQueue.tryToPop());
+    }
+
+    size_t SensorClient::pollNextEvents(gsl::span<ZenEvent> events) noexcept
+    {
+        return m_eventQueue.tryToPopMany(ConversionIterator(*this, events.data()), static_cast<size_t>(events.size()));
     }
 
     std::optional<ZenEvent> SensorClient::waitForNextEvent() noexcept
     {
-        return m_eventQueue.waitToPop();
+        return toZenEvent(m_eventQueue.waitToPop());
     }
 
     void SensorClient::notifyEvent(const ZenEvent& event) noexcept
     {
-        m_eventQueue.push(event);
+        if (!acceptsEvent(eventFilter(), event))
+            return;
+
+        if (event.eventType != ZenEventType_SensorFound && event.eventType != ZenEventType_SensorRemoved)
+        {
+            // Discovery events are rare, so stamping a copy is fine
+            ZenEvent stamped = event;
+            stamped.queuedTimestampNs = hostTimestampNs();
+            m_eventQueue.push(stamped);
+            return;
+        }
+
+        CompactEvent marker;
+        marker.eventType = event.eventType;
+        marker.sensor = event.sensor;
+        marker.component = event.component;
+        marker.receivedTimestampNs = event.receivedTimestampNs;
+        marker.queuedTimestampNs = hostTimestampNs();
+        marker.data.sensorFoundId = m_nextSensorFoundId++;
+
+        m_sensorFoundDescs.push(std::make_pair(marker.data.sensorFoundId, event.data.sensorFound));
+        m_eventQueue.push(marker);
+    }
+
+    void SensorClient::convertEvent(const SharedEvent& event, ZenEvent& out) noexcept
+    {
+        zen::toZenEvent(*event, out);
+
+        if (event->eventType == ZenEventType_SensorFound || event->eventType == ZenEventType_SensorRemoved)
+        {
+            // Found and removed sensors share the description type
+            out.data.sensorFound = ZenEventData_SensorFound{};
+
+            // Descriptions whose marker was dropped by a full queue are skipped
+            while (auto desc = m_sensorFoundDescs.tryToPop())
+            {
+                if (desc->first == event->data.sensorFoundId)
+                {
+                    out.data.sensorFound = desc->second;
+                    break;
+                }
+            }
+        }
     }
 }
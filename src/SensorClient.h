@@ -11,14 +11,17 @@
 #ifndef ZEN_SENSORCLIENT_H_
 #define ZEN_SENSORCLIENT_H_
 
+#include <atomic>
+#include <iterator>
 #include <mutex>
 #include <optional>
 #include <unordered_map>
+#include <utility>
 
 #include <nonstd/expected.hpp>
 
 #include "Sensor.h"
-#include "utility/LockingQueue.h"
+#include "EventQueue.h"
 
 namespace zen
 {
@@ -31,11 +34,35 @@ namespace zen
         /** Opts in to an asynchronous process that lists available sensors.
          * ZenEventData_SensorListingProgress events will be queued to indicate progress.
          * ZenEventData_SensorFound events will be queued to signal sensor descriptions.
+         * Afterwards, sensors which are plugged in or out are reported with
+         * ZenEventData_SensorFound and ZenEventData_SensorRemoved events.
          */
         void listSensorsAsync() noexcept;
 
         std::shared_ptr<Sensor> findSensor(ZenSensorHandle_t handle) noexcept;
 
+        /** Selects the container of the event queue. Fails with ZenError_AlreadyInitialized while sensors are obtained,
+            and once sensors were listed, as the discovery keeps publishing to the queue until the client is destroyed */
+        ZenError setEventQueueType(ZenEventQueueType type, size_t capacity) noexcept;
+
+        /** Selects what happens when a sensor publishes to the full event queue */
+        ZenError setEventQueueOverflowPolicy(ZenEventQueueOverflowPolicy policy) noexcept;
+
+        /** Reduces the rate of samples which sensors queue for this client */
+        void setEventDecimation(const ZenEventDecimation& decimation) noexcept;
+
+        /** Returns an eventfd which is readable while events are queued for this client, see ZenClientGetEventFd */
+        nonstd::expected<int, ZenError> eventFd() noexcept { return m_eventQueue.notificationFd(); }
+
+        /** Filters the events of all sensors of this client, including sensors obtained later, and of the sensor listing */
+        void setEventFilter(const ZenEventFilter& filter) noexcept;
+
+        /** Filters the events of one sensor of this client */
+        ZenError setSensorEventFilter(Sensor& sensor, const ZenEventFilter& filter) noexcept;
+
+        /** Restores the client's filter for one sensor */
+        ZenError resetSensorEventFilter(Sensor& sensor) noexcept;
+
         nonstd::expected<std::shared_ptr<Sensor>, ZenSensorInitError> obtain(const ZenSensorDesc& desc) noexcept;
 
         nonstd::expected<std::shared_ptr<Sensor>, ZenSensorInitError> obtain(const std::string& ioType,
@@ -52,19 +79,89 @@ namespace zen
         /** Returns the next event on the queue when there is a new one, otherwise returns std::nullopt on timeout or upon a call to ZenShutdown() */
         template<class Rep, class Period>
         std::optional<ZenEvent> waitForNextEventFor(std::chrono::duration<Rep, Period> waitTime) noexcept {
-            return m_eventQueue.waitToPopFor(waitTime);
+            return toZenEvent(m_eventQueue.waitToPopFor(waitTime));
+        }
+
+        /** Moves up to events.size() queued events to events and returns how many were moved */
+        size_t pollNextEvents(gsl::span<ZenEvent> events) noexcept;
+
+        /** Waits until at least one event is queued, then moves up to events.size() events to events.
+         * Returns zero on timeout or upon a call to ZenShutdown()
+         */
+        template<class Rep, class Period>
+        size_t waitForNextEventsFor(gsl::span<ZenEvent> events, std::chrono::duration<Rep, Period> waitTime) noexcept {
+            return m_eventQueue.waitToPopManyFor(ConversionIterator(*this, events.data()),
+                static_cast<size_t>(events.size()), waitTime);
         }
 
+        /** Delivers the events of the sensor to the callback instead of the event queue, see ZenRegisterEventCallback */
+        ZenError setEventCallback(Sensor& sensor, Sensor::EventCallback callback) noexcept;
+
         /** Open an OpenZen publisher socket and send all events there. This could be improved by
         having a dedicated subscriber only for the ZeroMQ submission.
         */
-        ZenError publishEvents(std::shared_ptr<Sensor> sensor, const std::string & endpoint);
+        ZenError publishEvents(std::shared_ptr<Sensor> sensor, const std::string & endpoint,
+            const ZenEventDecimation& decimation = c_keepAllSamplesDecimation, size_t queueCapacity = 0,
+            ZenEventQueueOverflowPolicy overflowPolicy = ZenEventQueueOverflowPolicy_DropOldest);
 
-        /** Pushes an event to the event queue */
+        /** Pushes an event to the event queue. The description of a ZenEventType_SensorFound
+         * or ZenEventType_SensorRemoved event is kept aside and only a compact marker is queued.
+         */
         void notifyEvent(const ZenEvent& event) noexcept;
 
     private:
-        LockingQueue<ZenEvent> m_eventQueue;
+        /** Output iterator which converts popped events to the ZenEvent array of the caller */
+        class ConversionIterator
+        {
+        public:
+            using iterator_category = std::output_iterator_tag;
+            using value_type = void;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = void;
+
+            ConversionIterator(SensorClient& client, ZenEvent* out) noexcept : m_client(&client), m_out(out) {}
+
+            ConversionIterator& operator*() noexcept { return *this; }
+            ConversionIterator& operator++() noexcept { ++m_out; return *this; }
+            ConversionIterator operator++(int) noexcept { return ConversionIterator(*m_client, m_out++); }
+
+            ConversionIterator& operator=(const SharedEvent& event) noexcept
+            {
+                m_client->convertEvent(event, *m_out);
+                return *this;
+            }
+
+        private:
+            SensorClient* m_client;
+            ZenEvent* m_out;
+        };
+
+        /** Converts a popped event, which is where a SensorFound marker gets its description back */
+        void convertEvent(const SharedEvent& event, ZenEvent& out) noexcept;
+
+        std::optional<ZenEvent> toZenEvent(const std::optional<SharedEvent>& event) noexcept {
+            if (!event)
+                return std::nullopt;
+
+            ZenEvent result;
+            convertEvent(*event, result);
+            return result;
+        }
+
+        ZenEventFilter eventFilter() noexcept;
+
+        EventQueue m_eventQueue;
+
+        std::mutex m_eventFilterMutex;
+        ZenEventFilter m_eventFilter;
+
+        // Descriptions of found sensors, matched to the queued markers by their id
+        LockingQueue<std::pair<uint64_t, ZenEventData_SensorFound>> m_sensorFoundDescs;
+        std::atomic_uint64_t m_nextSensorFoundId;
+
+        // Whether the client is subscribed to the sensor discovery of the SensorManager
+        std::atomic_bool m_listedSensors;
 
         std::unordered_map<uintptr_t, std::weak_ptr<Sensor>> m_sensors;
     };
@@ -14,6 +14,7 @@
 #include "communication/ConnectionNegotiator.h"
 #include "communication/EventCommunicator.h"
 #include "components/ComponentFactoryManager.h"
+#include "io/IoCapture.h"
 #include "io/IoManager.h"
 
 #ifdef ZEN_PCAN
@@ -28,18 +29,34 @@ namespace zen
 {
     namespace
     {
-        void notifyProgress(std::set<std::reference_wrapper<SensorClient>, ReferenceWrapperCmp<SensorClient>>& subscribers, float progress)
+        // A Bluetooth inquiry alone takes more than 10 seconds
+        constexpr std::chrono::milliseconds c_defaultListDevicesTimeout = std::chrono::seconds(30);
+
+        /** Notifies the progress after an IO system listed its sensors, or the completion without an IO system */
+        void notifyProgress(std::set<std::reference_wrapper<SensorClient>, ReferenceWrapperCmp<SensorClient>>& subscribers,
+            float progress, std::string_view ioType = {}, bool timedOut = false)
         {
             ZenEvent event{};
             event.eventType = ZenEventType_SensorListingProgress;
             event.data.sensorListingProgress.progress = progress;
-            event.data.sensorListingProgress.complete = progress == 1.0f;
+            event.data.sensorListingProgress.complete = ioType.empty();
+            event.data.sensorListingProgress.timedOut = timedOut;
+            ioType.copy(event.data.sensorListingProgress.ioType, sizeof(event.data.sensorListingProgress.ioType) - 1);
 
             for (auto& subscriber : subscribers)
                 subscriber.get().notifyEvent(event);
         }
     }
 
+    struct IoSystemListing
+    {
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        // Sensors of the IO systems which finished listing and were not notified yet
+        std::vector<std::pair<std::string_view, std::vector<ZenSensorDesc>>> finished;
+    };
+
     SensorManager& SensorManager::get()
     {
         static SensorManager singleton;
@@ -47,7 +64,8 @@ namespace zen
     }
 
     SensorManager::SensorManager() noexcept
-        : m_nextToken(1)
+        : m_listDevicesTimeoutMs(c_defaultListDevicesTimeout.count())
+        , m_nextToken(1)
         , m_discovering(false)
         , m_terminate(false)
         , m_sensorThread(&SensorManager::sensorLoop, this)
@@ -65,6 +83,9 @@ namespace zen
 
         ComponentFactoryManager::get().initialize();
         IoManager::get().initialize();
+
+        for (auto& ioSystem : IoManager::get().getIoSystems())
+            ioSystem.get().setListener(this);
     }
 
     SensorManager::~SensorManager() noexcept
@@ -72,9 +93,28 @@ namespace zen
         m_terminate = true;
         m_discoveryCv.notify_all();
 
+        std::shared_ptr<IoSystemListing> listing;
+        {
+            std::lock_guard<std::mutex> lock(m_discoveryMutex);
+            listing = m_listing;
+        }
+        if (listing)
+        {
+            std::lock_guard<std::mutex> lock(listing->mutex);
+            listing->cv.notify_all();
+        }
+
+        for (auto& ioSystem : IoManager::get().getIoSystems())
+            ioSystem.get().setListener(nullptr);
+
         if (m_sensorDiscoveryThread.joinable())
             m_sensorDiscoveryThread.join();
 
+        // A listing which is still running, e.g. a Bluetooth inquiry, must finish before the IO systems are destroyed
+        for (auto& [ioSystem, listingThread] : m_listingThreads)
+            if (listingThread.joinable())
+                listingThread.join();
+
         if (m_sensorThread.joinable())
             m_sensorThread.join();
     }
@@ -101,20 +141,24 @@ namespace zen
             auto communicator = std::make_unique<ModbusCommunicator>(negotiator,
                 std::make_unique<modbus::LpFrameFactory>(), std::make_unique<modbus::LpFrameParser>());
 
-            // load the default baud rate, if needed
-            if (desc.baudRate == 0) {
-                desc.baudRate = ioSystem->get().getDefaultBaudrate();
-            }
-            spdlog::info("Obtaining sensor {0} with baudrate {1}", desc.identifier, desc.baudRate);
+            // without a baud rate, the one the sensor is configured to is detected
+            const auto defaultBaudRate = ioSystem->get().getDefaultBaudrate();
+            if (desc.baudRate == 0)
+                spdlog::info("Obtaining sensor {0}, detecting its baudrate", desc.identifier);
+            else
+                spdlog::info("Obtaining sensor {0} with baudrate {1}", desc.identifier, desc.baudRate);
 
             if (auto ioInterface = ioSystem->get().obtain(desc, *communicator.get())) {
+                if (auto capture = IoCapture::create(desc))
+                    (*ioInterface)->startCapture(std::move(capture));
+
                 communicator->init(std::move(*ioInterface));
             } else {
                 spdlog::error("IO System returned error");
                 return nonstd::make_unexpected(ioInterface.error());
             }
 
-            auto agreement = negotiator.negotiate(*communicator.get(), desc.baudRate);
+            auto agreement = negotiator.negotiate(*communicator.get(), desc.baudRate, defaultBaudRate);
             if (!agreement) {
                 spdlog::error("Sensor connection cannot be negotiated");
                 return nonstd::make_unexpected(agreement.error());
@@ -181,56 +225,159 @@ namespace zen
     {
         std::lock_guard<std::mutex> lock(m_discoveryMutex);
         m_discoverySubscribers.insert(client);
+        m_hotplugSubscribers.insert(client);
         m_discovering = true;
         m_discoveryCv.notify_one();
     }
 
+    void SensorManager::unsubscribeFromSensorDiscovery(SensorClient& client) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_discoveryMutex);
+        m_discoverySubscribers.erase(client);
+        m_hotplugSubscribers.erase(client);
+    }
+
+    void SensorManager::deviceAdded(const ZenSensorDesc& desc) noexcept
+    {
+        notifyHotplug(ZenEventType_SensorFound, desc);
+    }
+
+    void SensorManager::deviceRemoved(const ZenSensorDesc& desc) noexcept
+    {
+        notifyHotplug(ZenEventType_SensorRemoved, desc);
+    }
+
+    void SensorManager::notifyHotplug(ZenEventType eventType, const ZenSensorDesc& desc) noexcept
+    {
+        ZenEvent event{};
+        event.eventType = eventType;
+        if (eventType == ZenEventType_SensorFound)
+            event.data.sensorFound = desc;
+        else
+            event.data.sensorRemoved = desc;
+
+        std::lock_guard<std::mutex> lock(m_discoveryMutex);
+        for (auto& subscriber : m_hotplugSubscribers)
+            subscriber.get().notifyEvent(event);
+    }
+
     void SensorManager::sensorDiscoveryLoop() noexcept
     {
         while (!m_terminate)
         {
             std::unique_lock<std::mutex> lock(m_discoveryMutex);
             m_discoveryCv.wait(lock, [this]() { return m_discovering || m_terminate; });
+            if (m_terminate)
+                return;
 
+            // Every IO system lists its sensors on its own thread, so a slow one, e.g. a Bluetooth
+            // inquiry, does not delay the others. Their sensors are notified as soon as they finish.
+            auto listing = std::make_shared<IoSystemListing>();
+            m_listing = listing;
             lock.unlock();
 
-            const auto ioSystems = IoManager::get().getIoSystems();
+            const auto ioSystems = IoManager::get().getIoSystemsByType();
             const auto nIoSystems = ioSystems.size();
-            for (size_t idx = 0; idx < nIoSystems; ++idx)
+            std::set<std::string_view> pending;
+            std::vector<std::string_view> stillListing;
+            for (const auto& [ioType, ioSystem] : ioSystems)
             {
-                if (m_terminate)
-                    return;
+                auto& listingIoSystem = m_listingIoSystems[&ioSystem.get()];
+                if (!listingIoSystem)
+                    listingIoSystem = std::make_shared<std::atomic_bool>(false);
+
+                // An IO system which did not finish a previous listing would be called concurrently
+                if (*listingIoSystem)
+                {
+                    stillListing.push_back(ioType);
+                    continue;
+                }
+
+                // the previous listing of the IO system has finished
+                auto& listingThread = m_listingThreads[&ioSystem.get()];
+                if (listingThread.joinable())
+                    listingThread.join();
+
+                *listingIoSystem = true;
+                pending.insert(ioType);
+                listingThread = std::thread([listing, listingIoSystem, ioType = ioType, &ioSystem = ioSystem.get()]() {
+                    std::vector<ZenSensorDesc> devices;
+                    try
+                    {
+                        ioSystem.listDevices(devices);
+                    }
+                    catch (...)
+                    {
+                        // [TODO] Make listDevices noexcept and move try-catch block into crashing ioSystem
+                        devices.clear();
+                    }
+                    *listingIoSystem = false;
+
+                    {
+                        std::lock_guard<std::mutex> lock(listing->mutex);
+                        listing->finished.emplace_back(ioType, std::move(devices));
+                    }
+                    listing->cv.notify_one();
+                });
+            }
+
+            size_t nFinished = 0;
+            for (const auto ioType : stillListing)
+            {
+                spdlog::warn("IO system {} is still listing sensors of a previous discovery and is skipped", ioType);
 
                 lock.lock();
-                notifyProgress(m_discoverySubscribers, (idx + 0.5f) / nIoSystems);
+                notifyProgress(m_discoverySubscribers, float(++nFinished) / nIoSystems, ioType, true);
                 lock.unlock();
+            }
 
-                try
-                {
-                    ioSystems[idx].get().listDevices(m_devices);
-                }
-                catch (...)
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_listDevicesTimeoutMs);
+            std::unique_lock<std::mutex> listingLock(listing->mutex);
+            while (!pending.empty())
+            {
+                if (!listing->cv.wait_until(listingLock, deadline, [&]() { return !listing->finished.empty() || m_terminate; }))
+                    break;
+                if (m_terminate)
+                    return;
+
+                const auto finished = std::move(listing->finished);
+                listing->finished.clear();
+                listingLock.unlock();
+
+                lock.lock();
+                for (const auto& [ioType, devices] : finished)
                 {
-                    // [TODO] Make listDevices noexcept and move try-catch block into crashing ioSystem
-                    continue;
+                    pending.erase(ioType);
+
+                    for (const auto& device : devices)
+                    {
+                        ZenEvent event{};
+                        event.eventType = ZenEventType_SensorFound;
+                        event.data.sensorFound = device;
+
+                        for (auto& subscriber : m_discoverySubscribers)
+                            subscriber.get().notifyEvent(event);
+                    }
+
+                    notifyProgress(m_discoverySubscribers, float(++nFinished) / nIoSystems, ioType);
                 }
-            }
+                lock.unlock();
 
+                listingLock.lock();
+            }
+            listingLock.unlock();
 
             lock.lock();
-            for (auto& device : m_devices)
+            // The sensors of IO systems which did not finish in time are dropped
+            for (const auto ioType : pending)
             {
-                ZenEvent event{};
-                event.eventType = ZenEventType_SensorFound;
-                event.data.sensorFound = device;
-
-                for (auto& subscriber : m_discoverySubscribers)
-                    subscriber.get().notifyEvent(event);
+                spdlog::warn("IO system {} did not list its sensors in time", ioType);
+                notifyProgress(m_discoverySubscribers, float(++nFinished) / nIoSystems, ioType, true);
             }
 
             notifyProgress(m_discoverySubscribers, 1.0f);
-            
-            m_devices.clear();
+
+            m_listing.reset();
             m_discovering = false;
             m_discoverySubscribers.clear();
         }
@@ -12,6 +12,7 @@
 #define ZEN_SENSORMANAGER_H_
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <map>
 #include <mutex>
@@ -27,6 +28,7 @@
 
 #include "Sensor.h"
 #include "SensorClient.h"
+#include "io/IIoSystem.h"
 #include "utility/ReferenceCmp.h"
 
 #include <memory>
@@ -35,12 +37,14 @@
 
 namespace zen
 {
+    struct IoSystemListing;
+
     /**
     Central class which marshalls access to the available IoSystems and their
     connected sensors. This class lives as a static singleton, which is contained
     in the get() method;
     */
-    class SensorManager
+    class SensorManager : private IIoSystemListener
     {
     public:
         /**
@@ -54,11 +58,17 @@ namespace zen
         /** Try to obtain a sensor based on a sensor description. */
         nonstd::expected<std::shared_ptr<Sensor>, ZenSensorInitError> obtain(const ZenSensorDesc& desc) noexcept;
 
-        /** Subscribe a client to sensor discovery */
+        /** Subscribe a client to sensor discovery, it also receives the sensors which are plugged in or out later */
         void subscribeToSensorDiscovery(SensorClient& client) noexcept;
 
+        /** Unsubscribe a client from sensor discovery, which must be done before it is destroyed */
+        void unsubscribeFromSensorDiscovery(SensorClient& client) noexcept;
+
         void registerDataProcessor(std::unique_ptr<DataProcessor> processor) noexcept;
 
+        /** Sets how long sensor discovery waits for an IO system to list its sensors */
+        void setListDevicesTimeout(std::chrono::milliseconds timeout) noexcept { m_listDevicesTimeoutMs = timeout.count(); }
+
     private:
 
         SensorManager() noexcept;
@@ -70,14 +80,27 @@ namespace zen
         void sensorDiscoveryLoop() noexcept;
         void sensorLoop();
 
+        void deviceAdded(const ZenSensorDesc& desc) noexcept override;
+        void deviceRemoved(const ZenSensorDesc& desc) noexcept override;
+        void notifyHotplug(ZenEventType eventType, const ZenSensorDesc& desc) noexcept;
+
         std::set<std::shared_ptr<Sensor>, SensorCmp> m_sensors;
         std::set<std::reference_wrapper<SensorClient>, ReferenceWrapperCmp<SensorClient>> m_discoverySubscribers;
+        // Clients which listed sensors before, they are notified of hotplugged sensors
+        std::set<std::reference_wrapper<SensorClient>, ReferenceWrapperCmp<SensorClient>> m_hotplugSubscribers;
 
         /**
         This mutex needs to be held to access or modify the m_processors vector
          */
         std::mutex m_processorsMutex;
-        std::vector<ZenSensorDesc> m_devices;
+
+        // Listing of the running discovery, which is shared with the threads of the IO systems
+        std::shared_ptr<IoSystemListing> m_listing;
+        // Whether an IO system is listing, which outlives a discovery when the IO system does not finish in time
+        std::map<IIoSystem*, std::shared_ptr<std::atomic_bool>> m_listingIoSystems;
+        // The last listing thread of each IO system, only used by the discovery thread until it is joined
+        std::map<IIoSystem*, std::thread> m_listingThreads;
+        std::atomic<int64_t> m_listDevicesTimeoutMs;
 
         std::condition_variable m_discoveryCv;
 
@@ -0,0 +1,76 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "SharedEvent.h"
+
+#include "utility/RingBufferQueue.h"
+
+namespace zen
+{
+    namespace
+    {
+        class EventPool
+        {
+        public:
+            static EventPool& get()
+            {
+                // Never destroyed, because queues owned by other static objects can still
+                // release their slots during static destruction
+                static EventPool* pool = new EventPool();
+                return *pool;
+            }
+
+            EventSlot* acquire()
+            {
+                if (auto slot = m_freeSlots.tryToPop())
+                    return *slot;
+
+                return new EventSlot();
+            }
+
+            void release(EventSlot* slot) noexcept
+            {
+                if (!m_freeSlots.push(slot))
+                    delete slot;
+            }
+
+        private:
+            EventPool()
+                : m_freeSlots(c_eventPoolCapacity)
+            {}
+
+            RingBufferQueue<EventSlot*> m_freeSlots;
+        };
+    }
+
+    SharedEvent SharedEvent::make(const CompactEvent& event)
+    {
+        EventSlot* slot = EventPool::get().acquire();
+        slot->event = event;
+        slot->refCount.store(1, std::memory_order_relaxed);
+        return SharedEvent(slot);
+    }
+
+    SharedEvent SharedEvent::make(const ZenEvent& event)
+    {
+        EventSlot* slot = EventPool::get().acquire();
+        toCompactEvent(event, slot->event);
+        slot->refCount.store(1, std::memory_order_relaxed);
+        return SharedEvent(slot);
+    }
+
+    void SharedEvent::reset() noexcept
+    {
+        if (m_slot && m_slot->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            EventPool::get().release(m_slot);
+
+        m_slot = nullptr;
+    }
+}
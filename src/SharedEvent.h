@@ -0,0 +1,97 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_SHAREDEVENT_H_
+#define ZEN_SHAREDEVENT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "CompactEvent.h"
+
+namespace zen
+{
+    /** Number of released event slots the pool keeps for reuse. Slots beyond that are freed */
+    constexpr size_t c_eventPoolCapacity = 1024;
+
+    struct EventSlot
+    {
+        std::atomic_uint refCount;
+        CompactEvent event;
+    };
+
+    /**
+    Reference-counted handle to an immutable event stored in a pooled slot. A sensor writes
+    each event once and every subscribed queue stores a handle to the same slot, so the event
+    is only converted to a ZenEvent when it is handed out to the user. The slot returns to the pool when
+    the last handle is destroyed.
+    */
+    class SharedEvent
+    {
+    public:
+        SharedEvent() noexcept : m_slot(nullptr) {}
+
+        /** Copies the event into a slot taken from the process-wide pool */
+        static SharedEvent make(const CompactEvent& event);
+
+        /** Converts the event into a slot taken from the process-wide pool */
+        static SharedEvent make(const ZenEvent& event);
+
+        SharedEvent(const SharedEvent& other) noexcept
+            : m_slot(other.m_slot)
+        {
+            if (m_slot)
+                m_slot->refCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        SharedEvent(SharedEvent&& other) noexcept
+            : m_slot(other.m_slot)
+        {
+            other.m_slot = nullptr;
+        }
+
+        ~SharedEvent() { reset(); }
+
+        SharedEvent& operator=(const SharedEvent& other) noexcept
+        {
+            SharedEvent(other).swap(*this);
+            return *this;
+        }
+
+        SharedEvent& operator=(SharedEvent&& other) noexcept
+        {
+            SharedEvent(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        void swap(SharedEvent& other) noexcept
+        {
+            std::swap(m_slot, other.m_slot);
+        }
+
+        void reset() noexcept;
+
+        explicit operator bool() const noexcept { return m_slot != nullptr; }
+
+        const CompactEvent& operator*() const noexcept { return m_slot->event; }
+        const CompactEvent* operator->() const noexcept { return &m_slot->event; }
+
+        /** Number of handles sharing the slot, only meant for diagnostics */
+        unsigned int useCount() const noexcept { return m_slot ? m_slot->refCount.load() : 0; }
+
+    private:
+        explicit SharedEvent(EventSlot* slot) noexcept : m_slot(slot) {}
+
+        EventSlot* m_slot;
+    };
+}
+
+#endif
@@ -33,8 +33,10 @@ namespace zen
                 m[i * 3 + j] = i == j ? 1.f : 0.f;
     }
 
+    constexpr float c_radToDeg = 180.0f / 3.14159265359f;
+
     inline void radToDeg3(float * v) {
-        const auto r2d = 180.0f / 3.14159265359f;
+        const auto r2d = c_radToDeg;
         v[0] *= r2d;
         v[1] *= r2d;
         v[2] *= r2d;
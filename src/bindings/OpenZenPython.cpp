@@ -10,6 +10,7 @@
 
 #include "OpenZen.h"
 
+#include <pybind11/functional.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -148,6 +149,16 @@ PYBIND11_MODULE(openzen, m) {
         .value("Debug", ZenLogLevel_Debug)
         .value("Max", ZenLogLevel_Max);
 
+    py::enum_<ZenEventQueueType>(m, "ZenEventQueueType")
+        .value("Locking", ZenEventQueueType_Locking)
+        .value("LockFree", ZenEventQueueType_LockFree)
+        .value("Conflating", ZenEventQueueType_Conflating);
+
+    py::enum_<ZenEventQueueOverflowPolicy>(m, "ZenEventQueueOverflowPolicy")
+        .value("DropNewest", ZenEventQueueOverflowPolicy_DropNewest)
+        .value("DropOldest", ZenEventQueueOverflowPolicy_DropOldest)
+        .value("Block", ZenEventQueueOverflowPolicy_Block);
+
     py::class_<ZenImuData>(m,"ZenImuData")
         .def_property_readonly("a", [](const ZenImuData & data) {
             return OpenZenPythonHelper::toStlArray<float, 3>(data.a);
@@ -285,6 +296,29 @@ PYBIND11_MODULE(openzen, m) {
             "is the time in nanoseconds that the above date & time values need "
             "to be shifted to arrive at the exact time measured by the GNSS receiver.");
 
+    py::enum_<ZenSerialIoFlags>(m, "ZenSerialIoFlags", py::arithmetic())
+        .value("NoFlags", ZenSerialIoFlags_None)
+        .value("LowLatency", ZenSerialIoFlags_LowLatency);
+
+    py::class_<ZenSerialIoOptions>(m, "ZenSerialIoOptions")
+        .def(py::init([](uint32_t flags, uint32_t readChunkSize, uint32_t usbLatencyTimerMs) {
+            return ZenSerialIoOptions{ flags, readChunkSize, usbLatencyTimerMs };
+        }), py::arg("flags") = 0, py::arg("read_chunk_size") = 0, py::arg("usb_latency_timer_ms") = 0)
+        .def_readwrite("flags", &ZenSerialIoOptions::flags)
+        .def_readwrite("read_chunk_size", &ZenSerialIoOptions::readChunkSize)
+        .def_readwrite("usb_latency_timer_ms", &ZenSerialIoOptions::usbLatencyTimerMs);
+
+    py::class_<ZenIoStatistics>(m, "ZenIoStatistics")
+        .def_readonly("read_count", &ZenIoStatistics::readCount)
+        .def_readonly("bytes_read", &ZenIoStatistics::bytesRead)
+        .def_readonly("mean_read_latency_ns", &ZenIoStatistics::meanReadLatencyNs)
+        .def_readonly("max_read_latency_ns", &ZenIoStatistics::maxReadLatencyNs);
+
+    py::class_<ZenFrameStatistics>(m, "ZenFrameStatistics")
+        .def_readonly("checksum_errors", &ZenFrameStatistics::checksumErrors)
+        .def_readonly("framing_errors", &ZenFrameStatistics::framingErrors)
+        .def_readonly("bytes_discarded", &ZenFrameStatistics::bytesDiscarded);
+
     py::class_<ZenSensorDesc>(m,"ZenSensorDesc")
         .def_readonly("name", &ZenSensorDesc::name,
             "User-readable name of the sensor device")
@@ -300,7 +334,10 @@ PYBIND11_MODULE(openzen, m) {
         .def_readonly("baud_rate", &ZenSensorDesc::baudRate,
             "baud rate to use with the device. A baud rate of 0 indicates "
             "that OpenZen should use the default baudrate or negotiagte a "
-            "suitable baud rate with the device.");
+            "suitable baud rate with the device.")
+        .def_readwrite("serial_options", &ZenSensorDesc::serialOptions,
+            "Options for sensors connected by a serial port, set them "
+            "before the sensor is obtained.");
 
     py::class_<ZenEventData_SensorDisconnected>(m,"SensorDisconnected")
         .def_readonly("error", &ZenEventData_SensorDisconnected::error);
@@ -309,6 +346,10 @@ PYBIND11_MODULE(openzen, m) {
         .def_readonly("progress", &ZenEventData_SensorListingProgress::progress)
         .def_property_readonly("complete", [](const ZenEventData_SensorListingProgress & data) -> bool {
             return data.complete > 0;
+        })
+        .def_readonly("io_type", &ZenEventData_SensorListingProgress::ioType)
+        .def_property_readonly("timed_out", [](const ZenEventData_SensorListingProgress & data) -> bool {
+            return data.timedOut > 0;
         });
 
     py::class_<ZenEventData>(m, "ZenEventData")
@@ -316,6 +357,7 @@ PYBIND11_MODULE(openzen, m) {
         .def_readonly("gnss_data", &ZenEventData::gnssData)
         .def_readonly("sensor_disconnected", &ZenEventData::sensorDisconnected)
         .def_readonly("sensor_found", &ZenEventData::sensorFound)
+        .def_readonly("sensor_removed", &ZenEventData::sensorRemoved)
         .def_readonly("sensor_listing_progress", &ZenEventData::sensorListingProgress);
 
     py::enum_<ZenEventType>(m, "ZenEventType")
@@ -323,6 +365,7 @@ PYBIND11_MODULE(openzen, m) {
         .value("SensorFound", ZenEventType_SensorFound)
         .value("SensorListingProgress", ZenEventType_SensorListingProgress)
         .value("SensorDisconnected", ZenEventType_SensorDisconnected)
+        .value("SensorRemoved", ZenEventType_SensorRemoved)
         .value("ImuData", ZenEventType_ImuData)
         .value("GnssData", ZenEventType_GnssData);
 
@@ -330,7 +373,24 @@ PYBIND11_MODULE(openzen, m) {
         .def_readonly("event_type", &ZenEvent::eventType)
         .def_readonly("sensor", &ZenEvent::sensor)
         .def_readonly("component", &ZenEvent::component)
-        .def_readonly("data", &ZenEvent::data);
+        .def_readonly("data", &ZenEvent::data)
+        .def_readonly("received_timestamp_ns", &ZenEvent::receivedTimestampNs)
+        .def_readonly("queued_timestamp_ns", &ZenEvent::queuedTimestampNs);
+
+    py::class_<ZenEventDecimation>(m, "ZenEventDecimation")
+        .def(py::init([](uint32_t keepEveryNth, uint32_t minIntervalUs) {
+            return ZenEventDecimation{ keepEveryNth, minIntervalUs };
+        }), py::arg("keep_every_nth") = 0, py::arg("min_interval_us") = 0)
+        .def_readwrite("keep_every_nth", &ZenEventDecimation::keepEveryNth)
+        .def_readwrite("min_interval_us", &ZenEventDecimation::minIntervalUs);
+
+    py::class_<ZenEventFilter>(m, "ZenEventFilter")
+        .def(py::init([]() {
+            return ZenEventFilter{ {0}, ZenEventType_None, ZenEventType_Max };
+        }))
+        .def_readwrite("component", &ZenEventFilter::component)
+        .def_readwrite("min_event_type", &ZenEventFilter::minEventType)
+        .def_readwrite("max_event_type", &ZenEventFilter::maxEventType);
 
     py::enum_<EZenSensorProperty>(m, "ZenSensorProperty")
         .value("DeviceName", ZenSensorProperty_DeviceName)
@@ -495,47 +555,69 @@ PYBIND11_MODULE(openzen, m) {
     m.attr("component_type_gnss") = g_zenSensorType_Gnss;
 
     m.def("set_log_level", &ZenSetLogLevel, "Sets the loglevel to the console of the whole OpenZen library");
+    m.def("set_io_thread_count", &ZenSetIoThreadCount,
+        "Sets the number of threads which read from all serial devices, only supported on Linux");
+    m.def("set_io_capture_directory", [](const std::string& directory) { return ZenSetIoCaptureDirectory(directory.c_str()); },
+        "Captures the raw IO data of sensors obtained later into the directory, an empty string disables capturing");
+    m.def("get_host_timestamp_ns", &ZenGetHostTimestampNs,
+        "Returns the monotonic host time in nanoseconds which is used for the timestamps of ZenEvent");
 
     // C++ part of the interface from OpenZen.h
     // starting here
+    // Releases the GIL while calling into OpenZen, for calls which wait for the IO threads or take locks
+    // which they hold while running Python callbacks
+    const auto releaseGil = py::call_guard<py::gil_scoped_release>();
+
     py::class_<ZenSensorComponent>(m,"ZenSensorComponent")
         .def_property_readonly("sensor", &ZenSensorComponent::sensor)
         .def_property_readonly("component", &ZenSensorComponent::component)
         .def_property_readonly("type", &ZenSensorComponent::type)
 
-        .def("execute_property", &ZenSensorComponent::executeProperty)
+        .def("execute_property", &ZenSensorComponent::executeProperty, releaseGil)
+
+        // latest samples, returned as (error, seq, data)
+        .def("get_latest_imu_data", [](ZenSensorComponent& self) {
+            ZenImuData data{};
+            auto result = self.getLatestImuData(data);
+            return std::make_tuple(result.first, result.second, data);
+        })
+        .def("get_latest_gnss_data", [](ZenSensorComponent& self) {
+            ZenGnssData data{};
+            auto result = self.getLatestGnssData(data);
+            return std::make_tuple(result.first, result.second, data);
+        })
 
         // get properties
         // array properties
-        .def("get_array_property_float", &ZenSensorComponent::getArrayProperty<float>)
-        .def("get_array_property_int32", &ZenSensorComponent::getArrayProperty<int32_t>)
-        .def("get_array_property_byte", &ZenSensorComponent::getArrayProperty<std::byte>)
-        .def("get_array_property_uint64", &ZenSensorComponent::getArrayProperty<uint64_t>)
+        .def("get_array_property_float", &ZenSensorComponent::getArrayProperty<float>, releaseGil)
+        .def("get_array_property_int32", &ZenSensorComponent::getArrayProperty<int32_t>, releaseGil)
+        .def("get_array_property_byte", &ZenSensorComponent::getArrayProperty<std::byte>, releaseGil)
+        .def("get_array_property_uint64", &ZenSensorComponent::getArrayProperty<uint64_t>, releaseGil)
 
         // scalar properties
-        .def("get_bool_property", &ZenSensorComponent::getBoolProperty)
-        .def("get_float_property", &ZenSensorComponent::getFloatProperty)
-        .def("get_int32_property", &ZenSensorComponent::getInt32Property)
-        .def("get_uint64_property", &ZenSensorComponent::getUInt64Property)
+        .def("get_bool_property", &ZenSensorComponent::getBoolProperty, releaseGil)
+        .def("get_float_property", &ZenSensorComponent::getFloatProperty, releaseGil)
+        .def("get_int32_property", &ZenSensorComponent::getInt32Property, releaseGil)
+        .def("get_uint64_property", &ZenSensorComponent::getUInt64Property, releaseGil)
 
         // set properties
         // array properties
-        .def("set_array_property_float", &ZenSensorComponent::setArrayProperty<float>)
-        .def("set_array_property_int32", &ZenSensorComponent::setArrayProperty<int32_t>)
-        .def("set_array_property_byte", &ZenSensorComponent::setArrayProperty<std::byte>)
-        .def("set_array_property_uint64", &ZenSensorComponent::setArrayProperty<uint64_t>)
+        .def("set_array_property_float", &ZenSensorComponent::setArrayProperty<float>, releaseGil)
+        .def("set_array_property_int32", &ZenSensorComponent::setArrayProperty<int32_t>, releaseGil)
+        .def("set_array_property_byte", &ZenSensorComponent::setArrayProperty<std::byte>, releaseGil)
+        .def("set_array_property_uint64", &ZenSensorComponent::setArrayProperty<uint64_t>, releaseGil)
 
         // scalar properties
-        .def("set_bool_property", &ZenSensorComponent::setBoolProperty)
-        .def("set_float_property", &ZenSensorComponent::setFloatProperty)
-        .def("set_int32_property", &ZenSensorComponent::setInt32Property)
-        .def("set_uint64_property", &ZenSensorComponent::setUInt64Property)
+        .def("set_bool_property", &ZenSensorComponent::setBoolProperty, releaseGil)
+        .def("set_float_property", &ZenSensorComponent::setFloatProperty, releaseGil)
+        .def("set_int32_property", &ZenSensorComponent::setInt32Property, releaseGil)
+        .def("set_uint64_property", &ZenSensorComponent::setUInt64Property, releaseGil)
 
-        .def("forward_rtk_corrections", &ZenSensorComponent::forwardRtkCorrections);
+        .def("forward_rtk_corrections", &ZenSensorComponent::forwardRtkCorrections, releaseGil);
 
     py::class_<ZenSensor>(m,"ZenSensor")
         .def_property_readonly("device_name", &ZenSensor::deviceName)
-        .def("release", &ZenSensor::release)
+        .def("release", &ZenSensor::release, releaseGil)
 
         // updateFirmwareAsync and
         // updateIAPAsync not available via python interface at this time
@@ -543,44 +625,74 @@ PYBIND11_MODULE(openzen, m) {
         .def_property_readonly("io_type", &ZenSensor::ioType)
         .def("equals", &ZenSensor::equals)
         .def_property_readonly("sensor", &ZenSensor::sensor)
-        .def("publish_events", &ZenSensor::publishEvents)
-        .def("execute_property", &ZenSensor::executeProperty)
-
-        .def("get_array_property_float", &ZenSensor::getArrayProperty<float>)
-        .def("get_array_property_int32", &ZenSensor::getArrayProperty<int32_t>)
-        .def("get_array_property_byte", &ZenSensor::getArrayProperty<std::byte>)
-        .def("get_array_property_uint64", &ZenSensor::getArrayProperty<uint64_t>)
-        .def("get_string_property", &ZenSensor::getStringProperty)
+        .def("publish_events", static_cast<ZenError (ZenSensor::*)(std::string const&) noexcept>(&ZenSensor::publishEvents),
+            releaseGil)
+        .def("publish_events", static_cast<ZenError (ZenSensor::*)(std::string const&, const ZenEventDecimation&) noexcept>(
+            &ZenSensor::publishEvents), releaseGil)
+        .def("publish_events", static_cast<ZenError (ZenSensor::*)(std::string const&, const ZenEventDecimation&, size_t,
+            ZenEventQueueOverflowPolicy) noexcept>(&ZenSensor::publishEvents),
+            py::arg("endpoint"), py::arg("decimation"), py::arg("queue_capacity"), py::arg("overflow_policy"), releaseGil)
+        // the callback runs on the IO thread and acquires the GIL for each event, while the sensor holds
+        // its subscribers. Calls which take them or wait for the IO thread must not hold the GIL.
+        .def("on_event", &ZenSensor::onEvent, releaseGil)
+        .def("set_event_filter", &ZenSensor::setEventFilter, releaseGil)
+        .def("reset_event_filter", &ZenSensor::resetEventFilter, releaseGil)
+        .def("dropped_event_count", &ZenSensor::droppedEventCount)
+        .def("io_statistics", &ZenSensor::ioStatistics, releaseGil)
+        .def("frame_statistics", &ZenSensor::frameStatistics, releaseGil)
+        .def("execute_property", &ZenSensor::executeProperty, releaseGil)
+
+        .def("get_array_property_float", &ZenSensor::getArrayProperty<float>, releaseGil)
+        .def("get_array_property_int32", &ZenSensor::getArrayProperty<int32_t>, releaseGil)
+        .def("get_array_property_byte", &ZenSensor::getArrayProperty<std::byte>, releaseGil)
+        .def("get_array_property_uint64", &ZenSensor::getArrayProperty<uint64_t>, releaseGil)
+        .def("get_string_property", &ZenSensor::getStringProperty, releaseGil)
 
         .def_property_readonly("sensor", &ZenSensor::sensor)
 
         // scalar properties
-        .def("get_bool_property", &ZenSensor::getBoolProperty)
-        .def("get_float_property", &ZenSensor::getFloatProperty)
-        .def("get_int32_property", &ZenSensor::getInt32Property)
-        .def("get_uint64_property", &ZenSensor::getUInt64Property)
+        .def("get_bool_property", &ZenSensor::getBoolProperty, releaseGil)
+        .def("get_float_property", &ZenSensor::getFloatProperty, releaseGil)
+        .def("get_int32_property", &ZenSensor::getInt32Property, releaseGil)
+        .def("get_uint64_property", &ZenSensor::getUInt64Property, releaseGil)
 
         // array property access
-        .def("set_array_property_float", &ZenSensor::setArrayProperty<float>)
-        .def("set_array_property_int32", &ZenSensor::setArrayProperty<int32_t>)
-        .def("set_array_property_myte", &ZenSensor::setArrayProperty<std::byte>)
-        .def("set_array_property_uint64", &ZenSensor::setArrayProperty<uint64_t>)
+        .def("set_array_property_float", &ZenSensor::setArrayProperty<float>, releaseGil)
+        .def("set_array_property_int32", &ZenSensor::setArrayProperty<int32_t>, releaseGil)
+        .def("set_array_property_myte", &ZenSensor::setArrayProperty<std::byte>, releaseGil)
+        .def("set_array_property_uint64", &ZenSensor::setArrayProperty<uint64_t>, releaseGil)
 
-        .def("set_bool_property", &ZenSensor::setBoolProperty)
-        .def("set_float_property", &ZenSensor::setFloatProperty)
-        .def("set_int32_property", &ZenSensor::setInt32Property)
-        .def("set_uint64_property", &ZenSensor::setUInt64Property)
+        .def("set_bool_property", &ZenSensor::setBoolProperty, releaseGil)
+        .def("set_float_property", &ZenSensor::setFloatProperty, releaseGil)
+        .def("set_int32_property", &ZenSensor::setInt32Property, releaseGil)
+        .def("set_uint64_property", &ZenSensor::setUInt64Property, releaseGil)
 
         .def("get_any_component_of_type", &ZenSensor::getAnyComponentOfType);
 
     py::class_<ZenClient>(m,"ZenClient")
-        .def("close", &ZenClient::close)
-        .def("list_sensors_async", &ZenClient::listSensorsAsync)
-        .def("obtain_sensor", &ZenClient::obtainSensor)
+        .def("close", &ZenClient::close, releaseGil)
+        .def("set_event_queue_type", &ZenClient::setEventQueueType,
+             py::arg("type"), py::arg("capacity") = 0)
+        .def("set_event_queue_overflow_policy", &ZenClient::setEventQueueOverflowPolicy)
+        .def("set_event_filter", &ZenClient::setEventFilter, releaseGil)
+        .def("set_event_decimation", &ZenClient::setEventDecimation, releaseGil)
+        .def("reset_event_decimation", &ZenClient::resetEventDecimation, releaseGil)
+        .def("reset_event_filter", &ZenClient::resetEventFilter, releaseGil)
+        .def("get_event_fd", &ZenClient::eventFd)
+        .def("list_sensors_async", &ZenClient::listSensorsAsync, releaseGil)
+        .def("obtain_sensor", &ZenClient::obtainSensor, releaseGil)
         .def("obtain_sensor_by_name", &ZenClient::obtainSensorByName,
-             py::arg("ioType"), py::arg("identifier"), py::arg("baudrate") = 0)
+             py::arg("ioType"), py::arg("identifier"), py::arg("baudrate") = 0, releaseGil)
         .def("poll_next_event", &ZenClient::pollNextEvent)
-        .def("wait_for_next_event", &ZenClient::waitForNextEvent);
+        .def("wait_for_next_event", &ZenClient::waitForNextEvent, releaseGil)
+        .def("poll_events", [](ZenClient& self, size_t maxEvents) {
+            return self.pollNextEvents(maxEvents);
+        }, py::arg("max_events"))
+        .def("wait_for_events", [](ZenClient& self, size_t maxEvents, long long waitTimeMs) {
+            // release the GIL so other Python threads can run while this one waits for sensor data
+            py::gil_scoped_release release;
+            return self.waitForNextEventsFor(maxEvents, std::chrono::milliseconds(waitTimeMs));
+        }, py::arg("max_events"), py::arg("wait_time_ms"));
 
     m.def("make_client", &make_client);
 }
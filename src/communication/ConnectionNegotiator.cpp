@@ -21,6 +21,8 @@
 
 #include <gsl/zstring>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <thread>
 
@@ -107,47 +109,67 @@ namespace zen
 
     }
 
-    nonstd::expected<SensorConfig, ZenSensorInitError> ConnectionNegotiator::negotiate(
-      ModbusCommunicator& communicator, unsigned int desiredBaudRate) noexcept
+    namespace
     {
         constexpr const auto IO_TIMEOUT = std::chrono::milliseconds(2000);
-        communicator.setBaudRate(desiredBaudRate);
 
-        bool commandModeReply = false;
+        // Probing a baud rate at which the sensor does not reply has to be quick, as several are tried
+        constexpr const auto PROBE_SETTLE_TIME = std::chrono::milliseconds(100);
+        constexpr const auto PROBE_TIMEOUT = std::chrono::milliseconds(300);
 
-        // try two times because in some cases, the reply of the first command send to the sensor
-        // will not be in the input buffer.
-        for (size_t retries = 0; retries < m_connectRetryAttempts; retries++) {
-            m_terminated = false;
-            spdlog::debug("Attempting to set sensor in command mode for connection negotiaton");
-            // wait for some io messages to come in
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            // disable streaming during connection negotiation, command same for legacy and Ig1
-            if (ZenError_None != communicator.send(0, uint8_t(EDevicePropertyV0::SetCommandMode), gsl::span<std::byte>()))
+        // UART baud rates of LPMS sensors (bit/s), the ones above 921600 only of the high-rate configurations
+        constexpr std::array<unsigned int, 13> c_sensorBaudRates = { 3000000, 2000000, 1500000, 1000000,
+            921600, 460800, 256000, 230400, 115200, 57600, 38400, 19200, 9600 };
+    }
+
+    std::vector<unsigned int> ConnectionNegotiator::commonBaudRates(const std::vector<int32_t>& ioBaudRates) noexcept
+    {
+        std::vector<unsigned int> baudRates;
+        for (auto baudRate : c_sensorBaudRates)
+            if (std::find(ioBaudRates.begin(), ioBaudRates.end(), static_cast<int32_t>(baudRate)) != ioBaudRates.end())
+                baudRates.push_back(baudRate);
+
+        return baudRates;
+    }
+
+    nonstd::expected<SensorConfig, ZenSensorInitError> ConnectionNegotiator::negotiate(
+      ModbusCommunicator& communicator, unsigned int desiredBaudRate, unsigned int fallbackBaudRate) noexcept
+    {
+        // most sensors run at the default rate of the IO system, so it is probed first
+        std::vector<unsigned int> baudRates;
+        if (desiredBaudRate == 0 && fallbackBaudRate != 0)
+            if (auto ioBaudRates = communicator.supportedBaudRates())
             {
-                spdlog::error("Cannot set sensor in command mode");
-                return nonstd::make_unexpected(ZenSensorInitError_SendFailed);
+                baudRates.push_back(fallbackBaudRate);
+                for (auto baudRate : commonBaudRates(*ioBaudRates))
+                    if (baudRate != fallbackBaudRate)
+                        baudRates.push_back(baudRate);
             }
-            {
-                std::unique_lock<std::mutex> lock(m_mutex);
-                if (m_cv.wait_for(lock, IO_TIMEOUT, [this]() { return m_terminated; }) == false) {
-                    // hit timeout, will retry
-                    spdlog::debug("Time out while attempting to set sensor in command mode for connection negotiaton");
 
-                    // reset parser because if the data transmission of the sensor stopped without
-                    // sending the full package payload, we might still think we are parsing the payload
-                    // while we already get an acknowledgement for our command mode request
-                    communicator.resetParser();
-                } else {
-                    commandModeReply = true;
-                    break;
-                }
+        bool commandModeReply = false;
+        for (auto baudRate : baudRates) {
+            spdlog::debug("Probing sensor at baud rate {}", baudRate);
+            if (ZenError_None != communicator.setBaudRate(baudRate))
+                continue;
+
+            const auto error = setCommandMode(communicator, 1, PROBE_SETTLE_TIME, PROBE_TIMEOUT);
+            if (error == ZenSensorInitError_None) {
+                spdlog::info("Detected sensor at baud rate {}", baudRate);
+                commandModeReply = true;
+                break;
+            } else if (error != ZenSensorInitError_Timeout) {
+                return nonstd::make_unexpected(error);
             }
         }
 
         if (commandModeReply == false) {
-            spdlog::error("Time out when setting sensor to command mode before configuration.");
-            return nonstd::make_unexpected(ZenSensorInitError_Timeout);
+            communicator.setBaudRate(desiredBaudRate != 0 ? desiredBaudRate : fallbackBaudRate);
+
+            if (auto error = setCommandMode(communicator, m_connectRetryAttempts, std::chrono::milliseconds(200), IO_TIMEOUT)) {
+                if (error == ZenSensorInitError_Timeout)
+                    spdlog::error("Time out when setting sensor to command mode before configuration.");
+                return nonstd::make_unexpected(error);
+            }
         }
 
         // will send command 21, which is GET_IMU_ID for legacy sensors. So legacy sensors will return one 32-bit
@@ -186,6 +208,41 @@ namespace zen
         return loadDeviceConfig();
     }
 
+    ZenSensorInitError ConnectionNegotiator::setCommandMode(ModbusCommunicator& communicator, size_t attempts,
+      std::chrono::milliseconds settleTime, std::chrono::milliseconds timeout) noexcept
+    {
+        // try multiple times because in some cases, the reply of the first command send to the sensor
+        // will not be in the input buffer.
+        for (size_t retries = 0; retries < attempts; retries++) {
+            m_terminated = false;
+            spdlog::debug("Attempting to set sensor in command mode for connection negotiaton");
+            // wait for some io messages to come in
+            std::this_thread::sleep_for(settleTime);
+            // disable streaming during connection negotiation, command same for legacy and Ig1
+            if (ZenError_None != communicator.send(0, uint8_t(EDevicePropertyV0::SetCommandMode), gsl::span<std::byte>()))
+            {
+                spdlog::error("Cannot set sensor in command mode");
+                return ZenSensorInitError_SendFailed;
+            }
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_cv.wait_for(lock, timeout, [this]() { return m_terminated; }) == false) {
+                    // hit timeout, will retry
+                    spdlog::debug("Time out while attempting to set sensor in command mode for connection negotiaton");
+
+                    // reset parser because if the data transmission of the sensor stopped without
+                    // sending the full package payload, we might still think we are parsing the payload
+                    // while we already get an acknowledgement for our command mode request
+                    communicator.resetParser();
+                } else {
+                    return ZenSensorInitError_None;
+                }
+            }
+        }
+
+        return ZenSensorInitError_Timeout;
+    }
+
     nonstd::expected<SensorConfig, ZenSensorInitError> ConnectionNegotiator::loadDeviceConfig() const {
         const std::string localDeviceName = [this]() { if (m_deviceName)
             return *m_deviceName;
@@ -233,7 +290,7 @@ namespace zen
         }
     }
 
-    ZenError ConnectionNegotiator::processReceivedData(uint8_t, uint16_t function, gsl::span<const std::byte> data) noexcept
+    ZenError ConnectionNegotiator::processReceivedData(uint8_t, uint16_t function, gsl::span<const std::byte> data, uint64_t) noexcept
     {
         if ((function == ZenProtocolFunction_Handshake) ||
             (function == uint16_t(EDevicePropertyV1::Ack)) ||
@@ -11,6 +11,7 @@
 #ifndef ZEN_COMMUNICATION_CONNECTIONNEGOTIATOR_H_
 #define ZEN_COMMUNICATION_CONNECTIONNEGOTIATOR_H_
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <vector>
@@ -35,16 +36,28 @@ namespace zen
         ConnectionNegotiator() noexcept;
 
         /** Try to determine the appropriate baudrate, and when done negotiate
-            the configuration of the sensor. */
+            the configuration of the sensor. A desired baud rate of zero auto-detects the rate
+            the sensor is configured to: the fallback baud rate is probed first, then the other
+            rates supported by the IO interface and the sensor, starting with the highest one.
+            The sensor's UART rate is not changed. If the sensor does not reply at any of them,
+            the fallback baud rate is retried with the regular timeout.
+            Without a fallback baud rate, e.g. for CAN interfaces, no rates are probed. */
         nonstd::expected<SensorConfig, ZenSensorInitError> negotiate(ModbusCommunicator& communicator,
-          unsigned int desiredBaudRate) noexcept;
+          unsigned int desiredBaudRate, unsigned int fallbackBaudRate = 0) noexcept;
+
+        /** Returns the baud rates (bit/s) of the IO interface, which are supported by sensors, in descending order */
+        static std::vector<unsigned int> commonBaudRates(const std::vector<int32_t>& ioBaudRates) noexcept;
 
         std::optional<std::string> m_deviceName;
     private:
         ZenError processReceivedData(uint8_t address, uint16_t function,
-          gsl::span<const std::byte> data) noexcept override;
+          gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept override;
 
     private:
+        /** Sets the sensor in command mode, returns ZenSensorInitError_Timeout if it did not reply */
+        ZenSensorInitError setCommandMode(ModbusCommunicator& communicator, size_t attempts,
+          std::chrono::milliseconds settleTime, std::chrono::milliseconds timeout) noexcept;
+
         nonstd::expected<SensorConfig, ZenSensorInitError> loadDeviceConfig() const;
 
         SensorConfig m_config;
@@ -9,10 +9,51 @@
 //===========================================================================//
 #include "Modbus.h"
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 namespace
 {
+    constexpr std::byte c_start{ 0x3a };
+    constexpr std::byte c_end1{ 0x0d };
+    constexpr std::byte c_end2{ 0x0a };
+
+    // 1 (start) + 2 (address) + 2 (function) + 2 (length)
+    constexpr size_t c_headerSize = 7;
+    // header + 2 (LRC) + 2 (end)
+    constexpr size_t c_wrapperSize = c_headerSize + 4;
+
+    /** Sums the bytes modulo 2^16, eight at a time in the 16-bit lanes of a 64-bit integer */
+    uint16_t sumBytes(const std::byte* data, size_t length) noexcept
+    {
+        constexpr uint64_t evenBytes = 0x00ff00ff00ff00ffull;
+        // Every word adds at most 2 * 255 to a lane, which holds 128 words without overflowing
+        constexpr size_t wordsPerFlush = 128;
+
+        uint32_t total = 0;
+        while (length >= sizeof(uint64_t))
+        {
+            const size_t nWords = std::min(length / sizeof(uint64_t), wordsPerFlush);
+
+            uint64_t lanes = 0;
+            for (size_t idx = 0; idx < nWords; ++idx)
+            {
+                uint64_t word;
+                std::memcpy(&word, data + idx * sizeof(uint64_t), sizeof(word));
+                lanes += (word & evenBytes) + ((word >> 8) & evenBytes);
+            }
+
+            total += static_cast<uint32_t>((lanes & 0xffff) + ((lanes >> 16) & 0xffff) + ((lanes >> 32) & 0xffff) + (lanes >> 48));
+            data += nWords * sizeof(uint64_t);
+            length -= nWords * sizeof(uint64_t);
+        }
+
+        for (size_t idx = 0; idx < length; ++idx)
+            total += std::to_integer<uint8_t>(data[idx]);
+
+        return static_cast<uint16_t>(total);
+    }
 
     uint16_t lrcLp(uint8_t address, uint16_t function, const std::byte* data, uint16_t length) noexcept
     {
@@ -25,9 +66,7 @@ namespace
         total += function & 0xff;
         total += (function >> 8) & 0xff;
         total += length;
-        for (auto i = 0; i < length; ++i) {
-            total += std::to_integer<uint8_t>(data[i]);
-        }
+        total += sumBytes(data, length);
 
         return total;
     }
@@ -42,7 +81,17 @@ namespace zen::modbus
 {
     void IFrameParser::reset()
     {
-        m_frame.data.clear();
+        m_frame.data = {};
+    }
+
+    void IFrameParser::resync(gsl::span<const std::byte>& data)
+    {
+        reset();
+        if (!data.empty())
+        {
+            ++m_statistics.bytesDiscarded;
+            data = data.subspan(1);
+        }
     }
 
     std::unique_ptr<IFrameFactory> make_factory(ModbusFormat format) noexcept
@@ -75,7 +124,7 @@ namespace zen::modbus
         constexpr uint16_t WRAPPER_SIZE = 9; // 1 (start) + 2 (address) + 2 (function) + 2 (LRC) + 2 (end)
         std::vector<std::byte> frame(WRAPPER_SIZE + 2 + length);
 
-        frame[0] = std::byte(0x3a);
+        frame[0] = c_start;
         frame[1] = std::byte(address);
         frame[2] = std::byte(0);
         frame[3] = std::byte(function & 0xff);
@@ -97,12 +146,91 @@ namespace zen::modbus
 
     LpFrameParser::LpFrameParser()
         : m_state(LpFrameParseState::Start)
-    {}
+        , m_consumed(0)
+    {
+        m_reassembly.reserve(c_reassemblyCapacity);
+    }
 
     void LpFrameParser::reset()
     {
         IFrameParser::reset();
         m_state = LpFrameParseState::Start;
+        m_consumed = 0;
+        m_reassembly.clear();
+    }
+
+    void LpFrameParser::resync(gsl::span<const std::byte>& data)
+    {
+        // The consumed bytes of a frame split across reads are lost. A broken frame which starts in the
+        // data is searched for the next frame behind its start byte, in case the start byte was noise.
+        m_statistics.bytesDiscarded += m_consumed;
+        if (m_consumed == 0 && !data.empty())
+        {
+            ++m_statistics.bytesDiscarded;
+            data = data.subspan(1);
+        }
+
+        reset();
+        skipToStart(data);
+    }
+
+    FrameParseError LpFrameParser::fail(FrameParseError error) noexcept
+    {
+        switch (error)
+        {
+        case FrameParseError_ChecksumInvalid:
+            ++m_statistics.checksumErrors;
+            break;
+
+        case FrameParseError_UnexpectedCharacter:
+        case FrameParseError_ExpectedEnd:
+            ++m_statistics.framingErrors;
+            break;
+
+        default:
+            break;
+        }
+
+        return error;
+    }
+
+    void LpFrameParser::skipToStart(gsl::span<const std::byte>& data) noexcept
+    {
+        const auto next = static_cast<const std::byte*>(std::memchr(data.data(), std::to_integer<int>(c_start), data.size()));
+        const size_t nSkipped = next ? static_cast<size_t>(next - data.data()) : data.size();
+        m_statistics.bytesDiscarded += nSkipped;
+        data = data.subspan(nSkipped);
+    }
+
+    std::optional<FrameParseError> LpFrameParser::parseComplete(gsl::span<const std::byte>& data)
+    {
+        const std::byte* frame = data.data();
+        const uint16_t length = combine(std::to_integer<uint8_t>(frame[5]), std::to_integer<uint8_t>(frame[6]));
+        if (length > c_maxLength)
+            return fail(FrameParseError_UnexpectedCharacter);
+
+        const size_t frameSize = c_wrapperSize + length;
+        if (data.size() < frameSize)
+            return std::nullopt;
+
+        m_frame.address = std::to_integer<uint8_t>(frame[1]);
+        m_frame.function = combine(std::to_integer<uint8_t>(frame[3]), std::to_integer<uint8_t>(frame[4]));
+        m_length = length;
+
+        const std::byte* payload = frame + c_headerSize;
+        const std::byte* trailer = payload + length;
+        if (combine(std::to_integer<uint8_t>(trailer[0]), std::to_integer<uint8_t>(trailer[1])) != lrcLp(m_frame.address, m_frame.function, payload, length))
+            return fail(FrameParseError_ChecksumInvalid);
+
+        if (trailer[2] != c_end1 || trailer[3] != c_end2)
+            return fail(FrameParseError_ExpectedEnd);
+
+        // The payload is not copied, the frame points into the data
+        m_frame.data = gsl::span<const std::byte>(payload, length);
+
+        m_state = LpFrameParseState::Finished;
+        data = data.subspan(frameSize);
+        return FrameParseError_None;
     }
 
     FrameParseError LpFrameParser::parse(gsl::span<const std::byte>& data)
@@ -112,8 +240,20 @@ namespace zen::modbus
             switch (m_state)
             {
             case LpFrameParseState::Start:
-                if (data[0] != std::byte(0x3a))
-                    return FrameParseError_ExpectedStart;
+                if (data[0] != c_start)
+                {
+                    // Skip to the next start byte, everything before it cannot belong to a frame
+                    skipToStart(data);
+                    continue;
+                }
+
+                // Frames which are complete in the buffer are parsed at once, only frames which are
+                // split across reads go through the state machine byte by byte
+                if (data.size() >= c_headerSize)
+                {
+                    if (const auto error = parseComplete(data))
+                        return *error;
+                }
 
                 m_state = LpFrameParseState::Address1;
                 break;
@@ -145,14 +285,23 @@ namespace zen::modbus
 
             case LpFrameParseState::Length2:
                 m_length = combine(std::to_integer<uint8_t>(m_buffer), std::to_integer<uint8_t>(data[0]));
-                m_frame.data.reserve(m_length);
+                if (m_length > c_maxLength)
+                    return fail(FrameParseError_UnexpectedCharacter);
+
+                m_reassembly.reserve(m_length);
                 m_state = m_length != 0 ? LpFrameParseState::Data : LpFrameParseState::Check1;
                 break;
 
             case LpFrameParseState::Data:
-                m_frame.data.emplace_back(data[0]);
-                m_state = m_frame.data.size() == m_length ? LpFrameParseState::Check1 : LpFrameParseState::Data;
-                break;
+            {
+                // Copy as much of the payload as the buffer holds
+                const size_t nBytes = std::min<size_t>(m_length - m_reassembly.size(), data.size());
+                m_reassembly.insert(m_reassembly.end(), data.begin(), data.begin() + nBytes);
+                m_state = m_reassembly.size() == m_length ? LpFrameParseState::Check1 : LpFrameParseState::Data;
+                m_consumed += nBytes;
+                data = data.subspan(nBytes);
+                continue;
+            }
 
             case LpFrameParseState::Check1:
                 m_buffer = data[0];
@@ -160,22 +309,23 @@ namespace zen::modbus
                 break;
 
             case LpFrameParseState::Check2:
-                if (combine(std::to_integer<uint8_t>(m_buffer), std::to_integer<uint8_t>(data[0])) != lrcLp(m_frame.address, m_frame.function, m_frame.data.data(), m_length))
-                    return FrameParseError_ChecksumInvalid;
+                if (combine(std::to_integer<uint8_t>(m_buffer), std::to_integer<uint8_t>(data[0])) != lrcLp(m_frame.address, m_frame.function, m_reassembly.data(), m_length))
+                    return fail(FrameParseError_ChecksumInvalid);
 
+                m_frame.data = m_reassembly;
                 m_state = LpFrameParseState::End1;
                 break;
 
             case LpFrameParseState::End1:
-                if (data[0] != std::byte(0x0d))
-                    return FrameParseError_ExpectedEnd;
+                if (data[0] != c_end1)
+                    return fail(FrameParseError_ExpectedEnd);
 
                 m_state = LpFrameParseState::End2;
                 break;
 
             case LpFrameParseState::End2:
-                if (data[0] != std::byte(0x0a))
-                    return FrameParseError_ExpectedEnd;
+                if (data[0] != c_end2)
+                    return fail(FrameParseError_ExpectedEnd);
 
                 m_state = LpFrameParseState::Finished;
                 data = data.subspan(1);
@@ -185,9 +335,10 @@ namespace zen::modbus
                 return FrameParseError_Finished;
 
             default:
-                return FrameParseError_UnexpectedCharacter;
+                return fail(FrameParseError_UnexpectedCharacter);
             }
 
+            ++m_consumed;
             data = data.subspan(1);
         }
 
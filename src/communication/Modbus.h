@@ -14,6 +14,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include <gsl/span>
@@ -22,7 +23,10 @@ namespace zen::modbus
 {
     struct Frame
     {
-        std::vector<std::byte> data;
+        /** Payload of the frame. It points into the parsed data if the frame was complete in it and into
+         * a buffer of the parser otherwise, so it is only valid until the parser or the data is reused.
+         */
+        gsl::span<const std::byte> data;
         uint8_t address;
         uint16_t function;
     };
@@ -40,6 +44,16 @@ namespace zen::modbus
         FrameParseError_Max
     } FrameParseError;
 
+    /** Errors of the parsed data stream, counted by the parser */
+    struct FrameParseStatistics
+    {
+        uint64_t checksumErrors = 0;
+        // Frames with a missing end or an invalid length
+        uint64_t framingErrors = 0;
+        // Bytes which did not belong to a valid frame
+        uint64_t bytesDiscarded = 0;
+    };
+
     class IFrameFactory
     {
     public:
@@ -57,13 +71,24 @@ namespace zen::modbus
         virtual FrameParseError parse(gsl::span<const std::byte>& data) = 0;
         virtual void reset();
 
+        /** Recovers from a parse error by dropping the broken frame and skipping to the next candidate
+         * for the start of a frame. The data has to be the one which parse() returned the error for.
+         */
+        virtual void resync(gsl::span<const std::byte>& data);
+
         virtual bool finished() const = 0;
 
         Frame&& frame() { return std::move(m_frame); }
         const Frame& frame() const { return m_frame; }
 
+        const FrameParseStatistics& statistics() const { return m_statistics; }
+
+        /** Continues the statistics of a previous parser of the same data stream */
+        void setStatistics(const FrameParseStatistics& statistics) { m_statistics = statistics; }
+
     protected:
         Frame m_frame;
+        FrameParseStatistics m_statistics;
     };
 
     enum class ModbusFormat
@@ -104,15 +129,42 @@ namespace zen::modbus
     public:
         LpFrameParser();
 
+        /** Largest payload accepted in a frame header, larger than any output or reply of a sensor.
+         * It keeps a start byte in corrupted data from swallowing the frames which follow it.
+         */
+        constexpr static uint16_t c_maxLength = 4096;
+
+        /** Bytes in front of the start of a frame are skipped */
         FrameParseError parse(gsl::span<const std::byte>& data) override;
         void reset() override;
+        void resync(gsl::span<const std::byte>& data) override;
 
         bool finished() const override { return m_state == LpFrameParseState::Finished; }
 
     private:
+        /** Initial capacity of the buffer for frames split across reads, which covers all sensor outputs */
+        constexpr static size_t c_reassemblyCapacity = 512;
+
+        /** Parses a frame which starts at the beginning of the data, if all of it is in the data.
+         * Returns std::nullopt and leaves the data untouched if the frame is incomplete.
+         */
+        std::optional<FrameParseError> parseComplete(gsl::span<const std::byte>& data);
+
+        /** Counts the error in the statistics */
+        FrameParseError fail(FrameParseError error) noexcept;
+
+        /** Skips the data to the next start byte */
+        void skipToStart(gsl::span<const std::byte>& data) noexcept;
+
         LpFrameParseState m_state;
         uint16_t m_length;
         std::byte m_buffer;
+
+        // Bytes of the current frame which were consumed by the state machine
+        size_t m_consumed;
+
+        // Payload of a frame split across reads, which keeps its capacity
+        std::vector<std::byte> m_reassembly;
     };
 }
 
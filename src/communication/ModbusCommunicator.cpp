@@ -30,7 +30,8 @@ namespace zen
         m_ioInterface = std::move(ioInterface);
     }
 
-    ZenError ModbusCommunicator::send(uint8_t address, uint16_t function, gsl::span<const std::byte> data) noexcept
+    ZenError ModbusCommunicator::send(uint8_t address, uint16_t function, gsl::span<const std::byte> data,
+        IIoInterface::SendCompletion completion) noexcept
     {
         spdlog::debug("sending address: {0} function: {1} data size: {2} data: {3}",
             address, function, data.size(), util::spanToString(data));
@@ -41,49 +42,71 @@ namespace zen
         if (data.size() > std::numeric_limits<uint16_t>::max())
            return ZenError_Io_MsgTooBig;
 
-        const auto frame = m_factory->makeFrame(address, function, data.data(), static_cast<uint16_t>(data.size()));
-        return m_ioInterface->send(frame);
+        auto frame = m_factory->makeFrame(address, function, data.data(), static_cast<uint16_t>(data.size()));
+        m_ioInterface->captureSentData(frame);
+        return m_ioInterface->sendAsync(std::move(frame), std::move(completion));
     }
 
-    ZenError ModbusCommunicator::processData(gsl::span<const std::byte> data) noexcept
+    ZenError ModbusCommunicator::processData(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept
     {
         // enable this for low-level communication debugging
         SPDLOG_DEBUG("received data of size: {0}", data.size());
 
         while (!data.empty())
         {
-            while (m_parserBusy.test_and_set(std::memory_order_acquire)) { /*spin lock*/ }
-            auto guard = finally([this]() {
-                m_parserBusy.clear(std::memory_order_release);
-            });
-
-            if (auto parserError = m_parser->parse(data); parserError != modbus::FrameParseError_None)
+            // The parser is only held while parsing, the subscriber may run event callbacks
+            modbus::IFrameParser* parser;
             {
-                spdlog::debug("Parsing of packet failed, can happen when OpenZen started to parse in the middle of a package. Error: {}",
-                    fmt::underlying(parserError));
-                // drop first byte and look for new start character
-                m_parser->reset();
-                data = data.subspan(1);
+                while (m_parserBusy.test_and_set(std::memory_order_acquire)) { /*spin lock*/ }
+                auto guard = finally([this]() {
+                    m_parserBusy.clear(std::memory_order_release);
+                });
+
+                parser = m_parser.get();
+                const auto parserError = parser->parse(data);
+                if (parserError != modbus::FrameParseError_None)
+                {
+                    spdlog::debug("Parsing of packet failed, can happen when OpenZen started to parse in the middle of a package. Error: {}",
+                        fmt::underlying(parserError));
+                    // drop the broken frame and continue at the next start character
+                    parser->resync(data);
+                }
 
-                continue;
+                publishStatistics(parser->statistics());
+                if (parserError != modbus::FrameParseError_None || !parser->finished())
+                    continue;
             }
 
-            if (m_parser->finished())
-            {
-                const auto& frame = m_parser->frame();
+            // A parser which is replaced meanwhile is retired, so the frame stays valid
+            const auto& frame = parser->frame();
 
-                spdlog::debug("Received and parsed message with address {} function {} and data size {}",
-                    frame.address, frame.function, frame.data.size());
+            spdlog::debug("Received and parsed message with address {} function {} and data size {}",
+                frame.address, frame.function, frame.data.size());
 
-                if (auto error = m_subscriber->processReceivedData(frame.address, frame.function, frame.data); error && error != ZenError_BufferTooSmall)
-                {
-                    spdlog::error("Failed to process message with address {} function {} data {}. Error: {}",
-                        frame.address, frame.function, util::spanToString(frame.data), fmt::underlying(error));
-                }
-                m_parser->reset();
+            if (auto error = m_subscriber->processReceivedData(frame.address, frame.function, frame.data, receivedTimestampNs); error && error != ZenError_BufferTooSmall)
+            {
+                spdlog::error("Failed to process message with address {} function {} data {}. Error: {}",
+                    frame.address, frame.function, util::spanToString(frame.data), fmt::underlying(error));
             }
+            parser->reset();
         }
 
         return ZenError_None;
     }
+
+    ZenFrameStatistics ModbusCommunicator::frameStatistics() const noexcept
+    {
+        ZenFrameStatistics result;
+        result.checksumErrors = m_checksumErrors.load(std::memory_order_relaxed);
+        result.framingErrors = m_framingErrors.load(std::memory_order_relaxed);
+        result.bytesDiscarded = m_bytesDiscarded.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void ModbusCommunicator::publishStatistics(const modbus::FrameParseStatistics& statistics) noexcept
+    {
+        m_checksumErrors.store(statistics.checksumErrors, std::memory_order_relaxed);
+        m_framingErrors.store(statistics.framingErrors, std::memory_order_relaxed);
+        m_bytesDiscarded.store(statistics.bytesDiscarded, std::memory_order_relaxed);
+    }
 }
\ No newline at end of file
@@ -32,7 +32,11 @@ namespace zen
 
         void init(std::unique_ptr<IIoInterface> ioInterface) noexcept;
 
-        virtual ZenError send(uint8_t address, uint16_t function, gsl::span<const std::byte> data) noexcept;
+        /** Queues a frame to be sent and returns without waiting for its transmission. The completion
+         * is called with the result of the transmission, if the frame was queued.
+         */
+        virtual ZenError send(uint8_t address, uint16_t function, gsl::span<const std::byte> data,
+            IIoInterface::SendCompletion completion = nullptr) noexcept;
 
         /** Returns whether the IO interface equals the sensor description */
         bool equals(const ZenSensorDesc& desc) const noexcept { return m_ioInterface->equals(desc); }
@@ -44,12 +48,18 @@ namespace zen
         virtual ZenError setBaudRate(unsigned int rate) noexcept { return m_ioInterface->setBaudRate(rate); }
 
         /** Returns the supported baudrates of the IO interface (bit/s) */
-        nonstd::expected<std::vector<int32_t>, ZenError> supportedBaudRates() const noexcept {
+        virtual nonstd::expected<std::vector<int32_t>, ZenError> supportedBaudRates() const noexcept {
            return m_ioInterface->supportedBaudRates(); }
 
         /** Returns the type of IO interface */
         std::string_view ioType() const noexcept { return m_ioInterface->type(); }
 
+        /** Returns statistics of the reads from the IO interface */
+        nonstd::expected<ZenIoStatistics, ZenError> ioStatistics() const noexcept { return m_ioInterface->ioStatistics(); }
+
+        /** Returns the errors of the received data stream */
+        ZenFrameStatistics frameStatistics() const noexcept;
+
         void setSubscriber(IModbusFrameSubscriber& subscriber) noexcept { m_subscriber = &subscriber; }
         void setFrameFactory(std::unique_ptr<modbus::IFrameFactory> factory) noexcept { m_factory = std::move(factory); }
         void setFrameParser(std::unique_ptr<modbus::IFrameParser> parser) noexcept
@@ -57,6 +67,8 @@ namespace zen
             // The frame parser is only set once - on initialisation of a new sensor. We have chosen to
             // use a spinlock, as it will be virtually cost-free (no system calls) in all other use cases.
             while (m_parserBusy.test_and_set(std::memory_order_acquire)) { /* Spin lock */; }
+            parser->setStatistics(m_parser->statistics());
+            m_retiredParser = std::move(m_parser);
             m_parser = std::move(parser);
             m_parserBusy.clear(std::memory_order_release);
         }
@@ -71,23 +83,36 @@ namespace zen
         IModbusFrameSubscriber* m_subscriber;
 
     private:
-        ZenError processData(gsl::span<const std::byte> data) noexcept override;
+        ZenError processData(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept override;
+
+        /** Copies the statistics of the parser, so they are read without taking the parser */
+        void publishStatistics(const modbus::FrameParseStatistics& statistics) noexcept;
 
         std::unique_ptr<modbus::IFrameFactory> m_factory;
 
-        /** Access to the parser is only allowed if the m_parserBusy flag is true, because the
+        /** Taking the parser is only allowed if the m_parserBusy flag is true, because the
             parser object might be replaced after the connection to the sensor is established.
          */
         std::unique_ptr<modbus::IFrameParser> m_parser;
         std::atomic_flag m_parserBusy = ATOMIC_FLAG_INIT;
+
+        // The frame of the previous parser may still be processed when it is replaced
+        std::unique_ptr<modbus::IFrameParser> m_retiredParser;
+
+        std::atomic_uint64_t m_checksumErrors{ 0 };
+        std::atomic_uint64_t m_framingErrors{ 0 };
+        std::atomic_uint64_t m_bytesDiscarded{ 0 };
         std::unique_ptr<IIoInterface> m_ioInterface;
     };
 
     class IModbusFrameSubscriber
     {
     public:
+        /** Process a parsed frame
+         * \param receivedTimestampNs Host time at which the read completed that finished the frame
+         */
         virtual ZenError processReceivedData(uint8_t address, uint16_t function,
-          gsl::span<const std::byte> data) noexcept = 0;
+          gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept = 0;
     };
 }
 
@@ -20,8 +20,18 @@ namespace zen
         , m_waiting ATOMIC_FLAG_INIT
         , m_publishing ATOMIC_FLAG_INIT
         , m_resultError(ZenError_None)
+        , m_sendId(0)
+        , m_unansweredAcks(0)
+        , m_acksBeforeWaiter(0)
+        , m_ackWaiter(false)
     {}
 
+    SyncedModbusCommunicator::~SyncedModbusCommunicator() noexcept
+    {
+        // The IO interface fails its remaining sends, their completions still publish to this
+        m_communicator.reset();
+    }
+
     ZenError SyncedModbusCommunicator::sendAndWaitForAck(uint8_t address, uint16_t function, ZenProperty_t property,
         gsl::span<const std::byte> data) noexcept
     {
@@ -30,17 +40,60 @@ namespace zen
         }
 
         auto guard = finally([this]() {
+            {
+                std::lock_guard<std::recursive_mutex> lock(m_ackMutex);
+                m_ackWaiter = false;
+            }
             m_waiting.clear();
         });
-        if (auto error = m_communicator->send(address, function, data))
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_ackMutex);
+            m_acksBeforeWaiter = m_unansweredAcks;
+            m_ackWaiter = true;
+            if (auto error = sendWaitedFor(address, function, data))
+                return error;
+        }
+
+        const auto error = terminateWaitOnPublishOrTimeout();
+        if (error == ZenError_Io_Timeout) {
+            // the acknowledgements which did not arrive before the one of the request are lost
+            std::lock_guard<std::recursive_mutex> lock(m_ackMutex);
+            m_unansweredAcks -= m_acksBeforeWaiter;
+            m_acksBeforeWaiter = 0;
+        }
+        return error;
+    }
+
+    ZenError SyncedModbusCommunicator::sendAndIgnoreAck(uint8_t address, uint16_t function,
+        gsl::span<const std::byte> data, IIoInterface::SendCompletion completion) noexcept
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_ackMutex);
+        auto error = m_communicator->send(address, function, data,
+            [this, completion = std::move(completion)](ZenError error) {
+                if (error) {
+                    // a frame which was not sent is not acknowledged
+                    std::lock_guard<std::recursive_mutex> lock(m_ackMutex);
+                    if (m_unansweredAcks > 0)
+                        --m_unansweredAcks;
+                    if (m_ackWaiter && m_acksBeforeWaiter > 0)
+                        --m_acksBeforeWaiter;
+                }
+
+                if (completion)
+                    completion(error);
+            });
+        if (error)
             return error;
-        return terminateWaitOnPublishOrTimeout();
+
+        ++m_unansweredAcks;
+        return ZenError_None;
     }
 
     ZenError SyncedModbusCommunicator::sendAndDontWait(uint8_t address, uint16_t function, ZenProperty_t,
-        gsl::span<const std::byte> data) noexcept
+        gsl::span<const std::byte> data, IIoInterface::SendCompletion completion) noexcept
     {
-        if (auto error = m_communicator->send(address, function, data))
+        if (auto error = m_communicator->send(address, function, data, std::move(completion)))
             return error;
 
         return ZenError_None;
@@ -61,7 +114,7 @@ namespace zen
             m_waiting.clear();
         });
 
-        if (auto error = m_communicator->send(address, function, data))
+        if (auto error = sendWaitedFor(address, function, data))
             return std::make_pair(error, m_resultSize);
 
         if (auto error = terminateWaitOnPublishOrTimeout())
@@ -85,7 +138,7 @@ namespace zen
             m_waiting.clear();
         });
 
-        if (auto error = m_communicator->send(address, function, data))
+        if (auto error = sendWaitedFor(address, function, data))
             return nonstd::make_unexpected(error);
 
         if (auto error = terminateWaitOnPublishOrTimeout())
@@ -96,6 +149,19 @@ namespace zen
 
     ZenError SyncedModbusCommunicator::publishAck(ZenProperty_t property, ZenError error) noexcept
     {
+        {
+            std::lock_guard<std::recursive_mutex> lock(m_ackMutex);
+            if (m_ackWaiter ? m_acksBeforeWaiter > 0 : m_unansweredAcks > 0) {
+                if (m_ackWaiter)
+                    --m_acksBeforeWaiter;
+                --m_unansweredAcks;
+                return ZenError_None;
+            }
+
+            // the following acknowledgements are not the waiter's anymore
+            m_ackWaiter = false;
+        }
+
         if (!prepareForPublishing())
             return ZenError_None;
 
@@ -176,6 +242,33 @@ namespace zen
         return ZenError_None;
     }
 
+    ZenError SyncedModbusCommunicator::sendWaitedFor(uint8_t address, uint16_t function,
+        gsl::span<const std::byte> data) noexcept
+    {
+        const auto sendId = ++m_sendId;
+        return m_communicator->send(address, function, data, [this, sendId](ZenError error) {
+            if (error)
+                publishSendError(sendId, error);
+        });
+    }
+
+    void SyncedModbusCommunicator::publishSendError(uint32_t sendId, ZenError error) noexcept
+    {
+        if (!prepareForPublishing())
+            return;
+
+        auto guard = finally([this]() {
+            m_publishing.clear();
+        });
+
+        // the waiter of the request may have timed out already
+        if (sendId != m_sendId)
+            return;
+
+        m_resultError = error;
+        m_fence.terminate();
+    }
+
     ZenError SyncedModbusCommunicator::terminateWaitOnPublishOrTimeout() noexcept
     {
         constexpr static auto IO_TIMEOUT = std::chrono::milliseconds(2500);
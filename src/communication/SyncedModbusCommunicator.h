@@ -13,6 +13,7 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <gsl/span>
@@ -28,6 +29,7 @@ namespace zen
     {
     public:
         SyncedModbusCommunicator(std::unique_ptr<ModbusCommunicator> communicator) noexcept;
+        ~SyncedModbusCommunicator() noexcept;
 
         /** Close the IO interface. It is no longer usable after this point! */
         void close() { m_communicator.reset(); }
@@ -47,11 +49,23 @@ namespace zen
         /** Returns whether the IO interface equals the sensor description */
         bool equals(const ZenSensorDesc& desc) const noexcept { return m_communicator->equals(desc); }
 
+        /** Returns statistics of the reads from the IO interface */
+        nonstd::expected<ZenIoStatistics, ZenError> ioStatistics() const noexcept { return m_communicator->ioStatistics(); }
+
+        /** Returns the errors of the received data stream */
+        ZenFrameStatistics frameStatistics() const noexcept { return m_communicator->frameStatistics(); }
+
         /** Sends data to the IO interface, and waits for an acknowledgment */
         ZenError sendAndWaitForAck(uint8_t address, uint16_t function, ZenProperty_t property, gsl::span<const std::byte> data) noexcept;
 
+        /** Queues data to be sent to the IO interface, without waiting for its transmission or an acknowledgment */
         ZenError sendAndDontWait(uint8_t address, uint16_t function, ZenProperty_t property,
-            gsl::span<const std::byte> data) noexcept;
+            gsl::span<const std::byte> data, IIoInterface::SendCompletion completion = nullptr) noexcept;
+
+        /** Queues data which the sensor acknowledges, without waiting for it. Its acknowledgement is dropped
+            instead of being taken as the one of a request waiting in sendAndWaitForAck. */
+        ZenError sendAndIgnoreAck(uint8_t address, uint16_t function, gsl::span<const std::byte> data,
+            IIoInterface::SendCompletion completion = nullptr) noexcept;
 
         /** Sends data to the IO interface, and waits for a result array.  Returns the number of bytes.  */
         template <typename T>
@@ -73,6 +87,12 @@ namespace zen
         ZenError publishResult(ZenProperty_t property, ZenError error, T result) noexcept;
 
     private:
+        /** Sends the request of the waiter, a failed transmission terminates its wait */
+        ZenError sendWaitedFor(uint8_t address, uint16_t function, gsl::span<const std::byte> data) noexcept;
+
+        /** Publish the failed transmission of a waiter's request */
+        void publishSendError(uint32_t sendId, ZenError error) noexcept;
+
         /** Wait until a response has been published from the IO interface, or timeout. */
         ZenError terminateWaitOnPublishOrTimeout() noexcept;
 
@@ -97,6 +117,17 @@ namespace zen
 
         void* m_resultPtr;
         size_t m_resultSize;
+
+        // Identifies the waiter's request in its send completion
+        std::atomic_uint32_t m_sendId;
+
+        // Acknowledgements arrive in the order of the frames, the ones of sendAndIgnoreAck which were
+        // queued before the request of a waiter in sendAndWaitForAck are dropped first. The mutex is
+        // recursive, as a failing send may call its completion before returning.
+        std::recursive_mutex m_ackMutex;
+        size_t m_unansweredAcks;
+        size_t m_acksBeforeWaiter;
+        bool m_ackWaiter;
     };
 }
 
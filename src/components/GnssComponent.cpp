@@ -12,6 +12,7 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <cstring>
 #include <string>
 #include <spdlog/spdlog.h>
 
@@ -23,9 +24,86 @@
 
 namespace zen
 {
+    namespace
+    {
+        struct GnssOutput
+        {
+            ZenProperty_t property;
+            uint8_t size;
+            // Whether the value is stored in ZenGnssData, the others are skipped
+            bool kept;
+        };
+
+        // All outputs in the order of the sample, after the 32-bit timestamp
+        constexpr GnssOutput c_gnssOutputs[] = {
+            { ZenGnssProperty_OutputNavPvtiTOW, 4, false },
+            { ZenGnssProperty_OutputNavPvtYear, 2, true },
+            { ZenGnssProperty_OutputNavPvtMonth, 1, true },
+            { ZenGnssProperty_OutputNavPvtDay, 1, true },
+            { ZenGnssProperty_OutputNavPvtHour, 1, true },
+            { ZenGnssProperty_OutputNavPvtMinute, 1, true },
+            { ZenGnssProperty_OutputNavPvtSecond, 1, true },
+            { ZenGnssProperty_OutputNavPvtValid, 1, false },
+            { ZenGnssProperty_OutputNavPvttAcc, 4, false },
+            { ZenGnssProperty_OutputNavPvtNano, 4, true },
+            { ZenGnssProperty_OutputNavPvtFixType, 1, true },
+            { ZenGnssProperty_OutputNavPvtFlags, 1, true },
+            { ZenGnssProperty_OutputNavPvtFlags2, 1, false },
+            { ZenGnssProperty_OutputNavPvtNumSV, 1, true },
+            { ZenGnssProperty_OutputNavPvtLongitude, 4, true },
+            { ZenGnssProperty_OutputNavPvtLatitude, 4, true },
+            { ZenGnssProperty_OutputNavPvtHeight, 4, true },
+            { ZenGnssProperty_OutputNavPvthMSL, 4, false },
+            { ZenGnssProperty_OutputNavPvthAcc, 4, true },
+            { ZenGnssProperty_OutputNavPvtvAcc, 4, true },
+            { ZenGnssProperty_OutputNavPvtVelN, 4, false },
+            { ZenGnssProperty_OutputNavPvtVelE, 4, false },
+            { ZenGnssProperty_OutputNavPvtVelD, 4, false },
+            { ZenGnssProperty_OutputNavPvtgSpeed, 4, true },
+            { ZenGnssProperty_OutputNavPvtHeadMot, 4, true },
+            { ZenGnssProperty_OutputNavPvtsAcc, 4, true },
+            { ZenGnssProperty_OutputNavPvtHeadAcc, 4, true },
+            { ZenGnssProperty_OutputNavPvtpDOP, 2, false },
+            { ZenGnssProperty_OutputNavPvtHeadVeh, 4, true },
+            { ZenGnssProperty_OutputNavAttiTOW, 4, false },
+            { ZenGnssProperty_OutputNavAttVersion, 1, false },
+            { ZenGnssProperty_OutputNavAttRoll, 4, false },
+            { ZenGnssProperty_OutputNavAttPitch, 4, false },
+            { ZenGnssProperty_OutputNavAttHeading, 4, false },
+            { ZenGnssProperty_OutputNavAttAccRoll, 4, false },
+            { ZenGnssProperty_OutputNavAttAccPitch, 4, false },
+            { ZenGnssProperty_OutputNavAttAccHeading, 4, false },
+            { ZenGnssProperty_OutputEsfStatusiTOW, 4, false },
+            { ZenGnssProperty_OutputEsfStatusVersion, 1, false },
+            { ZenGnssProperty_OutputEsfStatusInitStatus1, 1, false },
+            { ZenGnssProperty_OutputEsfStatusInitStatus2, 1, false },
+            { ZenGnssProperty_OutputEsfStatusFusionMode, 1, false },
+            { ZenGnssProperty_OutputEsfStatusNumSens, 1, false },
+        };
+
+        template <class T>
+        T readScalar(const std::byte* source) noexcept
+        {
+            T value;
+            std::memcpy(&value, source, sizeof(value));
+            return value;
+        }
+
+        template <class T>
+        void readScalar(const std::byte* source, T& target) noexcept
+        {
+            std::memcpy(&target, source, sizeof(target));
+        }
+    }
+
     GnssComponent::GnssComponent(std::unique_ptr<ISensorProperties> properties, SyncedModbusCommunicator& com, unsigned int) noexcept
         : SensorComponent(std::move(properties)), m_communicator(com)
-    {}
+        , m_decodeSize(0)
+        , m_decodeTableOutdated(true)
+    {
+        for (const auto& output : c_gnssOutputs)
+            m_properties->subscribeToPropertyChanges(output.property, [this](SensorPropertyValue) { m_decodeTableOutdated = true; });
+    }
 
     ZenSensorInitError GnssComponent::init() noexcept
     {
@@ -77,11 +155,7 @@ namespace zen
             m_rtcm3network->addFrameCallback([&](uint16_t messageType, std::vector<std::byte> const& frame) {
                 spdlog::info("RTCM3 message type {0} size {1} of size received", messageType, frame.size());
 
-                if (ZenError_None != m_communicator.sendAndWaitForAck(0, uint8_t(EDevicePropertyV1::SetRtkCorrection),
-                    ZenProperty_t(EDevicePropertyV1::SetRtkCorrection), frame))
-                {
-                    spdlog::error("Could not send RTK correction to sensor");
-                }
+                sendRtkCorrection(frame);
             });
 
             spdlog::info("Connecting to host {0}:{1} for RTK corrections", hostname, port);
@@ -93,11 +167,7 @@ namespace zen
                 m_rtcm3serial->addFrameCallback([&](uint16_t messageType, std::vector<std::byte> const& frame) {
                 spdlog::info("RTCM3 message type {0} size {1} of size received", messageType, frame.size());
 
-                if (ZenError_None != m_communicator.sendAndWaitForAck(0, uint8_t(EDevicePropertyV1::SetRtkCorrection),
-                    ZenProperty_t(EDevicePropertyV1::SetRtkCorrection), frame))
-                {
-                    spdlog::error("Could not send RTK correction to sensor");
-                }
+                sendRtkCorrection(frame);
             });
 
             spdlog::info("Connecting to serial {0}:{1} for RTK corrections", hostname, port);
@@ -110,6 +180,20 @@ namespace zen
         return ZenError::ZenError_InvalidArgument;
     }
 
+    void GnssComponent::sendRtkCorrection(std::vector<std::byte> const& frame) noexcept {
+        // Corrections are queued without waiting for the transmission and the acknowledgement,
+        // so neither the correction source nor property requests are stalled. Their acknowledgements
+        // are dropped, so they are not taken as the ones of property requests.
+        const auto error = m_communicator.sendAndIgnoreAck(0, uint8_t(EDevicePropertyV1::SetRtkCorrection),
+            frame, [](ZenError error) {
+                if (error)
+                    spdlog::error("Could not send RTK correction to sensor. Error: {}", fmt::underlying(error));
+            });
+
+        if (error)
+            spdlog::error("Could not queue RTK correction for sensor. Error: {}", fmt::underlying(error));
+    }
+
     ZenError GnssComponent::stopRtkCorrections() noexcept {
         if (m_rtcm3network) {
             m_rtcm3network->stop();
@@ -125,172 +209,123 @@ namespace zen
 
     nonstd::expected<ZenEventData, ZenError> GnssComponent::parseSensorData(gsl::span<const std::byte> data) const noexcept
     {
-        ZenEventData eventData;
-        ZenGnssData& gnssData = eventData.gnssData;
-        gnssDataReset(gnssData);
+        if (m_decodeTableOutdated.exchange(false))
+        {
+            if (auto error = compileDecodeTable())
+            {
+                m_decodeTableOutdated = true;
+                return nonstd::make_unexpected(error);
+            }
+        }
 
         // check consistency of data package size
-        if (data.size() < (ptrdiff_t)sizeof(uint32_t)) {
-            spdlog::error("GPS data package size {0} too small, should at least contain the timestamp", data.size());
+        if (data.size() < m_decodeSize) {
+            spdlog::error("GPS data package size {0} too small, the output settings require {1} bytes", data.size(), m_decodeSize);
             return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
         }
 
-        sensor_parsing_util::parseAndStoreScalar(data, &gnssData.frameCount);
-        gnssData.timestamp = double(gnssData.frameCount) * 0.002;
-
-        // most of the read out data are not transferred to the OpenZen data structure. Still we need to parse
-        // the data buffer to end up at the right positions to read out the values we want.
-        int32_t int32_not_used;
-        uint32_t uint32_not_used;
-        uint16_t uint16_not_used;
-        uint8_t uint8_not_used;
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtiTOW),
-            m_properties, data, &uint32_not_used);
-
-        // date and time information
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtYear),
-            m_properties, data, &gnssData.year);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtMonth),
-            m_properties, data, &gnssData.month);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtDay),
-            m_properties, data, &gnssData.day);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtHour),
-            m_properties, data, &gnssData.hour);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtMinute),
-            m_properties, data, &gnssData.minute);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtSecond),
-            m_properties, data, &gnssData.second);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtValid),
-            m_properties, data, &uint8_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvttAcc),
-            m_properties, data, &uint32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtNano),
-            m_properties, data, &gnssData.nanoSecondCorrection);
-
-        uint8_t fixType = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtFixType),
-            m_properties, data, &fixType)) {
-            eventData.gnssData.fixType = ZenGnssFixType(fixType);
-        }
-
-        uint8_t navFlags = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtFlags),
-            m_properties, data, &navFlags)) {
-            // carrier phase solution in bit 7 and 8
-            eventData.gnssData.carrierPhaseSolution = ZenGnssFixCarrierPhaseSolution( navFlags >> 6 );
-        }
-
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtFlags2),
-            m_properties, data, &uint8_not_used);
-
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtNumSV),
-            m_properties, data, &gnssData.numberSatellitesUsed);
+        ZenEventData eventData;
+        ZenGnssData& gnssData = eventData.gnssData;
+        gnssDataReset(gnssData);
 
-        int32_t longitude = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtLongitude),
-            m_properties, data, &longitude)) {
-            gnssData.longitude = sensor_parsing_util::integerToScaledDouble(longitude, -7);
-        }
+        readScalar(data.data(), gnssData.frameCount);
+        gnssData.timestamp = double(gnssData.frameCount) * 0.002;
 
-        int32_t latitude = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtLatitude),
-            m_properties, data, &latitude))
+        // most of the outputs are not transferred to the OpenZen data structure, the table only
+        // contains the ones we want
+        for (const auto& field : m_decodeFields)
         {
-            gnssData.latitude = sensor_parsing_util::integerToScaledDouble(latitude, -7);
-        }
-
-        int32_t height = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtHeight),
-            m_properties, data, &height)) {
-            gnssData.height = sensor_parsing_util::integerToScaledDouble(height, -3);
-        }
-
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvthMSL),
-            m_properties, data, &int32_not_used );
-
-        uint32_t horizontalAccuracy = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvthAcc),
-            m_properties, data, &horizontalAccuracy)) {
-            gnssData.horizontalAccuracy = sensor_parsing_util::integerToScaledDouble(horizontalAccuracy, -3);
-        }
-        
-        uint32_t verticalAccuracy = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtvAcc),
-            m_properties, data, &verticalAccuracy)) {
-            gnssData.verticalAccuracy = sensor_parsing_util::integerToScaledDouble(verticalAccuracy, -3);
+            const std::byte* source = data.data() + field.offset;
+            switch (field.property)
+            {
+            // date and time information
+            case ZenGnssProperty_OutputNavPvtYear:
+                readScalar(source, gnssData.year);
+                break;
+            case ZenGnssProperty_OutputNavPvtMonth:
+                readScalar(source, gnssData.month);
+                break;
+            case ZenGnssProperty_OutputNavPvtDay:
+                readScalar(source, gnssData.day);
+                break;
+            case ZenGnssProperty_OutputNavPvtHour:
+                readScalar(source, gnssData.hour);
+                break;
+            case ZenGnssProperty_OutputNavPvtMinute:
+                readScalar(source, gnssData.minute);
+                break;
+            case ZenGnssProperty_OutputNavPvtSecond:
+                readScalar(source, gnssData.second);
+                break;
+            case ZenGnssProperty_OutputNavPvtNano:
+                readScalar(source, gnssData.nanoSecondCorrection);
+                break;
+            case ZenGnssProperty_OutputNavPvtFixType:
+                gnssData.fixType = ZenGnssFixType(readScalar<uint8_t>(source));
+                break;
+            case ZenGnssProperty_OutputNavPvtFlags:
+                // carrier phase solution in bit 7 and 8
+                gnssData.carrierPhaseSolution = ZenGnssFixCarrierPhaseSolution(readScalar<uint8_t>(source) >> 6);
+                break;
+            case ZenGnssProperty_OutputNavPvtNumSV:
+                readScalar(source, gnssData.numberSatellitesUsed);
+                break;
+            case ZenGnssProperty_OutputNavPvtLongitude:
+                gnssData.longitude = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -7);
+                break;
+            case ZenGnssProperty_OutputNavPvtLatitude:
+                gnssData.latitude = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -7);
+                break;
+            case ZenGnssProperty_OutputNavPvtHeight:
+                gnssData.height = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -3);
+                break;
+            case ZenGnssProperty_OutputNavPvthAcc:
+                gnssData.horizontalAccuracy = sensor_parsing_util::integerToScaledDouble(readScalar<uint32_t>(source), -3);
+                break;
+            case ZenGnssProperty_OutputNavPvtvAcc:
+                gnssData.verticalAccuracy = sensor_parsing_util::integerToScaledDouble(readScalar<uint32_t>(source), -3);
+                break;
+            case ZenGnssProperty_OutputNavPvtgSpeed:
+                gnssData.velocity = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -3);
+                break;
+            case ZenGnssProperty_OutputNavPvtHeadMot:
+                gnssData.headingOfMotion = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -5);
+                break;
+            case ZenGnssProperty_OutputNavPvtsAcc:
+                gnssData.velocityAccuracy = sensor_parsing_util::integerToScaledDouble(readScalar<uint32_t>(source), -3);
+                break;
+            case ZenGnssProperty_OutputNavPvtHeadAcc:
+                gnssData.headingAccuracy = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -5);
+                break;
+            case ZenGnssProperty_OutputNavPvtHeadVeh:
+                gnssData.headingOfVehicle = sensor_parsing_util::integerToScaledDouble(readScalar<int32_t>(source), -5);
+                break;
+            default:
+                break;
+            }
         }
 
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtVelN),
-            m_properties, data, &int32_not_used );
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtVelE),
-            m_properties, data, &int32_not_used );
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtVelD),
-            m_properties, data, &int32_not_used );
-
-        int32_t velocity = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtgSpeed),
-            m_properties, data, &velocity)) {
-            gnssData.velocity = sensor_parsing_util::integerToScaledDouble(velocity, -3);
-        }
-
-        int32_t headingOfMotion = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtHeadMot),
-            m_properties, data, &headingOfMotion)) {
-            gnssData.headingOfMotion = sensor_parsing_util::integerToScaledDouble(headingOfMotion, -5);
-        }
+        return eventData;
+    }
 
-        uint32_t velocityAccuracy = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtsAcc),
-            m_properties, data, &velocityAccuracy)) {
-            gnssData.velocityAccuracy = sensor_parsing_util::integerToScaledDouble(velocityAccuracy, -3);
-        }
+    ZenError GnssComponent::compileDecodeTable() const noexcept
+    {
+        m_decodeFields.clear();
+        m_decodeSize = sizeof(uint32_t);
+        for (const auto& output : c_gnssOutputs)
+        {
+            const auto enabled = m_properties->getBool(output.property);
+            if (!enabled)
+                return enabled.error();
 
-        int32_t headingAcc = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtHeadAcc),
-            m_properties, data, &headingAcc)) {
-            gnssData.headingAccuracy = sensor_parsing_util::integerToScaledDouble(headingAcc, -5);
-        }
+            if (!*enabled)
+                continue;
 
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtpDOP),
-            m_properties, data, &uint16_not_used);
-        
-        int32_t headingOfVehicle = 0;
-        if (sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavPvtHeadVeh),
-            m_properties, data, &headingOfVehicle)) {
-            gnssData.headingOfVehicle = sensor_parsing_util::integerToScaledDouble(headingOfVehicle, -5);
+            if (output.kept)
+                m_decodeFields.push_back({ static_cast<uint16_t>(m_decodeSize), output.property });
+            m_decodeSize += output.size;
         }
 
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttiTOW),
-            m_properties, data, &uint32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttVersion),
-            m_properties, data, &uint8_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttRoll),
-            m_properties, data, &int32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttPitch),
-            m_properties, data, &int32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttHeading),
-            m_properties, data, &int32_not_used);
-
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttAccRoll),
-            m_properties, data, &uint32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttAccPitch),
-            m_properties, data, &uint32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputNavAttAccHeading),
-            m_properties, data, &uint32_not_used);
-
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputEsfStatusiTOW),
-            m_properties, data, &uint32_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputEsfStatusVersion),
-            m_properties, data, &uint8_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputEsfStatusInitStatus1),
-            m_properties, data, &uint8_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputEsfStatusInitStatus2),
-            m_properties, data, &uint8_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputEsfStatusFusionMode),
-            m_properties, data, &uint8_not_used);
-        sensor_parsing_util::readScalarIfAvailable(static_cast<ZenProperty_t>(ZenGnssProperty_OutputEsfStatusNumSens),
-            m_properties, data, &uint8_not_used);
-
-        return eventData;
+        return ZenError_None;
     }
 }
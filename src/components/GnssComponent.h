@@ -15,6 +15,7 @@
 #include <chrono>
 #include <optional>
 #include <memory>
+#include <vector>
 
 #include "utility/gnss/RTCM3NetworkSource.h"
 #include "utility/gnss/RTCM3SerialSource.h"
@@ -81,10 +82,30 @@ namespace zen
         a cold start and it takes > 30 minutes to get a good fix.
         */
         ZenError storeGnssState() noexcept;
+
+        /** Queues an RTCM3 frame to be forwarded to the sensor */
+        void sendRtkCorrection(std::vector<std::byte> const& frame) noexcept;
         nonstd::expected<ZenEventData, ZenError> parseSensorData(gsl::span<const std::byte> data) const noexcept;
+
+        /** Computes the offsets of the fields OpenZen keeps from the output bitset */
+        ZenError compileDecodeTable() const noexcept;
+
         SyncedModbusCommunicator & m_communicator;
         std::unique_ptr<RTCM3NetworkSource> m_rtcm3network;
         std::unique_ptr<RTCM3SerialSource> m_rtcm3serial;
+
+        struct DecodeField
+        {
+            // Byte offset in the sample
+            uint16_t offset;
+            // Output property of the field
+            ZenProperty_t property;
+        };
+
+        // Field offsets of the current GNSS output flags, rebuilt by the parsing thread after they changed
+        mutable std::vector<DecodeField> m_decodeFields;
+        mutable size_t m_decodeSize;
+        mutable std::atomic_bool m_decodeTableOutdated;
     };
 }
 #endif
@@ -12,26 +12,32 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <cstddef>
+#include <cstring>
 #include <string>
 
 #include "SensorManager.h"
 #include "ZenTypesHelpers.h"
 #include "properties/ImuSensorPropertiesV0.h"
-#include "components/SensorParsingUtil.h"
 
 #include <spdlog/spdlog.h>
 
 namespace zen
 {
-    using sensor_parsing_util::parseFloat16;
-    using sensor_parsing_util::parseFloat32;
-
     ImuComponent::ImuComponent(std::unique_ptr<ISensorProperties> properties, SyncedModbusCommunicator& communicator, unsigned int version) noexcept
         : SensorComponent(std::move(properties))
         , m_cache{}
         , m_communicator(communicator)
         , m_version(version)
-    {}
+        , m_decode{}
+        , m_decodePlanOutdated(true)
+    {
+        for (auto property : { ZenImuProperty_SamplingRate, ZenImuProperty_OutputLowPrecision, ZenImuProperty_OutputRawGyr,
+            ZenImuProperty_OutputRawAcc, ZenImuProperty_OutputRawMag, ZenImuProperty_OutputAngularVel, ZenImuProperty_OutputQuat,
+            ZenImuProperty_OutputEuler, ZenImuProperty_OutputLinearAcc, ZenImuProperty_OutputPressure, ZenImuProperty_OutputAltitude,
+            ZenImuProperty_OutputTemperature, ZenImuProperty_OutputHeaveMotion })
+            m_properties->subscribeToPropertyChanges(property, [this](SensorPropertyValue) { m_decodePlanOutdated = true; });
+    }
 
     ZenSensorInitError ImuComponent::init() noexcept
     {
@@ -185,268 +191,139 @@ namespace zen
 
     nonstd::expected<ZenEventData, ZenError> ImuComponent::parseSensorData(gsl::span<const std::byte> data) const noexcept
     {
-        // Any properties that are retrieved here should be cached locally, because it
-        // will take too much time to retrieve from the sensor!
-        ZenEventData eventData;
-        ZenImuData& imuData = eventData.imuData;
-        imuDataReset(imuData);
-
-        const auto begin = data.begin();
-
-        const auto size = data.size();
-        if ((long unsigned int)std::distance(begin, data.begin() + sizeof(uint32_t)) > size)
-            return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);;
-
-        sensor_parsing_util::parseAndStoreScalar(data, &imuData.frameCount);
-
-        double timestampMultiplier = 0.0;
-        if (const auto samplingRate = m_properties->getInt32(ZenImuProperty_SamplingRate)){
-            // When the VR firmware runs with 800 Hz, it also runs with an internal
-            // frequency of 800 Hz which means we need to multiply wtih 0.00125 to comput the
-            // correct timestamp.
-            // therefore, this value is set depending on the IMU variant.
-            timestampMultiplier = samplingRate.value() > 400 ? 0.00125 : 0.0025;
-        } else {
-            spdlog::error("Cannot query sampling rate to comput timestamp");
-            return nonstd::make_unexpected(samplingRate.error());;
-        }
-
-        imuData.timestamp = imuData.frameCount * timestampMultiplier;
-
-        if (auto lowPrec = m_properties->getBool(ZenImuProperty_OutputLowPrecision))
+        if (m_decodePlanOutdated.exchange(false))
         {
-            const size_t floatSize = *lowPrec ? sizeof(uint16_t) : sizeof(float);
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputRawGyr))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(3 * floatSize)) {
-                        spdlog::error("Can't parse gyroscope because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 3; ++idx)
-                        imuData.g1Raw[idx] = (180.f / float(M_PI)) * (*lowPrec ? parseFloat16(data, 1000.f) : parseFloat32(data));
-
-                    auto cache = m_cache.borrow();
-
-                    LpVector3f g;
-                    convertArrayToLpVector3f(imuData.g1Raw, &g);
-                    matVectMult3(&cache->gyrAlignMatrix, &g, &g);
-                    vectAdd3x1(&cache->gyrBias, &g, &g);
-                    convertLpVector3fToArray(&g, imuData.g1);
-                }
-            }
-            else
+            if (auto error = compileDecodePlan())
             {
-                return nonstd::make_unexpected(enabled.error());;
+                m_decodePlanOutdated = true;
+                return nonstd::make_unexpected(error);
             }
+        }
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputRawAcc))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(3 * floatSize)) {
-                        spdlog::error("Can't parse acceleration because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 3; ++idx)
-                        imuData.aRaw[idx] = *lowPrec ? parseFloat16(data, 1000.f) : parseFloat32(data);
-
-                    auto cache = m_cache.borrow();
-
-                    LpVector3f a;
-                    convertArrayToLpVector3f(imuData.aRaw, &a);
-                    matVectMult3(&cache->accAlignMatrix, &a, &a);
-                    vectAdd3x1(&cache->accBias, &a, &a);
-                    convertLpVector3fToArray(&a, imuData.a);
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        if (data.size() < m_decode.plan.size())
+        {
+            spdlog::error("Cannot parse IMU sample of {} bytes, the output settings require {} bytes", data.size(), m_decode.plan.size());
+            return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
+        }
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputRawMag))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(3 * floatSize)) {
-                        spdlog::error("Can't parse magnetometer because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 3; ++idx)
-                        imuData.bRaw[idx] = *lowPrec ? parseFloat16(data, 100.f) : parseFloat32(data);
-
-                    auto cache = m_cache.borrow();
-
-                    LpVector3f b;
-                    convertArrayToLpVector3f(imuData.bRaw, &b);
-                    vectSub3x1(&b, &cache->hardIronOffset, &b);
-                    matVectMult3(&cache->softIronMatrix, &b, &b);
-                    convertLpVector3fToArray(&b, imuData.b);
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        ZenEventData eventData;
+        ZenImuData& imuData = eventData.imuData;
+        imuDataReset(imuData);
 
-            // this is the angular velocity which takes into account when an orientation offset was
-            // done
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputAngularVel))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(3 * floatSize)) {
-                        spdlog::error("Can't parse angular velocity because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 3; ++idx)
-                        imuData.w[idx] = (180.f / float(M_PI)) * (*lowPrec ? parseFloat16(data, 1000.f) : parseFloat32(data));
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        std::memcpy(&imuData.frameCount, data.data(), sizeof(imuData.frameCount));
+        imuData.timestamp = imuData.frameCount * m_decode.timestampMultiplier;
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputQuat))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(4 * floatSize)) {
-                        spdlog::error("Can't parse quaternion because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 4; ++idx)
-                        imuData.q[idx] = *lowPrec ? parseFloat16(data, 10000.f) : parseFloat32(data);
-
-                    LpMatrix3x3f m;
-                    LpVector4f q;
-                    convertArrayToLpVector4f(imuData.q, &q);
-                    quaternionToMatrix(&q, &m);
-                    convertLpMatrixToArray(&m, imuData.rotationM);
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        m_decode.plan.decode(data.data(), imuData);
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputEuler))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(3 * floatSize)) {
-                        spdlog::error("Can't parse euler angles because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 3; ++idx)
-                        imuData.r[idx] = (180.f / float(M_PI)) * (*lowPrec ? parseFloat16(data, 10000.f) : parseFloat32(data));
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        if (m_decode.rawGyr || m_decode.rawAcc || m_decode.rawMag)
+        {
+            auto cache = m_cache.borrow();
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputLinearAcc))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)(3 * floatSize)) {
-                        spdlog::error("Can't parse linear acceleration because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    for (unsigned idx = 0; idx < 3; ++idx)
-                        imuData.linAcc[idx] = *lowPrec ? parseFloat16(data, 1000.f) : parseFloat32(data);
-                }
-            }
-            else
+            if (m_decode.rawGyr)
             {
-                return nonstd::make_unexpected(enabled.error());;
+                LpVector3f g;
+                convertArrayToLpVector3f(imuData.g1Raw, &g);
+                matVectMult3(&cache->gyrAlignMatrix, &g, &g);
+                vectAdd3x1(&cache->gyrBias, &g, &g);
+                convertLpVector3fToArray(&g, imuData.g1);
             }
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputPressure))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)floatSize) {
-                        spdlog::error("Can't parse pressure because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    imuData.pressure = *lowPrec ? parseFloat16(data, 100.f) : parseFloat32(data);
-                }
-            }
-            else
+            if (m_decode.rawAcc)
             {
-                return nonstd::make_unexpected(enabled.error());;
+                LpVector3f a;
+                convertArrayToLpVector3f(imuData.aRaw, &a);
+                matVectMult3(&cache->accAlignMatrix, &a, &a);
+                vectAdd3x1(&cache->accBias, &a, &a);
+                convertLpVector3fToArray(&a, imuData.a);
             }
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputAltitude))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)floatSize) {
-                        spdlog::error("Can't parse altitude because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    imuData.altitude = *lowPrec ? parseFloat16(data, 10.f) : parseFloat32(data);
-                }
-            }
-            else
+            if (m_decode.rawMag)
             {
-                return nonstd::make_unexpected(enabled.error());;
+                LpVector3f b;
+                convertArrayToLpVector3f(imuData.bRaw, &b);
+                vectSub3x1(&b, &cache->hardIronOffset, &b);
+                matVectMult3(&cache->softIronMatrix, &b, &b);
+                convertLpVector3fToArray(&b, imuData.b);
             }
+        }
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputTemperature))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)floatSize) {
-                        spdlog::error("Can't parse temperature because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    imuData.temperature = *lowPrec ? parseFloat16(data, 100.f) : parseFloat32(data);
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        if (m_decode.quat)
+        {
+            LpMatrix3x3f m;
+            LpVector4f q;
+            convertArrayToLpVector4f(imuData.q, &q);
+            quaternionToMatrix(&q, &m);
+            convertLpMatrixToArray(&m, imuData.rotationM);
+        }
 
-            if (auto enabled = m_properties->getBool(ZenImuProperty_OutputHeaveMotion))
-            {
-                if (*enabled)
-                {
-                    if (data.size() < (long unsigned int)floatSize) {
-                        spdlog::error("Can't parse heave motion because data entries missing.");
-                        return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-                    }
-
-                    imuData.heaveMotion = *lowPrec ? parseFloat16(data, 1000.f) : parseFloat32(data);
-                }
-            }
-            else
-            {
-                return nonstd::make_unexpected(enabled.error());;
-            }
+        return eventData;
+    }
 
-            return eventData;
+    ZenError ImuComponent::compileDecodePlan() const noexcept
+    {
+        if (const auto samplingRate = m_properties->getInt32(ZenImuProperty_SamplingRate)) {
+            // When the VR firmware runs with 800 Hz, it also runs with an internal
+            // frequency of 800 Hz which means we need to multiply wtih 0.00125 to comput the
+            // correct timestamp.
+            // therefore, this value is set depending on the IMU variant.
+            m_decode.timestampMultiplier = samplingRate.value() > 400 ? 0.00125 : 0.0025;
+        } else {
+            spdlog::error("Cannot query sampling rate to comput timestamp");
+            return samplingRate.error();
         }
-        else
+
+        const auto lowPrec = m_properties->getBool(ZenImuProperty_OutputLowPrecision);
+        if (!lowPrec)
+            return lowPrec.error();
+
+        struct Output
         {
-            return nonstd::make_unexpected(lowPrec.error());
+            ZenProperty_t property;
+            size_t target;
+            uint8_t count;
+            float divisor16Bit;
+            float factor;
+        };
+
+        // Order of the outputs after the 32-bit frame counter
+        const Output outputs[] = {
+            { ZenImuProperty_OutputRawGyr, offsetof(ZenImuData, g1Raw), 3, 1000.f, c_radToDeg },
+            { ZenImuProperty_OutputRawAcc, offsetof(ZenImuData, aRaw), 3, 1000.f, 1.f },
+            { ZenImuProperty_OutputRawMag, offsetof(ZenImuData, bRaw), 3, 100.f, 1.f },
+            // this is the angular velocity which takes into account when an orientation offset was
+            // done
+            { ZenImuProperty_OutputAngularVel, offsetof(ZenImuData, w), 3, 1000.f, c_radToDeg },
+            { ZenImuProperty_OutputQuat, offsetof(ZenImuData, q), 4, 10000.f, 1.f },
+            { ZenImuProperty_OutputEuler, offsetof(ZenImuData, r), 3, 10000.f, c_radToDeg },
+            { ZenImuProperty_OutputLinearAcc, offsetof(ZenImuData, linAcc), 3, 1000.f, 1.f },
+            { ZenImuProperty_OutputPressure, offsetof(ZenImuData, pressure), 1, 100.f, 1.f },
+            { ZenImuProperty_OutputAltitude, offsetof(ZenImuData, altitude), 1, 10.f, 1.f },
+            { ZenImuProperty_OutputTemperature, offsetof(ZenImuData, temperature), 1, 100.f, 1.f },
+            { ZenImuProperty_OutputHeaveMotion, offsetof(ZenImuData, heaveMotion), 1, 1000.f, 1.f },
+        };
+
+        m_decode.plan.reset(sizeof(uint32_t));
+        m_decode.rawGyr = m_decode.rawAcc = m_decode.rawMag = m_decode.quat = false;
+        for (const auto& output : outputs)
+        {
+            const auto enabled = m_properties->getBool(output.property);
+            if (!enabled)
+                return enabled.error();
+
+            if (!*enabled)
+                continue;
+
+            m_decode.plan.add(output.target, output.count, *lowPrec, output.divisor16Bit, output.factor);
+            if (output.property == ZenImuProperty_OutputRawGyr)
+                m_decode.rawGyr = true;
+            else if (output.property == ZenImuProperty_OutputRawAcc)
+                m_decode.rawAcc = true;
+            else if (output.property == ZenImuProperty_OutputRawMag)
+                m_decode.rawMag = true;
+            else if (output.property == ZenImuProperty_OutputQuat)
+                m_decode.quat = true;
         }
+
+        return ZenError_None;
     }
 }
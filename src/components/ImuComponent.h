@@ -13,6 +13,7 @@
 
 #include <atomic>
 
+#include "ImuDecodePlan.h"
 #include "SensorComponent.h"
 #include "communication/SyncedModbusCommunicator.h"
 #include "utility/Ownership.h"
@@ -40,6 +41,9 @@ namespace zen
     private:
         nonstd::expected<ZenEventData, ZenError> parseSensorData(gsl::span<const std::byte> data) const noexcept;
 
+        /** Compiles the output bitset, precision and sampling rate into the decode plan */
+        ZenError compileDecodePlan() const noexcept;
+
         struct IMUState
         {
             LpMatrix3x3f accAlignMatrix;
@@ -54,6 +58,20 @@ namespace zen
         SyncedModbusCommunicator& m_communicator;
         
         const unsigned int m_version;
+
+        // The decode plan with the settings of the legacy format which are compiled along with it
+        struct DecodeState
+        {
+            ImuDecodePlan plan;
+            double timestampMultiplier;
+            // Outputs which the calibrated values and the rotation matrix are computed from
+            bool rawGyr;
+            bool rawAcc;
+            bool rawMag;
+            bool quat;
+        };
+        mutable DecodeState m_decode;
+        mutable std::atomic_bool m_decodePlanOutdated;
     };
 }
 #endif
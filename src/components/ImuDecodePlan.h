@@ -0,0 +1,100 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_COMPONENTS_IMUDECODEPLAN_H_
+#define ZEN_COMPONENTS_IMUDECODEPLAN_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "ZenTypes.h"
+
+namespace zen
+{
+    /**
+    Flat table of the float fields in an IMU sample. It is compiled from the output settings of a
+    sensor when they change, so decoding a sample does not query any property.
+
+    A component owns its plan without locking: property changes only flag it as outdated, and the
+    thread which parses the samples recompiles it before decoding the next one.
+    */
+    class ImuDecodePlan
+    {
+    public:
+        /** Removes all fields, the first field starts at the offset in the sample */
+        void reset(size_t offset) noexcept
+        {
+            m_fields.clear();
+            m_size = offset;
+        }
+
+        /** Appends count floats which are stored in the ZenImuData member at targetOffset.
+         * A 16-bit integer is divided by divisor16Bit, both widths are multiplied by factor afterwards.
+         */
+        void add(size_t targetOffset, uint8_t count, bool lowPrecision, float divisor16Bit, float factor = 1.0f)
+        {
+            const uint8_t width = lowPrecision ? sizeof(int16_t) : sizeof(float);
+            m_fields.push_back({ static_cast<uint16_t>(m_size), static_cast<uint16_t>(targetOffset), count, width,
+                lowPrecision ? divisor16Bit : 1.0f, factor });
+            m_size += count * width;
+        }
+
+        /** Bytes of a sample, including the offset of the first field */
+        size_t size() const noexcept { return m_size; }
+
+        /** Decodes a sample, which has to hold at least size() bytes */
+        void decode(const std::byte* data, ZenImuData& imuData) const noexcept
+        {
+            auto* const target = reinterpret_cast<std::byte*>(&imuData);
+            for (const auto& field : m_fields)
+            {
+                const std::byte* source = data + field.offset;
+                float* values = reinterpret_cast<float*>(target + field.target);
+                if (field.width == sizeof(int16_t))
+                {
+                    for (unsigned idx = 0; idx < field.count; ++idx)
+                    {
+                        int16_t raw;
+                        std::memcpy(&raw, source + idx * sizeof(raw), sizeof(raw));
+                        values[idx] = static_cast<float>(raw) / field.divisor * field.factor;
+                    }
+                }
+                else
+                {
+                    for (unsigned idx = 0; idx < field.count; ++idx)
+                    {
+                        float raw;
+                        std::memcpy(&raw, source + idx * sizeof(raw), sizeof(raw));
+                        values[idx] = raw * field.factor;
+                    }
+                }
+            }
+        }
+
+    private:
+        struct Field
+        {
+            // Byte offsets in the sample and in ZenImuData
+            uint16_t offset;
+            uint16_t target;
+            uint8_t count;
+            uint8_t width;
+            float divisor;
+            float factor;
+        };
+
+        std::vector<Field> m_fields;
+        size_t m_size = 0;
+    };
+}
+
+#endif
@@ -11,13 +11,16 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <cstddef>
+#include <cstring>
 #include <string>
 #include <iostream>
 
+#include <spdlog/spdlog.h>
+
 #include "ZenTypesHelpers.h"
 #include "SensorManager.h"
 #include "properties/ImuSensorPropertiesV0.h"
-#include "components/SensorParsingUtil.h"
 
 namespace zen
 {
@@ -27,7 +30,16 @@ namespace zen
         , m_communicator(communicator)
         , m_hasFirstGyro(hasFirstGyro)
         , m_hasSecondGyro(hasSecondGyro)
-    {}
+        , m_decodePlanOutdated(true)
+    {
+        for (auto property : { ZenImuProperty_DegRadOutput, ZenImuProperty_OutputLowPrecision, ZenImuProperty_OutputRawAcc,
+            ZenImuProperty_OutputAccCalibrated, ZenImuProperty_OutputRawGyr0, ZenImuProperty_OutputRawGyr1,
+            ZenImuProperty_OutputGyr0BiasCalib, ZenImuProperty_OutputGyr1BiasCalib, ZenImuProperty_OutputGyr0AlignCalib,
+            ZenImuProperty_OutputGyr1AlignCalib, ZenImuProperty_OutputRawMag, ZenImuProperty_OutputMagCalib,
+            ZenImuProperty_OutputAngularVel, ZenImuProperty_OutputQuat, ZenImuProperty_OutputEuler, ZenImuProperty_OutputLinearAcc,
+            ZenImuProperty_OutputPressure, ZenImuProperty_OutputAltitude, ZenImuProperty_OutputTemperature })
+            m_properties->subscribeToPropertyChanges(property, [this](SensorPropertyValue) { m_decodePlanOutdated = true; });
+    }
 
     ZenSensorInitError ImuIg1Component::init() noexcept
     {
@@ -86,171 +98,105 @@ namespace zen
 
     nonstd::expected<ZenEventData, ZenError> ImuIg1Component::parseSensorData(gsl::span<const std::byte> data) const noexcept
     {
-        // check SET_LPBUS_DATA_PRECISION how to get the 32/16 bit setting, needs to be cached !
-
-        // Any properties that are retrieved here should be cached locally, because it
-        // will take too much time to retrieve from the sensor!
-
         // Units will always be converted to degrees and degrees/s no matter how the
         // IG1 output is actually configured. OpenZen output unit is always degrees
+        if (m_decodePlanOutdated.exchange(false))
+        {
+            if (auto error = compileDecodePlan())
+            {
+                m_decodePlanOutdated = true;
+                return nonstd::make_unexpected(error);
+            }
+        }
+
+        if (data.size() < m_decodePlan.size())
+        {
+            spdlog::error("Cannot parse IMU sample of {} bytes, the output settings require {} bytes", data.size(), m_decodePlan.size());
+            return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
+        }
 
         ZenEventData eventData;
         ZenImuData& imuData = eventData.imuData;
         imuDataReset(imuData);
 
-        const auto begin = data.begin();
-        const auto size = data.size();
-
-        if ((long unsigned int)std::distance(begin, data.begin() + sizeof(uint32_t)) > size)
-            return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
-
-        const auto isRadOutput = *m_properties->getBool(ZenImuProperty_DegRadOutput);
-        const auto isLowPrecisionOutput = *m_properties->getBool(ZenImuProperty_OutputLowPrecision);
-
-        // The sensor data arrives in an order documented on https://lp-research.atlassian.net/wiki/spaces/LKB/pages/1255145474/LPMS-IG1+User+Manual#Sensor-Measurement-Data (2022/2/25)
         // Timestamp needs to be multiplied by 0.002 to convert to seconds
         // also output the raw framecount as provided by the sensor
         // This will always be 32-bit, independent if low precission mode is selected
-        sensor_parsing_util::parseAndStoreScalar(data, &imuData.frameCount);
+        std::memcpy(&imuData.frameCount, data.data(), sizeof(imuData.frameCount));
         imuData.timestamp = imuData.frameCount * 0.002;
 
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputRawAcc,
-            m_properties, isLowPrecisionOutput, 1000.0f, data, &imuData.aRaw[0])) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
-
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputAccCalibrated,
-            m_properties, isLowPrecisionOutput, 1000.0f, data, &imuData.a[0])) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
-
-        // gyro raw value
-        if (m_hasFirstGyro) {
-            if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputRawGyr0,
-                m_properties, isLowPrecisionOutput, isRadOutput ? 1000.0f: 10.0f, data, &imuData.g1Raw[0])) {
-                sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.g1Raw[0]);
-            } else {
-                return nonstd::make_unexpected(enabled.error());
-            }
-        }
-
-        if (m_hasSecondGyro) {
-            if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputRawGyr1,
-                m_properties, isLowPrecisionOutput, isRadOutput ? 100.0f: 10.0f, data, &imuData.g2Raw[0])) {
-                sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.g2Raw[0]);
-            } else {
-                return nonstd::make_unexpected(enabled.error());
-            }
-        }
-
-        // gyro bias calibrated value
-        if (m_hasFirstGyro) {
-            if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputGyr0BiasCalib,
-                m_properties, isLowPrecisionOutput, isRadOutput ? 1000.0f: 10.0f, data, &imuData.g1BiasCalib[0])) {
-                    sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.g1BiasCalib[0]);
-                }
-            else {
-                return nonstd::make_unexpected(enabled.error());
-            }
-        }
-
-        if (m_hasSecondGyro) {
-            if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputGyr1BiasCalib,
-                m_properties, isLowPrecisionOutput, isRadOutput ? 100.0f: 10.0f, data, &imuData.g2BiasCalib[0])) {
-                    sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.g2BiasCalib[0]);
-                }
-            else {
-                return nonstd::make_unexpected(enabled.error());
-            }
-        }
-
-        // gyro aliment calibrated value
-        // alignment calibration also contains the static calibration correction
-        if (m_hasFirstGyro) {
-            if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputGyr0AlignCalib,
-                m_properties, isLowPrecisionOutput, isRadOutput ? 1000.0f: 10.0f, data, &imuData.g1[0])) {
-                    sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.g1[0]);
-                }
-            else {
-                return nonstd::make_unexpected(enabled.error());
-            }
-        }
-
-        if (m_hasSecondGyro) {
-            if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputGyr1AlignCalib,
-                m_properties, isLowPrecisionOutput, isRadOutput ? 100.0f: 10.0f, data, &imuData.g2[0])) {
-                    sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.g2[0]);
-                }
-            else {
-                return nonstd::make_unexpected(enabled.error());
-            }
-        }
-
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputRawMag,
-            m_properties, isLowPrecisionOutput, 100.0f, data, &imuData.bRaw[0])) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
-
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputMagCalib,
-            m_properties, isLowPrecisionOutput, 100.0f, data, &imuData.b[0])) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+        m_decodePlan.decode(data.data(), imuData);
+        return eventData;
+    }
 
-        // this is the angular velocity which takes into account when an orientation offset was
-        // done
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputAngularVel,
-            m_properties, isLowPrecisionOutput, 100.0f, data, &imuData.w[0])) {
-                sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.w[0]);
-            }
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+    ZenError ImuIg1Component::compileDecodePlan() const noexcept
+    {
+        const auto isRadOutput = m_properties->getBool(ZenImuProperty_DegRadOutput);
+        if (!isRadOutput)
+            return isRadOutput.error();
 
-        if (auto enabled = sensor_parsing_util::readVector4IfAvailable(ZenImuProperty_OutputQuat,
-            m_properties, isLowPrecisionOutput, 10000.0f, data, &imuData.q[0])) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+        const auto isLowPrecisionOutput = m_properties->getBool(ZenImuProperty_OutputLowPrecision);
+        if (!isLowPrecisionOutput)
+            return isLowPrecisionOutput.error();
 
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputEuler,
-            m_properties, isLowPrecisionOutput, isRadOutput ? 10000.0f: 100.0f, data, &imuData.r[0])) {
-                sensor_parsing_util::radToDegreesIfNeededVector3(m_properties, &imuData.r[0]);
-            }
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+        const bool rad = *isRadOutput;
+        const float toDegrees = rad ? c_radToDeg : 1.0f;
 
-        if (auto enabled = sensor_parsing_util::readVector3IfAvailable(ZenImuProperty_OutputLinearAcc,
-            m_properties, isLowPrecisionOutput, 1000.0f, data, &imuData.linAcc[0])) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+        struct Output
+        {
+            ZenProperty_t property;
+            bool available;
+            size_t target;
+            uint8_t count;
+            float divisor16Bit;
+            float factor;
+        };
 
-        // At this time, Pressure and Altitude are not suppported by the IG1 firmware
-        // and are not outputted. Still we will keep this code in place because the
-        // output bits and data fields are still present
-        if (auto enabled = sensor_parsing_util::readScalarIfAvailable(ZenImuProperty_OutputPressure,
-            m_properties, data, &imuData.pressure, isLowPrecisionOutput)) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+        // The sensor data arrives in an order documented on https://lp-research.atlassian.net/wiki/spaces/LKB/pages/1255145474/LPMS-IG1+User+Manual#Sensor-Measurement-Data (2022/2/25)
+        // after the 32-bit timestamp
+        const Output outputs[] = {
+            { ZenImuProperty_OutputRawAcc, true, offsetof(ZenImuData, aRaw), 3, 1000.0f, 1.0f },
+            { ZenImuProperty_OutputAccCalibrated, true, offsetof(ZenImuData, a), 3, 1000.0f, 1.0f },
+            // gyro raw value
+            { ZenImuProperty_OutputRawGyr0, m_hasFirstGyro, offsetof(ZenImuData, g1Raw), 3, rad ? 1000.0f : 10.0f, toDegrees },
+            { ZenImuProperty_OutputRawGyr1, m_hasSecondGyro, offsetof(ZenImuData, g2Raw), 3, rad ? 100.0f : 10.0f, toDegrees },
+            // gyro bias calibrated value
+            { ZenImuProperty_OutputGyr0BiasCalib, m_hasFirstGyro, offsetof(ZenImuData, g1BiasCalib), 3, rad ? 1000.0f : 10.0f, toDegrees },
+            { ZenImuProperty_OutputGyr1BiasCalib, m_hasSecondGyro, offsetof(ZenImuData, g2BiasCalib), 3, rad ? 100.0f : 10.0f, toDegrees },
+            // gyro aliment calibrated value
+            // alignment calibration also contains the static calibration correction
+            { ZenImuProperty_OutputGyr0AlignCalib, m_hasFirstGyro, offsetof(ZenImuData, g1), 3, rad ? 1000.0f : 10.0f, toDegrees },
+            { ZenImuProperty_OutputGyr1AlignCalib, m_hasSecondGyro, offsetof(ZenImuData, g2), 3, rad ? 100.0f : 10.0f, toDegrees },
+            { ZenImuProperty_OutputRawMag, true, offsetof(ZenImuData, bRaw), 3, 100.0f, 1.0f },
+            { ZenImuProperty_OutputMagCalib, true, offsetof(ZenImuData, b), 3, 100.0f, 1.0f },
+            // this is the angular velocity which takes into account when an orientation offset was
+            // done
+            { ZenImuProperty_OutputAngularVel, true, offsetof(ZenImuData, w), 3, 100.0f, toDegrees },
+            { ZenImuProperty_OutputQuat, true, offsetof(ZenImuData, q), 4, 10000.0f, 1.0f },
+            { ZenImuProperty_OutputEuler, true, offsetof(ZenImuData, r), 3, rad ? 10000.0f : 100.0f, toDegrees },
+            { ZenImuProperty_OutputLinearAcc, true, offsetof(ZenImuData, linAcc), 3, 1000.0f, 1.0f },
+            // At this time, Pressure and Altitude are not suppported by the IG1 firmware
+            // and are not outputted. Still we will keep this code in place because the
+            // output bits and data fields are still present
+            { ZenImuProperty_OutputPressure, true, offsetof(ZenImuData, pressure), 1, 1.0f, 1.0f },
+            { ZenImuProperty_OutputAltitude, true, offsetof(ZenImuData, altitude), 1, 1.0f, 1.0f },
+            { ZenImuProperty_OutputTemperature, true, offsetof(ZenImuData, temperature), 1, 100.0f, 1.0f },
+        };
+
+        m_decodePlan.reset(sizeof(uint32_t));
+        for (const auto& output : outputs)
+        {
+            if (!output.available)
+                continue;
 
-        if (auto enabled = sensor_parsing_util::readScalarIfAvailable(ZenImuProperty_OutputAltitude,
-            m_properties, data, &imuData.altitude, isLowPrecisionOutput)) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
-        }
+            const auto enabled = m_properties->getBool(output.property);
+            if (!enabled)
+                return enabled.error();
 
-        if (auto enabled = sensor_parsing_util::readScalarIfAvailable(ZenImuProperty_OutputTemperature,
-            m_properties, data, &imuData.temperature, isLowPrecisionOutput, 100.0f)) {}
-        else {
-            return nonstd::make_unexpected(enabled.error());
+            if (*enabled)
+                m_decodePlan.add(output.target, output.count, *isLowPrecisionOutput, output.divisor16Bit, output.factor);
         }
 
-        return eventData;
+        return ZenError_None;
     }
 }
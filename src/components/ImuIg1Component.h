@@ -13,6 +13,7 @@
 
 #include <atomic>
 
+#include "ImuDecodePlan.h"
 #include "SensorComponent.h"
 #include "communication/SyncedModbusCommunicator.h"
 #include "utility/Ownership.h"
@@ -41,10 +42,16 @@ namespace zen
     private:
         nonstd::expected<ZenEventData, ZenError> parseSensorData(gsl::span<const std::byte> data) const noexcept;
 
+        /** Compiles the output bitset, precision and unit settings into the decode plan */
+        ZenError compileDecodePlan() const noexcept;
+
         SyncedModbusCommunicator& m_communicator;
 
         bool m_hasFirstGyro = true;
         bool m_hasSecondGyro = true;
+
+        mutable ImuDecodePlan m_decodePlan;
+        mutable std::atomic_bool m_decodePlanOutdated;
     };
 }
 #endif
@@ -20,6 +20,8 @@
 
 #include "ZenTypes.h"
 
+#include "utility/HostClock.h"
+
 namespace zen
 {
     class IIoEventSubscriber
@@ -45,8 +47,12 @@ namespace zen
         virtual bool equals(const ZenSensorDesc& desc) const noexcept = 0;
 
     protected:
-        /** Publish received data to the subscriber */
-        virtual ZenError publishReceivedData(ZenEvent evt) { return m_subscriber.processEvent(evt); }
+        /** Publish received data to the subscriber, stamped with the host time at which it was received */
+        virtual ZenError publishReceivedData(ZenEvent evt, uint64_t receivedTimestampNs)
+        {
+            evt.receivedTimestampNs = receivedTimestampNs;
+            return m_subscriber.processEvent(evt);
+        }
     private:
         IIoEventSubscriber& m_subscriber;
     };
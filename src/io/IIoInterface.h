@@ -11,7 +11,10 @@
 #ifndef ZEN_IO_IIOINTERFACE_H_
 #define ZEN_IO_IIOINTERFACE_H_
 
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string_view>
 #include <vector>
 
@@ -20,23 +23,46 @@
 
 #include "ZenTypes.h"
 
+#include "io/IoCapture.h"
+#include "utility/HostClock.h"
+
 namespace zen
 {
     class IIoDataSubscriber
     {
     public:
-        virtual ZenError processData(gsl::span<const std::byte> data) noexcept = 0;
+        /** Process data received from the IO interface
+         * \param receivedTimestampNs Host time at which the read of the data completed, see hostTimestampNs
+         */
+        virtual ZenError processData(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept = 0;
     };
 
     class IIoInterface
     {
     public:
-        IIoInterface(IIoDataSubscriber& subscriber) : m_subscriber(subscriber) {}
+        /** Called with the result of a queued send */
+        using SendCompletion = std::function<void(ZenError)>;
+
+        IIoInterface(IIoDataSubscriber& subscriber) : m_subscriber(subscriber), m_capture(nullptr) {}
         virtual ~IIoInterface() = default;
 
         /** Send data to IO interface */
         virtual ZenError send(gsl::span<const std::byte> data) noexcept = 0;
 
+        /** Queues data to be sent to the IO interface, without waiting for its transmission.
+         * If queueing succeeded, the completion is called with the result of the transmission,
+         * possibly from an IO thread. Interfaces without a send queue send synchronously.
+         */
+        virtual ZenError sendAsync(std::vector<std::byte> data, SendCompletion completion = nullptr) noexcept
+        {
+            if (auto error = send(data))
+                return error;
+
+            if (completion)
+                completion(ZenError_None);
+            return ZenError_None;
+        }
+
         /** Returns the IO interface's baudrate (bit/s) */
         virtual nonstd::expected<int32_t, ZenError> baudRate() const noexcept = 0;
 
@@ -52,12 +78,46 @@ namespace zen
         /** Returns whether the IO interface equals the sensor description */
         virtual bool equals(const ZenSensorDesc& desc) const noexcept = 0;
 
+        /** Returns statistics of the reads from the IO interface, if it keeps track of them */
+        virtual nonstd::expected<ZenIoStatistics, ZenError> ioStatistics() const noexcept
+        {
+            return nonstd::make_unexpected(ZenError_NotSupported);
+        }
+
+        /** Records all data received from and sent to the IO interface from now on. Can only be started once. */
+        void startCapture(std::unique_ptr<IoCapture> capture) noexcept
+        {
+            if (m_ownedCapture || !capture)
+                return;
+
+            m_ownedCapture = std::move(capture);
+            m_capture = m_ownedCapture.get();
+        }
+
+        /** Records data which is sent to the IO interface, if it is captured */
+        void captureSentData(gsl::span<const std::byte> data) noexcept
+        {
+            if (auto capture = m_capture.load())
+                capture->record(IoCaptureDirection::Sent, data, hostTimestampNs());
+        }
+
     protected:
-        /** Publish received data to the subscriber */
-        ZenError publishReceivedData(gsl::span<const std::byte> data) { return m_subscriber.processData(data); }
+        /** Publish received data to the subscriber. Implementations capture receivedTimestampNs
+         *  with hostTimestampNs as soon as the read from the OS completes.
+         */
+        ZenError publishReceivedData(gsl::span<const std::byte> data, uint64_t receivedTimestampNs)
+        {
+            if (auto capture = m_capture.load())
+                capture->record(IoCaptureDirection::Received, data, receivedTimestampNs);
+
+            return m_subscriber.processData(data, receivedTimestampNs);
+        }
 
     private:
         IIoDataSubscriber& m_subscriber;
+
+        std::unique_ptr<IoCapture> m_ownedCapture;
+        std::atomic<IoCapture*> m_capture;
     };
 }
 
@@ -22,6 +22,16 @@
 
 namespace zen
 {
+    class IIoSystemListener
+    {
+    public:
+        /** Called when a device appeared, from a thread of the IO system */
+        virtual void deviceAdded(const ZenSensorDesc& desc) noexcept = 0;
+
+        /** Called when a device disappeared, from a thread of the IO system */
+        virtual void deviceRemoved(const ZenSensorDesc& desc) noexcept = 0;
+    };
+
     class IIoSystem
     {
     public:
@@ -45,6 +55,11 @@ namespace zen
         }
 
         virtual uint32_t getDefaultBaudrate() { return 0; }
+
+        /** IO systems which monitor hotplugging report the devices which appear or disappear
+         * after they were first listed or obtained to the listener.
+         */
+        virtual void setListener(IIoSystemListener*) noexcept {}
     };
 }
 
@@ -0,0 +1,152 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "io/IoCapture.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+#include <spdlog/spdlog.h>
+
+#include "utility/HostClock.h"
+
+namespace zen
+{
+    namespace
+    {
+        constexpr size_t c_magicSize = sizeof(IoCapture::c_magic) - 1;
+
+        std::mutex g_directoryMutex;
+        std::string g_directory;
+
+        std::string sanitize(std::string name)
+        {
+            std::replace_if(name.begin(), name.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)); }, '_');
+            return name;
+        }
+    }
+
+    void IoCapture::setDirectory(std::string directory) noexcept
+    {
+        std::lock_guard<std::mutex> lock(g_directoryMutex);
+        g_directory = std::move(directory);
+    }
+
+    std::unique_ptr<IoCapture> IoCapture::create(const ZenSensorDesc& desc) noexcept
+    {
+        std::string directory;
+        {
+            std::lock_guard<std::mutex> lock(g_directoryMutex);
+            directory = g_directory;
+        }
+
+        if (directory.empty())
+            return nullptr;
+
+        // the identifier is left out, a path in it would make the name too long to be replayed
+        char timestamp[17];
+        std::snprintf(timestamp, sizeof(timestamp), "%016" PRIx64, hostTimestampNs());
+        const std::string path = directory + "/" + sanitize(desc.ioType) + "-" + timestamp + c_fileExtension;
+        return open(path);
+    }
+
+    std::string IoCapture::resolve(const std::string& path) noexcept
+    {
+        const bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+        if (absolute)
+            return path;
+
+        std::lock_guard<std::mutex> lock(g_directoryMutex);
+        if (g_directory.empty())
+            return path;
+
+        return g_directory + "/" + path;
+    }
+
+    std::unique_ptr<IoCapture> IoCapture::open(const std::string& path) noexcept
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.write(c_magic, c_magicSize))
+        {
+            spdlog::error("Cannot create IO capture file {}", path);
+            return nullptr;
+        }
+
+        spdlog::info("Capturing IO data to {}", path);
+        return std::unique_ptr<IoCapture>(new IoCapture(path, std::move(file)));
+    }
+
+    nonstd::expected<std::vector<IoCaptureRecord>, ZenError> IoCapture::load(const std::string& path) noexcept
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        const std::streamoff fileSize = file.tellg();
+        file.seekg(0);
+
+        char magic[c_magicSize];
+        if (!file.read(magic, c_magicSize) || std::memcmp(magic, c_magic, c_magicSize) != 0)
+        {
+            spdlog::error("{} is not an IO capture file", path);
+            return nonstd::make_unexpected(ZenError_Io_InitFailed);
+        }
+
+        std::vector<IoCaptureRecord> records;
+        while (true)
+        {
+            IoCaptureRecord record;
+            uint32_t size;
+            if (!file.read(reinterpret_cast<char*>(&record.timestampNs), sizeof(record.timestampNs)))
+                break;
+
+            if (!file.read(reinterpret_cast<char*>(&size), sizeof(size))
+                || !file.read(reinterpret_cast<char*>(&record.direction), sizeof(record.direction)))
+            {
+                spdlog::warn("IO capture file {} ends in the middle of a record", path);
+                break;
+            }
+
+            // a corrupt size must not allocate more than the file holds
+            if (size > fileSize - file.tellg())
+            {
+                spdlog::error("IO capture file {} has a record of {} bytes, which exceeds the file", path, size);
+                return nonstd::make_unexpected(ZenError_Io_MsgCorrupt);
+            }
+
+            record.data.resize(size);
+            if (!file.read(reinterpret_cast<char*>(record.data.data()), size))
+            {
+                spdlog::warn("IO capture file {} ends in the middle of a record", path);
+                break;
+            }
+
+            records.push_back(std::move(record));
+        }
+
+        return records;
+    }
+
+    IoCapture::IoCapture(std::string path, std::ofstream file) noexcept
+        : m_path(std::move(path))
+        , m_file(std::move(file))
+    {}
+
+    void IoCapture::record(IoCaptureDirection direction, gsl::span<const std::byte> data, uint64_t timestampNs) noexcept
+    {
+        const auto size = static_cast<uint32_t>(data.size());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_file.write(reinterpret_cast<const char*>(&timestampNs), sizeof(timestampNs));
+        m_file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        m_file.write(reinterpret_cast<const char*>(&direction), sizeof(direction));
+        m_file.write(reinterpret_cast<const char*>(data.data()), size);
+    }
+}
@@ -0,0 +1,85 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_IO_IOCAPTURE_H_
+#define ZEN_IO_IOCAPTURE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <gsl/span>
+#include <nonstd/expected.hpp>
+
+#include "ZenTypes.h"
+
+namespace zen
+{
+    enum class IoCaptureDirection : uint8_t
+    {
+        Received = 0,
+        Sent = 1
+    };
+
+    struct IoCaptureRecord
+    {
+        uint64_t timestampNs;
+        IoCaptureDirection direction;
+        std::vector<std::byte> data;
+    };
+
+    /**
+    Appends the raw bytes received from and sent to an IO interface to a file, so the
+    session can be replayed by the ReplaySystem. The file starts with c_magic, followed
+    by records of a host timestamp (uint64_t), the size of the data (uint32_t), the
+    direction (uint8_t) and the data, all in host byte order.
+    */
+    class IoCapture
+    {
+    public:
+        constexpr static const char c_magic[] = "ZENCAP01";
+        constexpr static const char c_fileExtension[] = ".zencap";
+
+        /** Captures the IO interfaces of sensors obtained later into the directory, an empty one disables capturing */
+        static void setDirectory(std::string directory) noexcept;
+
+        /** Returns a capture for the sensor in the capture directory, nullptr if capturing is disabled or fails.
+            The file is named after the IO type and the creation time, so its name fits a sensor identifier. */
+        static std::unique_ptr<IoCapture> create(const ZenSensorDesc& desc) noexcept;
+
+        /** Returns the path of a capture, a relative one is resolved in the capture directory if it is set */
+        static std::string resolve(const std::string& path) noexcept;
+
+        /** Opens a new capture file at the path, nullptr if it cannot be created */
+        static std::unique_ptr<IoCapture> open(const std::string& path) noexcept;
+
+        /** Loads all records of a capture file */
+        static nonstd::expected<std::vector<IoCaptureRecord>, ZenError> load(const std::string& path) noexcept;
+
+        /** Appends a record, safe to call from multiple threads */
+        void record(IoCaptureDirection direction, gsl::span<const std::byte> data, uint64_t timestampNs) noexcept;
+
+        const std::string& path() const noexcept { return m_path; }
+
+    private:
+        IoCapture(std::string path, std::ofstream file) noexcept;
+
+        const std::string m_path;
+
+        std::mutex m_mutex;
+        std::ofstream m_file;
+    };
+}
+
+#endif
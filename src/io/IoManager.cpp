@@ -15,6 +15,7 @@
 
 #include "io/systems/BleSystem.h"
 #include "io/systems/BluetoothSystem.h"
+#include "io/systems/ReplaySystem.h"
 #include "io/systems/TestSensorSystem.h"
 #ifdef ZEN_NETWORK
 #include "io/systems/ZeroMQSystem.h"
@@ -37,6 +38,7 @@
 namespace zen
 {
     static auto testSensorRegistry = makeRegistry<TestSensorSystem>();
+    static auto replayRegistry = makeRegistry<ReplaySystem>();
 #ifdef ZEN_BLUETOOTH_BLE
     static auto bleRegistry = makeRegistry<BleSystem>();
 #endif
@@ -129,4 +131,17 @@ namespace zen
 
         return ioSystems;
     }
+
+    std::vector<std::pair<std::string_view, std::reference_wrapper<IIoSystem>>> IoManager::getIoSystemsByType() const noexcept
+    {
+        std::vector<std::pair<std::string_view, std::reference_wrapper<IIoSystem>>> ioSystems;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ioSystems.reserve(m_ioSystems.size());
+
+        for (const auto& pair : m_ioSystems)
+            ioSystems.emplace_back(pair.first, *pair.second.get());
+
+        return ioSystems;
+    }
 }
@@ -39,6 +39,9 @@ namespace zen
         std::optional<std::reference_wrapper<IIoSystem>> getIoSystem(std::string_view key) const noexcept;
         std::vector<std::reference_wrapper<IIoSystem>> getIoSystems() const noexcept;
 
+        /** Returns the IO systems with their keys, which stay valid for the lifetime of the program */
+        std::vector<std::pair<std::string_view, std::reference_wrapper<IIoSystem>>> getIoSystemsByType() const noexcept;
+
         static IAutoIoSystemRegistry* head;
         static IAutoIoSystemRegistry* tail;
 
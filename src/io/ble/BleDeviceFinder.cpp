@@ -32,7 +32,7 @@ namespace zen
                 const auto name = device.name().toStdString();
                 const auto address = device.address().toString().toStdString();
 
-                ZenSensorDesc desc;
+                ZenSensorDesc desc{};
                 auto length = std::min(sizeof(ZenSensorDesc::name) - 1, name.size());
                 std::memcpy(desc.name, name.c_str(), length);
                 desc.name[length] = '\0';
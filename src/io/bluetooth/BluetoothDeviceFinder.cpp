@@ -33,7 +33,7 @@ namespace zen
             const auto& name = device.name;
             const auto& address = device.address;
 
-            ZenSensorDesc desc;
+            ZenSensorDesc desc{};
             auto length = std::min(sizeof(ZenSensorDesc::name) - 1, name.size());
             std::memcpy(desc.name, name.c_str(), length);
             desc.name[length] = '\0';
@@ -58,7 +58,10 @@ namespace zen
         virtual bool equals(std::string_view ioType) const noexcept = 0;
 
     protected:
-        ZenError publishReceivedData(CanInterface& canInterface, gsl::span<const std::byte> data) { return canInterface.publishReceivedData(data); }
+        ZenError publishReceivedData(CanInterface& canInterface, gsl::span<const std::byte> data, uint64_t receivedTimestampNs)
+        {
+            return canInterface.publishReceivedData(data, receivedTimestampNs);
+        }
 
     private:
         /** Send data to CAN bus */
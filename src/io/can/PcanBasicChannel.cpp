@@ -124,7 +124,7 @@ namespace zen
         {
             const std::string identifier = std::to_string(deviceId);
 
-            ZenSensorDesc desc;
+            ZenSensorDesc desc{};
             std::memcpy(desc.name, identifier.c_str(), identifier.size());
             desc.name[identifier.size()] = '\0';
 
@@ -153,6 +153,8 @@ namespace zen
         {
             if (auto error = PcanBasicSystem::fnTable.read(m_channel, &m, &t))
                 return error == PCAN_ERROR_QRCVEMPTY ? ZenError_None : ZenError_Io_ReadFailed;
+
+            const uint64_t receivedTimestampNs = hostTimestampNs();
              
             auto it = m_subscribers.find(static_cast<uint32_t>(m.ID));
             if (it == m_subscribers.cend())
@@ -161,7 +163,7 @@ namespace zen
                 continue;
             }
 
-            if (auto error = publishReceivedData(*it->second, gsl::make_span(reinterpret_cast<std::byte*>(m.DATA), static_cast<size_t>(m.LEN))))
+            if (auto error = publishReceivedData(*it->second, gsl::make_span(reinterpret_cast<std::byte*>(m.DATA), static_cast<size_t>(m.LEN)), receivedTimestampNs))
                 return error;
         }
     }
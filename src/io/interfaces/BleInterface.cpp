@@ -47,7 +47,7 @@ namespace zen
         while (!m_terminate)
         {
             while (auto data = m_handler->tryToGetReceivedData())
-                if (auto error = publishReceivedData(*data))
+                if (auto error = publishReceivedData(*data, hostTimestampNs()))
                     return error;
 
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -73,12 +73,13 @@ namespace zen
         {
             // This is the only place where we read asynchronously, so no need to check the expected
             auto buffer = m_handler->read();
+            const uint64_t receivedTimestampNs = hostTimestampNs();
 
             try
             {
                 if (buffer.has_value())
                 {
-                    if (auto error = publishReceivedData(*buffer))
+                    if (auto error = publishReceivedData(*buffer, receivedTimestampNs))
                         return error;
                 }
                 else
@@ -0,0 +1,207 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "io/interfaces/ReplayInterface.h"
+
+#include <spdlog/spdlog.h>
+
+#include "communication/Modbus.h"
+#include "io/systems/ReplaySystem.h"
+
+namespace zen
+{
+    namespace
+    {
+        /** Counts the frames in the data like ModbusCommunicator::processData parses them */
+        uint64_t countFrames(modbus::LpFrameParser& parser, gsl::span<const std::byte> data)
+        {
+            uint64_t frames = 0;
+            while (!data.empty())
+            {
+                if (parser.parse(data) != modbus::FrameParseError_None)
+                {
+                    parser.reset();
+                    data = data.subspan(1);
+                    continue;
+                }
+
+                if (parser.finished())
+                {
+                    ++frames;
+                    parser.reset();
+                }
+            }
+            return frames;
+        }
+    }
+
+    ReplayInterface::ReplayInterface(IIoDataSubscriber& subscriber, std::string identifier, std::vector<IoCaptureRecord> records, bool fast) noexcept
+        : IIoInterface(subscriber)
+        , m_identifier(std::move(identifier))
+        , m_records(std::move(records))
+        , m_fast(fast)
+        , m_frameCount(0)
+        , m_baudRate(0)
+        , m_finished(false)
+        , m_terminate(false)
+        , m_sendCount(0)
+        , m_answeredSendCount(0)
+        , m_recordsPlayed(0)
+        , m_bytesPlayed(0)
+        , m_framesPlayed(0)
+        , m_startTimestampNs(0)
+        , m_lastTimestampNs(0)
+        , m_sendWaitNs(0)
+    {
+        modbus::LpFrameParser parser;
+        m_recordFrameCounts.reserve(m_records.size());
+        for (const auto& record : m_records)
+        {
+            const uint64_t frames = record.direction == IoCaptureDirection::Received ? countFrames(parser, record.data) : 0;
+            m_recordFrameCounts.push_back(frames);
+            m_frameCount += frames;
+        }
+
+        m_thread = std::thread(&ReplayInterface::run, this);
+    }
+
+    ReplayInterface::~ReplayInterface()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_terminate = true;
+        }
+        m_cv.notify_all();
+
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    ZenError ReplayInterface::send(gsl::span<const std::byte>) noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_sendCount;
+        }
+        m_cv.notify_all();
+        return ZenError_None;
+    }
+
+    ZenError ReplayInterface::setBaudRate(unsigned int rate) noexcept
+    {
+        m_baudRate = static_cast<int32_t>(rate);
+        return ZenError_None;
+    }
+
+    nonstd::expected<std::vector<int32_t>, ZenError> ReplayInterface::supportedBaudRates() const noexcept
+    {
+        return nonstd::make_unexpected(ZenError_NotSupported);
+    }
+
+    std::string_view ReplayInterface::type() const noexcept
+    {
+        return ReplaySystem::KEY;
+    }
+
+    bool ReplayInterface::equals(const ZenSensorDesc& desc) const noexcept
+    {
+        if (std::string_view(ReplaySystem::KEY) != desc.ioType)
+            return false;
+
+        return m_identifier == desc.identifier;
+    }
+
+    nonstd::expected<ZenIoStatistics, ZenError> ReplayInterface::ioStatistics() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ZenIoStatistics statistics{};
+        statistics.readCount = m_recordsPlayed;
+        statistics.bytesRead = m_bytesPlayed;
+        return statistics;
+    }
+
+    ReplayStatistics ReplayInterface::replayStatistics() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ReplayStatistics statistics;
+        statistics.bytes = m_bytesPlayed;
+        statistics.frames = m_framesPlayed;
+        statistics.durationNs = m_lastTimestampNs - m_startTimestampNs - m_sendWaitNs;
+        return statistics;
+    }
+
+    bool ReplayInterface::waitForSend() noexcept
+    {
+        const uint64_t startNs = hostTimestampNs();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cv.wait_for(lock, c_sendTimeout, [this]() { return m_terminate || m_sendCount > m_answeredSendCount; }))
+            spdlog::warn("Replay of {} did not see the captured command being sent, continuing without it", m_identifier);
+
+        ++m_answeredSendCount;
+        if (m_recordsPlayed != 0)
+            m_sendWaitNs += hostTimestampNs() - startNs;
+        return !m_terminate;
+    }
+
+    void ReplayInterface::run() noexcept
+    {
+        if (m_records.empty())
+        {
+            m_finished = true;
+            return;
+        }
+
+        // Received data is played back relative to the last record that could be replayed in time
+        using namespace std::chrono;
+        auto baseTime = steady_clock::now();
+        uint64_t baseTimestampNs = m_records.front().timestampNs;
+
+        for (size_t idx = 0; idx < m_records.size(); ++idx)
+        {
+            const auto& record = m_records[idx];
+            if (record.direction == IoCaptureDirection::Sent)
+            {
+                if (!waitForSend())
+                    return;
+
+                baseTime = steady_clock::now();
+                baseTimestampNs = record.timestampNs;
+                continue;
+            }
+
+            if (!m_fast && record.timestampNs > baseTimestampNs)
+                std::this_thread::sleep_until(baseTime + nanoseconds(record.timestampNs - baseTimestampNs));
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_terminate)
+                    return;
+            }
+
+            const uint64_t timestampNs = hostTimestampNs();
+            if (auto error = publishReceivedData(record.data, timestampNs))
+                spdlog::error("Replayed data of {} could not be processed. Error: {}", m_identifier, fmt::underlying(error));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_recordsPlayed == 0)
+                m_startTimestampNs = timestampNs;
+            ++m_recordsPlayed;
+            m_bytesPlayed += record.data.size();
+            m_framesPlayed += m_recordFrameCounts[idx];
+            m_lastTimestampNs = hostTimestampNs();
+        }
+
+        const auto statistics = replayStatistics();
+        spdlog::info("Replayed {} bytes and {} of {} frames of {} at {:.2f} MB/s and {:.0f} frames/s", statistics.bytes,
+            statistics.frames, m_frameCount, m_identifier, statistics.megabytesPerSecond(), statistics.framesPerSecond());
+        m_finished = true;
+    }
+}
@@ -0,0 +1,117 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_IO_INTERFACES_REPLAYINTERFACE_H_
+#define ZEN_IO_INTERFACES_REPLAYINTERFACE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "io/IIoInterface.h"
+#include "io/IoCapture.h"
+
+namespace zen
+{
+    struct ReplayStatistics
+    {
+        uint64_t bytes;
+        uint64_t frames;
+        uint64_t durationNs;
+
+        double megabytesPerSecond() const noexcept { return durationNs == 0 ? 0.0 : bytes * 1e3 / durationNs; }
+        double framesPerSecond() const noexcept { return durationNs == 0 ? 0.0 : frames * 1e9 / durationNs; }
+    };
+
+    /**
+    Plays the received data of an IO capture back to the subscriber. A sent record of the capture
+    holds back the data following it until the host sent data as well, so commands are answered
+    by the replies of the capture.
+    */
+    class ReplayInterface : public IIoInterface
+    {
+    public:
+        /** Maximum time the replay waits for the host to send a captured command */
+        constexpr static auto c_sendTimeout = std::chrono::seconds(2);
+
+        /**
+         * \param identifier Sensor identifier the interface equals
+         * \param fast Whether data is played back as fast as possible instead of at its captured timing
+         */
+        ReplayInterface(IIoDataSubscriber& subscriber, std::string identifier, std::vector<IoCaptureRecord> records, bool fast) noexcept;
+        ~ReplayInterface();
+
+        /** Send data to IO interface */
+        ZenError send(gsl::span<const std::byte> data) noexcept override;
+
+        /** Returns the IO interface's baudrate (bit/s) */
+        nonstd::expected<int32_t, ZenError> baudRate() const noexcept override { return m_baudRate.load(); }
+
+        /** Set Baudrate of IO interface (bit/s), which does not affect the replay */
+        ZenError setBaudRate(unsigned int rate) noexcept override;
+
+        /** Returns the supported baudrates of the IO interface (bit/s) */
+        nonstd::expected<std::vector<int32_t>, ZenError> supportedBaudRates() const noexcept override;
+
+        /** Returns the type of IO interface */
+        std::string_view type() const noexcept override;
+
+        /** Returns whether the IO interface equals the sensor description */
+        bool equals(const ZenSensorDesc& desc) const noexcept override;
+
+        /** Returns statistics of the data played back so far */
+        nonstd::expected<ZenIoStatistics, ZenError> ioStatistics() const noexcept override;
+
+        /** Returns the rate of the replay so far */
+        ReplayStatistics replayStatistics() const noexcept;
+
+        /** Returns whether all records have been played back */
+        bool finished() const noexcept { return m_finished; }
+
+    private:
+        void run() noexcept;
+
+        /** Waits until the host sent one more command, returns false if the replay terminated */
+        bool waitForSend() noexcept;
+
+        const std::string m_identifier;
+        const std::vector<IoCaptureRecord> m_records;
+        const bool m_fast;
+
+        // Number of frames completed by each record, counted up front so it does not slow down the replay
+        std::vector<uint64_t> m_recordFrameCounts;
+        uint64_t m_frameCount;
+
+        std::atomic_int32_t m_baudRate;
+        std::atomic_bool m_finished;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_terminate;
+        uint64_t m_sendCount;
+        uint64_t m_answeredSendCount;
+
+        uint64_t m_recordsPlayed;
+        uint64_t m_bytesPlayed;
+        uint64_t m_framesPlayed;
+        uint64_t m_startTimestampNs;
+        uint64_t m_lastTimestampNs;
+        // Time spent waiting for the host to send, which does not count towards the replay rate
+        uint64_t m_sendWaitNs;
+
+        std::thread m_thread;
+    };
+}
+
+#endif
@@ -110,8 +110,9 @@ namespace zen
                     return ZenError_Io_ReadFailed;
             }
 
+            const uint64_t receivedTimestampNs = hostTimestampNs();
             if (nReceivedBytes > 0)
-                if (auto error = publishReceivedData(gsl::make_span(m_buffer.data(), nReceivedBytes)))
+                if (auto error = publishReceivedData(gsl::make_span(m_buffer.data(), nReceivedBytes), receivedTimestampNs))
                     return error;
         }
 
@@ -11,12 +11,99 @@
 #include "io/interfaces/TestSensorInterface.h"
 #include "io/systems/TestSensorSystem.h"
 
+#include <charconv>
+#include <chrono>
+#include <cmath>
+
 #include <spdlog/spdlog.h>
 
 namespace zen
 {
-    TestSensorInterface::TestSensorInterface(IIoEventSubscriber& subscriber,std::string const&) noexcept
+    namespace
+    {
+        constexpr double c_pi = 3.14159265358979323846;
+
+        bool parseUnsigned(std::string_view value, unsigned int& out) noexcept
+        {
+            const auto result = std::from_chars(value.data(), value.data() + value.size(), out);
+            return result.ec == std::errc() && result.ptr == value.data() + value.size();
+        }
+
+        /** Maps an integer to a well distributed pseudo-random number, see SplitMix64 */
+        uint64_t mix(uint64_t x) noexcept
+        {
+            x += 0x9e3779b97f4a7c15ull;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        /** Pseudo-random number in [-1, 1) */
+        float noise(uint32_t frameCount, unsigned int instance, unsigned int channel) noexcept
+        {
+            const uint64_t bits = mix((uint64_t(instance) << 40) ^ (uint64_t(channel) << 32) ^ frameCount);
+            return static_cast<float>((bits >> 40) / double(1ull << 23) - 1.0);
+        }
+    }
+
+    nonstd::expected<TestSensorConfig, ZenSensorInitError> TestSensorConfig::parse(std::string_view identifier) noexcept
+    {
+        TestSensorConfig config;
+
+        while (!identifier.empty())
+        {
+            const auto end = identifier.find(';');
+            const auto entry = identifier.substr(0, end);
+            identifier = end == std::string_view::npos ? std::string_view() : identifier.substr(end + 1);
+
+            if (entry.empty())
+                continue;
+
+            const auto separator = entry.find('=');
+            const auto key = entry.substr(0, separator);
+            const auto value = separator == std::string_view::npos ? std::string_view() : entry.substr(separator + 1);
+
+            bool valid = true;
+            if (key == "rate")
+                valid = parseUnsigned(value, config.rate);
+            else if (key == "instance")
+                valid = parseUnsigned(value, config.instance);
+            else if (key == "payload")
+            {
+                config.imu = value == "imu" || value == "imu+gnss";
+                config.gnss = value == "gnss" || value == "imu+gnss";
+                valid = config.imu || config.gnss;
+            }
+            else if (key == "waveform")
+            {
+                if (value == "constant")
+                    config.waveform = TestSensorWaveform::Constant;
+                else if (value == "sine")
+                    config.waveform = TestSensorWaveform::Sine;
+                else if (value == "ramp")
+                    config.waveform = TestSensorWaveform::Ramp;
+                else if (value == "noise")
+                    config.waveform = TestSensorWaveform::Noise;
+                else
+                    valid = false;
+            }
+            else
+                valid = false;
+
+            if (!valid)
+            {
+                spdlog::error("Invalid TestSensor option {}", std::string(entry));
+                return nonstd::make_unexpected(ZenSensorInitError_UnknownIdentifier);
+            }
+        }
+
+        return config;
+    }
+
+    TestSensorInterface::TestSensorInterface(IIoEventSubscriber& subscriber, std::string identifier, TestSensorConfig config) noexcept
         : IIoEventInterface(subscriber)
+        , m_identifier(std::move(identifier))
+        , m_config(config)
     {
         spdlog::info("Created TestSensor interface");
 
@@ -42,45 +129,156 @@ namespace zen
         if (std::string_view(TestSensorSystem::KEY) != desc.ioType)
             return false;
 
-        return true;
+        return m_identifier == desc.identifier;
+    }
+
+    void TestSensorInterface::fillImuData(ZenImuData& imuData, uint32_t frameCount, double t) const noexcept
+    {
+        imuData.frameCount = static_cast<int>(frameCount);
+        imuData.timestamp = t;
+
+        if (m_config.waveform == TestSensorWaveform::Constant)
+        {
+            imuData.q[0] = 0.5;
+            imuData.q[1] = -0.5;
+            imuData.q[2] = -0.5;
+            imuData.q[3] = 0.5;
+
+            imuData.a[0] = 0.0f;
+            imuData.a[1] = 0.0f;
+            imuData.a[2] = -1.0f;
+
+            imuData.g1[0] = 23.0f;
+            imuData.g1[1] = 24.0f;
+            imuData.g1[2] = 25.0f;
+            imuData.g2[0] = 23.0f;
+            imuData.g2[1] = 24.0f;
+            imuData.g2[2] = 25.0f;
+            return;
+        }
+
+        // Heading (degrees) and its rate (degrees/s) of the waveform
+        const double phase = t + m_config.instance * 0.1;
+        double yaw = 0.0;
+        double yawRate = 0.0;
+        switch (m_config.waveform)
+        {
+        case TestSensorWaveform::Sine:
+            yaw = 90.0 * std::sin(2.0 * c_pi * phase);
+            yawRate = 90.0 * 2.0 * c_pi * std::cos(2.0 * c_pi * phase);
+            break;
+
+        case TestSensorWaveform::Ramp:
+            yaw = 360.0 * (phase - std::floor(phase)) - 180.0;
+            yawRate = 360.0;
+            break;
+
+        default:
+            yaw = 180.0 * noise(frameCount, m_config.instance, 0);
+            yawRate = 100.0 * noise(frameCount, m_config.instance, 1);
+            break;
+        }
+
+        const double halfYaw = yaw * c_pi / 360.0;
+        imuData.q[0] = static_cast<float>(std::cos(halfYaw));
+        imuData.q[3] = static_cast<float>(std::sin(halfYaw));
+        imuData.r[2] = static_cast<float>(yaw);
+
+        imuData.a[2] = -1.0f;
+        imuData.aRaw[2] = -1.0f;
+        if (m_config.waveform == TestSensorWaveform::Noise)
+            for (unsigned int idx = 0; idx < 3; ++idx)
+                imuData.a[idx] += 0.01f * noise(frameCount, m_config.instance, 2 + idx);
+
+        imuData.g1[2] = static_cast<float>(yawRate);
+        imuData.g2[2] = static_cast<float>(yawRate);
+        imuData.w[2] = static_cast<float>(yawRate);
+
+        const double yawRad = yaw * c_pi / 180.0;
+        imuData.b[0] = static_cast<float>(30.0 * std::cos(yawRad));
+        imuData.b[1] = static_cast<float>(-30.0 * std::sin(yawRad));
+        imuData.b[2] = -40.0f;
+    }
+
+    void TestSensorInterface::fillGnssData(ZenGnssData& gnssData, uint32_t frameCount, double t) const noexcept
+    {
+        gnssData.frameCount = static_cast<int>(frameCount);
+        gnssData.timestamp = t;
+
+        // instances are spread out by about 100 m, sine and ramp move on a circle with a radius of about 10 m
+        double offset = 0.0;
+        if (m_config.waveform == TestSensorWaveform::Sine || m_config.waveform == TestSensorWaveform::Ramp)
+            offset = 2.0 * c_pi * t / 60.0;
+        else if (m_config.waveform == TestSensorWaveform::Noise)
+            offset = noise(frameCount, m_config.instance, 5);
+
+        gnssData.latitude = 35.6812 + m_config.instance * 0.001 + 0.0001 * std::sin(offset);
+        gnssData.longitude = 139.7671 + 0.0001 * std::cos(offset);
+        gnssData.height = 40.0;
+        gnssData.horizontalAccuracy = 0.5;
+        gnssData.verticalAccuracy = 1.0;
+        gnssData.headingOfMotion = std::fmod(offset * 180.0 / c_pi + 360.0, 360.0);
+        gnssData.headingOfVehicle = gnssData.headingOfMotion;
+        gnssData.headingAccuracy = 1.0;
+        gnssData.velocity = m_config.waveform == TestSensorWaveform::Constant ? 0.0 : 1.0;
+        gnssData.velocityAccuracy = 0.1;
+        gnssData.fixType = ZenGnssFixType_3dFix;
+        gnssData.carrierPhaseSolution = ZenGnssFixCarrierPhaseSolution_None;
+        gnssData.numberSatellitesUsed = 12;
+
+        const auto seconds = static_cast<uint32_t>(t);
+        gnssData.year = 2020;
+        gnssData.month = 1;
+        gnssData.day = 1;
+        gnssData.hour = static_cast<uint8_t>((seconds / 3600) % 24);
+        gnssData.minute = static_cast<uint8_t>((seconds / 60) % 60);
+        gnssData.second = static_cast<uint8_t>(seconds % 60);
+        gnssData.nanoSecondCorrection = static_cast<int32_t>((t - seconds) * 1e9);
     }
 
     int TestSensorInterface::run()
     {
         spdlog::info("Running TestSensor interface thread");
 
-        while(!m_terminate) {
-            // simulate 100 Hz
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-            ZenEvent evt;
-            evt.eventType = ZenEventType_ImuData;
-
-            evt.data.imuData.q[0] = 0.5;
-            evt.data.imuData.q[1] = -0.5;
-            evt.data.imuData.q[2] = -0.5;
-            evt.data.imuData.q[3] = 0.5;
-
-            evt.data.imuData.a[0] = 0.0f;
-            evt.data.imuData.a[1] = 0.0f;
-            evt.data.imuData.a[2] = -1.0f;
-
-            evt.data.imuData.g1[0] = 23.0f;
-            evt.data.imuData.g1[1] = 24.0f;
-            evt.data.imuData.g1[2] = 25.0f;
-            evt.data.imuData.g2[0] = 23.0f;
-            evt.data.imuData.g2[1] = 24.0f;
-            evt.data.imuData.g2[2] = 25.0f;
-
-            ZenSensorHandle sensorHandle;
-            sensorHandle.handle = 5;
-            evt.sensor = sensorHandle;
-
-            ZenComponentHandle_t componentHandle;
-            // imu handle is 1 for regular sensors
-            componentHandle.handle = 1;
-            evt.component = componentHandle;
-
-            publishReceivedData(evt);
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const auto period = m_config.rate == 0 ? clock::duration::zero()
+            : std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(1000000000 / m_config.rate));
+
+        // Samples are scheduled relative to the start, so the rate does not drift with the publishing time
+        auto nextSample = start;
+        for (uint32_t frameCount = 0; !m_terminate; ++frameCount)
+        {
+            if (m_config.rate != 0)
+            {
+                nextSample += period;
+                std::this_thread::sleep_until(nextSample);
+            }
+
+            const double t = m_config.rate != 0 ? frameCount / double(m_config.rate)
+                : std::chrono::duration<double>(clock::now() - start).count();
+            const uint64_t timestampNs = hostTimestampNs();
+
+            // The sensor handle is set by the sensor which receives the event
+            if (m_config.imu)
+            {
+                ZenEvent evt{};
+                evt.eventType = ZenEventType_ImuData;
+                // imu handle is 1 for regular sensors
+                evt.component.handle = 1;
+                fillImuData(evt.data.imuData, frameCount, t);
+                publishReceivedData(evt, timestampNs);
+            }
+
+            if (m_config.gnss)
+            {
+                ZenEvent evt{};
+                evt.eventType = ZenEventType_GnssData;
+                // gnss handle is 2 for regular sensors
+                evt.component.handle = 2;
+                fillGnssData(evt.data.gnssData, frameCount, t);
+                publishReceivedData(evt, timestampNs);
+            }
         }
 
         // terminate this thread happily
@@ -13,16 +13,49 @@
 
 #include <array>
 #include <atomic>
+#include <string>
+#include <string_view>
 #include <thread>
 
+#include <nonstd/expected.hpp>
+
 #include "io/IIoEventInterface.h"
 
 namespace zen
 {
+    enum class TestSensorWaveform
+    {
+        Constant, // the fixed values of the original TestSensor
+        Sine,     // rotation about the z axis with a period of one second
+        Ramp,     // values rising linearly, wrapping around every second
+        Noise     // deterministic pseudo-random values, seeded with the instance
+    };
+
+    /**
+    Configuration of a TestSensor, parsed from the sensor identifier. The identifier is a list of
+    key=value pairs separated by semicolons, e.g. "rate=10000;payload=imu+gnss;waveform=sine;instance=3":
+     * rate: samples per second, 0 publishes as fast as possible. Default: 100
+     * payload: imu, gnss or imu+gnss, which publishes both events per sample. Default: imu
+     * waveform: constant, sine, ramp or noise. Default: constant
+     * instance: number which distinguishes several TestSensors with the same configuration and
+       offsets their data. Default: 0
+    An empty identifier selects the defaults.
+    */
+    struct TestSensorConfig
+    {
+        unsigned int rate = 100;
+        bool imu = true;
+        bool gnss = false;
+        TestSensorWaveform waveform = TestSensorWaveform::Constant;
+        unsigned int instance = 0;
+
+        static nonstd::expected<TestSensorConfig, ZenSensorInitError> parse(std::string_view identifier) noexcept;
+    };
+
     class TestSensorInterface : public IIoEventInterface
     {
     public:
-        TestSensorInterface(IIoEventSubscriber& subscriber, std::string const& endpoint) noexcept;
+        TestSensorInterface(IIoEventSubscriber& subscriber, std::string identifier, TestSensorConfig config) noexcept;
         ~TestSensorInterface();
 
         /** Returns the type of IO interface */
@@ -34,6 +67,12 @@ namespace zen
     private:
         int run();
 
+        void fillImuData(ZenImuData& imuData, uint32_t frameCount, double t) const noexcept;
+        void fillGnssData(ZenGnssData& gnssData, uint32_t frameCount, double t) const noexcept;
+
+        const std::string m_identifier;
+        const TestSensorConfig m_config;
+
         std::atomic_bool m_terminate;
         std::thread m_pollingThread;
     };
@@ -90,12 +90,13 @@ namespace zen
               // todo: package event in some data struct and use proper serializer
               const auto recv_result = this->m_subscriber->recv(zmqMessage, zmq::recv_flags::none);
               if (recv_result.has_value() && (*recv_result > 0)) {
+                  const uint64_t receivedTimestampNs = hostTimestampNs();
                   auto unpackedMessage = zen::Streaming::fromZmqMessage(zmqMessage);
                   if (unpackedMessage.has_value()) {
                       if (!m_terminate) {
                           auto zenEvent = zen::Streaming::streamingMessageToZenEvent(*unpackedMessage);
                           if (zenEvent) {
-                              publishReceivedData(*zenEvent);
+                              publishReceivedData(*zenEvent, receivedTimestampNs);
                           } else {
                               spdlog::error("Cannot convert streaming message of type {0} to ZenEvent",
                                   fmt::underlying(unpackedMessage->type));
@@ -0,0 +1,351 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "io/interfaces/linux/EpollReactor.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+#include "utility/HostClock.h"
+
+namespace zen
+{
+    namespace
+    {
+        // Registration ids start at one, the wakeup eventfd uses id zero
+        constexpr uint64_t c_wakeupId = 0;
+
+        std::mutex g_reactorMutex;
+        std::weak_ptr<EpollReactor> g_reactor;
+        std::atomic_uint g_threadCount(EpollReactor::c_defaultThreadCount);
+    }
+
+    std::shared_ptr<EpollReactor> EpollReactor::shared() noexcept
+    {
+        std::lock_guard<std::mutex> lock(g_reactorMutex);
+        if (auto reactor = g_reactor.lock())
+            return reactor;
+
+        const int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd == -1)
+        {
+            spdlog::error("Cannot create epoll instance: {}", std::strerror(errno));
+            return nullptr;
+        }
+
+        const int wakeupFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (wakeupFd == -1)
+        {
+            spdlog::error("Cannot create wakeup eventfd of epoll reactor: {}", std::strerror(errno));
+            ::close(epollFd);
+            return nullptr;
+        }
+
+        // The wakeup is level-triggered, so it releases all threads at once
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = c_wakeupId;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeupFd, &event) == -1)
+        {
+            spdlog::error("Cannot register wakeup eventfd of epoll reactor: {}", std::strerror(errno));
+            ::close(wakeupFd);
+            ::close(epollFd);
+            return nullptr;
+        }
+
+        std::shared_ptr<EpollReactor> reactor(new EpollReactor(epollFd, wakeupFd));
+        reactor->start(g_threadCount);
+        g_reactor = reactor;
+        return reactor;
+    }
+
+    ZenError EpollReactor::setThreadCount(unsigned int count) noexcept
+    {
+        if (count == 0)
+            return ZenError_InvalidArgument;
+
+        g_threadCount = count;
+        return ZenError_None;
+    }
+
+    size_t EpollReactor::readBufferSizeForBaudRate(unsigned int baudRate) noexcept
+    {
+        // A byte takes ten bits on the wire including start and stop bit
+        const size_t bytesPer10Ms = baudRate / 10 / 100;
+
+        size_t size = c_minReadBufferSize;
+        while (size < bytesPer10Ms && size < c_maxReadBufferSize)
+            size *= 2;
+
+        return size;
+    }
+
+    EpollReactor::EpollReactor(int epollFd, int wakeupFd) noexcept
+        : m_epollFd(epollFd)
+        , m_wakeupFd(wakeupFd)
+        , m_terminate(false)
+        , m_nextId(c_wakeupId + 1)
+    {}
+
+    EpollReactor::~EpollReactor()
+    {
+        m_terminate = true;
+
+        const uint64_t increment = 1;
+        [[maybe_unused]] const auto result = ::write(m_wakeupFd, &increment, sizeof(increment));
+
+        for (auto& thread : m_threads)
+            thread.join();
+
+        ::close(m_wakeupFd);
+        ::close(m_epollFd);
+    }
+
+    void EpollReactor::start(unsigned int threadCount)
+    {
+        spdlog::info("Starting epoll reactor with {} threads", threadCount);
+
+        m_threads.reserve(threadCount);
+        for (unsigned int idx = 0; idx < threadCount; ++idx)
+            m_threads.emplace_back(&EpollReactor::run, this);
+    }
+
+    ZenError EpollReactor::add(int fd, IReactorReadHandler& handler, size_t readBufferSize) noexcept
+    {
+        auto registration = std::make_shared<Registration>();
+        registration->handler = &handler;
+        registration->writeHandler = nullptr;
+        registration->buffer.resize(std::clamp<size_t>(readBufferSize, 1, c_maxReadBufferSize));
+
+        return add(fd, std::move(registration), EPOLLIN | EPOLLONESHOT);
+    }
+
+    ZenError EpollReactor::addWriter(int fd, IReactorWriteHandler& handler) noexcept
+    {
+        auto registration = std::make_shared<Registration>();
+        registration->handler = nullptr;
+        registration->writeHandler = &handler;
+
+        // Only errors are reported until the first armWrite
+        return add(fd, std::move(registration), EPOLLONESHOT);
+    }
+
+    ZenError EpollReactor::add(int fd, std::shared_ptr<Registration> registration, uint32_t events) noexcept
+    {
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags == -1 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+            return ZenError_Io_InitFailed;
+
+        registration->fd = fd;
+        registration->active = true;
+        registration->readCount = 0;
+        registration->bytesRead = 0;
+        registration->totalReadLatencyNs = 0;
+        registration->maxReadLatencyNs = 0;
+
+        // The registration is visible to the threads before its first event can arrive
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint64_t id = m_nextId++;
+        registration->id = id;
+        m_registrations.emplace(id, std::move(registration));
+
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) == -1)
+        {
+            spdlog::error("Cannot add file descriptor {} to epoll reactor: {}", fd, std::strerror(errno));
+            m_registrations.erase(id);
+            return ZenError_Io_InitFailed;
+        }
+
+        return ZenError_None;
+    }
+
+    ZenError EpollReactor::armWrite(int fd) noexcept
+    {
+        // Does not lock the registration, as the write handler calls it while being called
+        auto registration = find(fd);
+        if (!registration)
+            return ZenError_Io_NotInitialized;
+
+        epoll_event event{};
+        event.events = EPOLLOUT | EPOLLONESHOT;
+        event.data.u64 = registration->id;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, fd, &event) == -1)
+        {
+            spdlog::error("Cannot arm file descriptor {} for writing in epoll reactor: {}", fd, std::strerror(errno));
+            return ZenError_Io_SendFailed;
+        }
+
+        return ZenError_None;
+    }
+
+    ZenError EpollReactor::setReadBufferSize(int fd, size_t readBufferSize) noexcept
+    {
+        auto registration = find(fd);
+        if (!registration)
+            return ZenError_Io_NotInitialized;
+
+        std::lock_guard<std::mutex> lock(registration->mutex);
+        registration->buffer.resize(std::clamp<size_t>(readBufferSize, 1, c_maxReadBufferSize));
+        return ZenError_None;
+    }
+
+    nonstd::expected<ZenIoStatistics, ZenError> EpollReactor::statistics(int fd) noexcept
+    {
+        auto registration = find(fd);
+        if (!registration)
+            return nonstd::make_unexpected(ZenError_Io_NotInitialized);
+
+        std::lock_guard<std::mutex> lock(registration->mutex);
+        ZenIoStatistics statistics;
+        statistics.readCount = registration->readCount;
+        statistics.bytesRead = registration->bytesRead;
+        statistics.meanReadLatencyNs = registration->readCount == 0 ? 0 : registration->totalReadLatencyNs / registration->readCount;
+        statistics.maxReadLatencyNs = registration->maxReadLatencyNs;
+        return statistics;
+    }
+
+    void EpollReactor::remove(int fd) noexcept
+    {
+        std::shared_ptr<Registration> registration;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = std::find_if(m_registrations.begin(), m_registrations.end(),
+                [fd](const auto& entry) { return entry.second->fd == fd; });
+            if (it == m_registrations.end())
+                return;
+
+            registration = std::move(it->second);
+            m_registrations.erase(it);
+        }
+
+        // A thread which already picked up an event of the file descriptor sees it inactive
+        std::lock_guard<std::mutex> lock(registration->mutex);
+        registration->active = false;
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    std::shared_ptr<EpollReactor::Registration> EpollReactor::find(int fd) noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_registrations)
+            if (entry.second->fd == fd)
+                return entry.second;
+
+        return nullptr;
+    }
+
+    void EpollReactor::run() noexcept
+    {
+        std::array<epoll_event, 16> events;
+
+        while (!m_terminate)
+        {
+            const int nEvents = ::epoll_wait(m_epollFd, events.data(), static_cast<int>(events.size()), -1);
+            if (nEvents == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                spdlog::error("Waiting for epoll events failed: {}", std::strerror(errno));
+                return;
+            }
+
+            const uint64_t wakeupTimestampNs = hostTimestampNs();
+
+            for (int idx = 0; idx < nEvents; ++idx)
+            {
+                if (events[idx].data.u64 == c_wakeupId)
+                    continue;
+
+                std::shared_ptr<Registration> registration;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto it = m_registrations.find(events[idx].data.u64);
+                    if (it == m_registrations.end())
+                        continue;
+
+                    registration = it->second;
+                }
+
+                if (registration->writeHandler)
+                    write(*registration);
+                else
+                    read(*registration, wakeupTimestampNs);
+            }
+        }
+    }
+
+    void EpollReactor::read(Registration& registration, uint64_t wakeupTimestampNs) noexcept
+    {
+        std::lock_guard<std::mutex> lock(registration.mutex);
+        if (!registration.active)
+            return;
+
+        const auto nBytesReceived = ::read(registration.fd, registration.buffer.data(), registration.buffer.size());
+        const uint64_t receivedTimestampNs = hostTimestampNs();
+
+        if (nBytesReceived > 0)
+        {
+            const uint64_t latencyNs = receivedTimestampNs - wakeupTimestampNs;
+            ++registration.readCount;
+            registration.bytesRead += static_cast<uint64_t>(nBytesReceived);
+            registration.totalReadLatencyNs += latencyNs;
+            registration.maxReadLatencyNs = std::max(registration.maxReadLatencyNs, latencyNs);
+
+            const auto data = gsl::make_span(registration.buffer.data(), static_cast<size_t>(nBytesReceived));
+            if (auto error = registration.handler->processRead(data, receivedTimestampNs))
+            {
+                spdlog::error("Stopped reading from file descriptor {} because its data could not be processed. Error: {}",
+                    registration.fd, fmt::underlying(error));
+                registration.active = false;
+                return;
+            }
+        }
+        else if (nBytesReceived == 0 || (errno != EAGAIN && errno != EINTR))
+        {
+            // A tty returns zero bytes when the device was hung up, e.g. unplugged
+            spdlog::error("Stopped reading from file descriptor {}: {}", registration.fd,
+                nBytesReceived == 0 ? "device hung up" : std::strerror(errno));
+            registration.active = false;
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.u64 = registration.id;
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, registration.fd, &event) == -1)
+        {
+            spdlog::error("Cannot rearm file descriptor {} in epoll reactor: {}", registration.fd, std::strerror(errno));
+            registration.active = false;
+        }
+    }
+
+    void EpollReactor::write(Registration& registration) noexcept
+    {
+        std::lock_guard<std::mutex> lock(registration.mutex);
+        if (!registration.active)
+            return;
+
+        // The handler rearms the file descriptor while it has data left to write
+        registration.writeHandler->processWritable();
+    }
+}
@@ -0,0 +1,153 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_IO_INTERFACES_LINUX_EPOLLREACTOR_H_
+#define ZEN_IO_INTERFACES_LINUX_EPOLLREACTOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <gsl/span>
+#include <nonstd/expected.hpp>
+
+#include "ZenTypes.h"
+
+namespace zen
+{
+    class IReactorReadHandler
+    {
+    public:
+        /** Called by a reactor thread with the bytes of one read. Reads of the same file descriptor never
+         * run concurrently. Returning an error stops reading from the file descriptor.
+         */
+        virtual ZenError processRead(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept = 0;
+    };
+
+    class IReactorWriteHandler
+    {
+    public:
+        /** Called by a reactor thread once the file descriptor became writable after EpollReactor::armWrite.
+         * Calls for the same file descriptor never run concurrently.
+         */
+        virtual void processWritable() noexcept = 0;
+    };
+
+    /**
+    Multiplexes the reads and writes of all serial devices onto a small pool of threads with
+    epoll, instead of dedicating threads to every device. Each file descriptor is registered
+    with EPOLLONESHOT, so only one thread reads from or writes to a device at a time and the
+    order of its bytes is preserved.
+
+    The reactor is shared by all devices and runs while at least one of them holds it.
+    */
+    class EpollReactor
+    {
+    public:
+        /** Number of threads started when the reactor is created */
+        constexpr static unsigned int c_defaultThreadCount = 2;
+
+        /** Bounds of the read buffers sized for a baud rate, explicit sizes may be smaller */
+        constexpr static size_t c_minReadBufferSize = 256;
+        constexpr static size_t c_maxReadBufferSize = 16384;
+
+        /** Returns the running reactor or starts a new one, nullptr if it cannot be created */
+        static std::shared_ptr<EpollReactor> shared() noexcept;
+
+        /** Sets the number of threads of reactors which are started later */
+        static ZenError setThreadCount(unsigned int count) noexcept;
+
+        /** Returns a read buffer size which holds about 10 ms of data at the baud rate (bit/s) */
+        static size_t readBufferSizeForBaudRate(unsigned int baudRate) noexcept;
+
+        ~EpollReactor();
+
+        EpollReactor(const EpollReactor&) = delete;
+        EpollReactor& operator=(const EpollReactor&) = delete;
+
+        /** Starts reading from the file descriptor, which is switched to non-blocking mode */
+        ZenError add(int fd, IReactorReadHandler& handler, size_t readBufferSize) noexcept;
+
+        /** Registers the file descriptor for writes, which is switched to non-blocking mode.
+         * The handler is only called after armWrite.
+         */
+        ZenError addWriter(int fd, IReactorWriteHandler& handler) noexcept;
+
+        /** Calls the write handler of the file descriptor once it is writable. May be called
+         * from IReactorWriteHandler::processWritable to wait for more space.
+         */
+        ZenError armWrite(int fd) noexcept;
+
+        /** Resizes the read buffer of a file descriptor, e.g. after its baud rate changed */
+        ZenError setReadBufferSize(int fd, size_t readBufferSize) noexcept;
+
+        /** Returns the statistics of the reads from a file descriptor */
+        nonstd::expected<ZenIoStatistics, ZenError> statistics(int fd) noexcept;
+
+        /** Stops reading from or writing to the file descriptor and waits for a call of its handler
+         * in progress. Must not be called from the handlers.
+         */
+        void remove(int fd) noexcept;
+
+    private:
+        struct Registration
+        {
+            int fd;
+            uint64_t id;
+            IReactorReadHandler* handler;
+            IReactorWriteHandler* writeHandler;
+            std::vector<std::byte> buffer;
+
+            // Held while calling the handler, so removing the registration waits for a call in progress
+            std::mutex mutex;
+            bool active;
+
+            uint64_t readCount;
+            uint64_t bytesRead;
+            uint64_t totalReadLatencyNs;
+            uint64_t maxReadLatencyNs;
+        };
+
+        EpollReactor(int epollFd, int wakeupFd) noexcept;
+
+        void start(unsigned int threadCount);
+
+        void run() noexcept;
+
+        /** Reads once from the registered file descriptor
+         * \param wakeupTimestampNs Host time at which the thread was woken up for the read
+         */
+        void read(Registration& registration, uint64_t wakeupTimestampNs) noexcept;
+
+        /** Lets the write handler write to the registered file descriptor */
+        void write(Registration& registration) noexcept;
+
+        /** Registers the file descriptor with epoll and the registration with the reactor */
+        ZenError add(int fd, std::shared_ptr<Registration> registration, uint32_t events) noexcept;
+
+        std::shared_ptr<Registration> find(int fd) noexcept;
+
+        const int m_epollFd;
+        const int m_wakeupFd;
+        std::atomic_bool m_terminate;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::unordered_map<uint64_t, std::shared_ptr<Registration>> m_registrations;
+        uint64_t m_nextId;
+    };
+}
+
+#endif
@@ -13,9 +13,13 @@
 #include "utility/Finally.h"
 
 #include <cstring>
+#include <future>
 
 #include <sys/errno.h>
 #include <sys/ioctl.h>
+#ifdef __linux__
+#include <sys/uio.h>
+#endif
 #ifdef __APPLE__
 #include <IOKit/serial/ioss.h>
 #endif
@@ -26,6 +30,61 @@
 
 namespace zen
 {
+#ifdef __linux__
+    namespace
+    {
+        // Frames queued beyond this are rejected, e.g. when the device stopped accepting data
+        constexpr size_t c_maxQueuedSends = 1024;
+
+        // Number of queued frames coalesced into one writev call
+        constexpr size_t c_maxCoalescedSends = 64;
+    }
+
+    PosixDeviceInterfaceImpl::PosixDeviceInterfaceImpl(IIoDataSubscriber& subscriber, std::string_view identifier, int fdRead, int fdWrite) noexcept
+        : IIoInterface(subscriber)
+        , m_identifier(identifier)
+        , m_reactor(EpollReactor::shared())
+        , m_readChunkSize(0)
+        , m_baudRate(0)
+        , m_sendOffset(0)
+        , m_writerAdded(false)
+        , m_fdRead(fdRead)
+        , m_fdWrite(fdWrite)
+    {
+        if (!m_reactor)
+        {
+            spdlog::error("Cannot read from {} without epoll reactor", m_identifier);
+            return;
+        }
+
+        if (auto error = m_reactor->add(m_fdRead, *this, EpollReactor::c_minReadBufferSize))
+            spdlog::error("Cannot read from {}. Error: {}", m_identifier, fmt::underlying(error));
+
+        // Without the writer, data is written synchronously
+        if (auto error = m_reactor->addWriter(m_fdWrite, *this))
+            spdlog::warn("Cannot queue writes to {}. Error: {}", m_identifier, fmt::underlying(error));
+        else
+            m_writerAdded = true;
+    }
+
+    PosixDeviceInterfaceImpl::~PosixDeviceInterfaceImpl()
+    {
+        if (m_reactor)
+        {
+            m_reactor->remove(m_fdRead);
+            if (m_writerAdded)
+                m_reactor->remove(m_fdWrite);
+        }
+
+        // The reactor does not write anymore, so the remaining sends fail
+        for (auto& pendingSend : m_sendQueue)
+            if (pendingSend.completion)
+                pendingSend.completion(ZenError_Io_SendFailed);
+
+        ::close(m_fdRead);
+        ::close(m_fdWrite);
+    }
+#else
     PosixDeviceInterfaceImpl::PosixDeviceInterfaceImpl(IIoDataSubscriber& subscriber, std::string_view identifier, int fdRead, int fdWrite) noexcept
         : IIoInterface(subscriber)
         , m_identifier(identifier)
@@ -45,9 +104,24 @@ namespace zen
         ::close(m_fdRead);
         ::close(m_fdWrite);
     }
+#endif
 
     ZenError PosixDeviceInterfaceImpl::send(gsl::span<const std::byte> data) noexcept
     {
+#ifdef __linux__
+        // The write file descriptor is non-blocking, so wait for the queued write
+        if (m_writerAdded)
+        {
+            std::promise<ZenError> promise;
+            auto result = promise.get_future();
+            if (auto error = sendAsync(std::vector<std::byte>(data.begin(), data.end()),
+                [&promise](ZenError error) { promise.set_value(error); }))
+                return error;
+
+            return result.get();
+        }
+#endif
+
         const auto res = ::write(m_fdWrite, data.data(), data.size());
         if (res == -1)
             return ZenError_Io_SendFailed;
@@ -69,6 +143,146 @@ namespace zen
         return true;
     }
 
+#ifdef __linux__
+    void PosixDeviceInterfaceImpl::resizeReadBuffer(unsigned int baudRate) noexcept
+    {
+        m_baudRate = baudRate;
+        if (m_reactor && m_readChunkSize == 0)
+            m_reactor->setReadBufferSize(m_fdRead, EpollReactor::readBufferSizeForBaudRate(baudRate));
+    }
+
+    void PosixDeviceInterfaceImpl::setReadChunkSize(size_t size) noexcept
+    {
+        m_readChunkSize = size;
+        if (!m_reactor)
+            return;
+
+        if (size != 0)
+            m_reactor->setReadBufferSize(m_fdRead, size);
+        else
+            m_reactor->setReadBufferSize(m_fdRead, EpollReactor::readBufferSizeForBaudRate(m_baudRate));
+    }
+
+    nonstd::expected<ZenIoStatistics, ZenError> PosixDeviceInterfaceImpl::ioStatistics() const noexcept
+    {
+        if (!m_reactor)
+            return nonstd::make_unexpected(ZenError_Io_NotInitialized);
+
+        return m_reactor->statistics(m_fdRead);
+    }
+
+    ZenError PosixDeviceInterfaceImpl::processRead(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept
+    {
+        return publishReceivedData(data, receivedTimestampNs);
+    }
+
+    ZenError PosixDeviceInterfaceImpl::sendAsync(std::vector<std::byte> data, SendCompletion completion) noexcept
+    {
+        if (!m_writerAdded)
+            return IIoInterface::sendAsync(std::move(data), std::move(completion));
+
+        if (data.empty())
+        {
+            if (completion)
+                completion(ZenError_None);
+            return ZenError_None;
+        }
+
+        bool armWrite;
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            if (m_sendQueue.size() >= c_maxQueuedSends)
+                return ZenError_Io_Busy;
+
+            // A non-empty queue is already armed, and written including this frame
+            armWrite = m_sendQueue.empty();
+            m_sendQueue.push_back(PendingSend{ std::move(data), std::move(completion) });
+        }
+
+        if (armWrite)
+            m_reactor->armWrite(m_fdWrite);
+
+        return ZenError_None;
+    }
+
+    void PosixDeviceInterfaceImpl::processWritable() noexcept
+    {
+        std::vector<PendingSend> finished;
+        ZenError result = ZenError_None;
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+
+            std::array<iovec, c_maxCoalescedSends> iov;
+            size_t nIov = 0;
+            for (auto it = m_sendQueue.begin(); it != m_sendQueue.end() && nIov < iov.size(); ++it, ++nIov)
+            {
+                const size_t offset = nIov == 0 ? m_sendOffset : 0;
+                iov[nIov].iov_base = it->data.data() + offset;
+                iov[nIov].iov_len = it->data.size() - offset;
+            }
+
+            if (nIov == 0)
+                return;
+
+            const auto nBytesWritten = ::writev(m_fdWrite, iov.data(), static_cast<int>(nIov));
+            if (nBytesWritten == -1)
+            {
+                if (errno == EAGAIN || errno == EINTR)
+                {
+                    m_reactor->armWrite(m_fdWrite);
+                    return;
+                }
+
+                spdlog::error("Cannot write to {}: {}", m_identifier, std::strerror(errno));
+                result = ZenError_Io_SendFailed;
+                finished.insert(finished.end(), std::make_move_iterator(m_sendQueue.begin()), std::make_move_iterator(m_sendQueue.end()));
+                m_sendQueue.clear();
+                m_sendOffset = 0;
+            }
+            else
+            {
+                auto remaining = static_cast<size_t>(nBytesWritten);
+                while (remaining > 0)
+                {
+                    const size_t left = m_sendQueue.front().data.size() - m_sendOffset;
+                    if (remaining < left)
+                    {
+                        m_sendOffset += remaining;
+                        break;
+                    }
+
+                    remaining -= left;
+                    m_sendOffset = 0;
+                    finished.push_back(std::move(m_sendQueue.front()));
+                    m_sendQueue.pop_front();
+                }
+
+                if (!m_sendQueue.empty())
+                    m_reactor->armWrite(m_fdWrite);
+            }
+        }
+
+        // Completions may queue the next frame
+        for (auto& pendingSend : finished)
+            if (pendingSend.completion)
+                pendingSend.completion(result);
+    }
+#else
+    void PosixDeviceInterfaceImpl::resizeReadBuffer(unsigned int) noexcept
+    {
+        // the AIO buffers have a fixed size
+    }
+
+    void PosixDeviceInterfaceImpl::setReadChunkSize(size_t) noexcept
+    {
+        // the AIO buffers have a fixed size
+    }
+
+    nonstd::expected<ZenIoStatistics, ZenError> PosixDeviceInterfaceImpl::ioStatistics() const noexcept
+    {
+        return nonstd::make_unexpected(ZenError_NotSupported);
+    }
+
     int PosixDeviceInterfaceImpl::run()
     {
         std::array<std::byte, 256> buffer1, buffer2;
@@ -100,6 +314,7 @@ namespace zen
                 return ZenError_Io_ReadFailed;
 
             const auto nBytesReceived = ::aio_return(currentCB);
+            const uint64_t receivedTimestampNs = hostTimestampNs();
 
             // Start next read, process data (if any) in parallel.
             std::swap(currentCB, lastCB);
@@ -107,7 +322,7 @@ namespace zen
                 return ZenError_Io_ReadFailed;
 
             if (nBytesReceived > 0) {
-                if (auto error = publishReceivedData(gsl::make_span((std::byte *)lastCB->aio_buf, nBytesReceived)))
+                if (auto error = publishReceivedData(gsl::make_span((std::byte *)lastCB->aio_buf, nBytesReceived), receivedTimestampNs))
                     return error;
             }
         }
@@ -118,4 +333,5 @@ namespace zen
 
         return ZenError_None;
     }
+#endif
 }
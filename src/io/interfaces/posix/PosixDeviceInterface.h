@@ -13,19 +13,27 @@
 
 #include <array>
 #include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <thread>
 
+#ifdef __linux__
+#include "io/interfaces/linux/EpollReactor.h"
+#else
 #include <aio.h>
+#endif
 
 #include "io/IIoInterface.h"
 
 namespace zen
 {
     /*
-    The Linux device interface uses the POSIX Asynchronous IO interface
-    to read from a virtual com port device. If an LPMS sensor gets connected,
+    The Linux device interface reads from a virtual com port device with the
+    EpollReactor shared by all devices, on other POSIX systems it uses the
+    POSIX Asynchronous IO interface. If an LPMS sensor gets connected,
     the linux cp210x will map the USB device to a file in /dev/ttyUSB
     which is opened by this sub-system.
 
@@ -35,7 +43,11 @@ namespace zen
     sudo usermod -a -G tty <user name>
 
     */
+#ifdef __linux__
+    class PosixDeviceInterfaceImpl : public IIoInterface, private IReactorReadHandler, private IReactorWriteHandler
+#else
     class PosixDeviceInterfaceImpl : public IIoInterface
+#endif
     {
     public:
         PosixDeviceInterfaceImpl(IIoDataSubscriber& subscriber, std::string_view identifier, int fdRead, int fdWrite) noexcept;
@@ -44,16 +56,58 @@ namespace zen
         /** Send data to IO interface */
         ZenError send(gsl::span<const std::byte> data) noexcept override;
 
+#ifdef __linux__
+        /** Queues data to be written by the epoll reactor. Frames queued while a write is
+         * pending are coalesced into one writev call.
+         */
+        ZenError sendAsync(std::vector<std::byte> data, SendCompletion completion = nullptr) noexcept override;
+#endif
+
         /** Returns whether the IO interface equals the sensor description */
         bool equals(const ZenSensorDesc& desc) const noexcept override;
 
+        /** Returns statistics of the reads from the device */
+        nonstd::expected<ZenIoStatistics, ZenError> ioStatistics() const noexcept override;
+
+        /** Reads at most this many bytes at once, instead of sizing the reads for the baud rate.
+         * Zero sizes the reads for the baud rate again.
+         */
+        void setReadChunkSize(size_t size) noexcept;
+
+    protected:
+        /** Adapts the size of the read buffer to the new baud rate (bit/s) */
+        void resizeReadBuffer(unsigned int baudRate) noexcept;
+
     private:
+#ifdef __linux__
+        ZenError processRead(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept override;
+
+        void processWritable() noexcept override;
+
+        struct PendingSend
+        {
+            std::vector<std::byte> data;
+            SendCompletion completion;
+        };
+#else
         int run();
+#endif
 
         std::string m_identifier;
 
+#ifdef __linux__
+        std::shared_ptr<EpollReactor> m_reactor;
+        std::atomic_size_t m_readChunkSize;
+        std::atomic_uint m_baudRate;
+
+        std::mutex m_sendMutex;
+        std::deque<PendingSend> m_sendQueue;
+        size_t m_sendOffset; // bytes of the front of the send queue which were written already
+        bool m_writerAdded;
+#else
         std::atomic_bool m_terminate;
         std::thread m_pollingThread;
+#endif
 
     protected:
         int m_fdRead, m_fdWrite;
@@ -86,6 +140,7 @@ namespace zen
                 return error;
 
             m_baudRate = speed;
+            resizeReadBuffer(rate);
             return ZenError_None;
         }
 
@@ -123,8 +123,9 @@ namespace zen
             if (!::ReadFile(m_handle, m_buffer.data(), static_cast<DWORD>(m_buffer.size()), &nBytesRead, nullptr))
                 return ZenError_Io_ReadFailed;
 
+            const uint64_t receivedTimestampNs = hostTimestampNs();
             if (nBytesRead > 0)
-                if (auto error = publishReceivedData(gsl::make_span(m_buffer.data(), nBytesRead)))
+                if (auto error = publishReceivedData(gsl::make_span(m_buffer.data(), nBytesRead), receivedTimestampNs))
                     return error;
         }
 
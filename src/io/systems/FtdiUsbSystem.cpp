@@ -66,7 +66,7 @@ namespace zen
 
         for (DWORD i = 0; i < nDevices; ++i)
         {
-            ZenSensorDesc desc;
+            ZenSensorDesc desc{};
             if (!FT_SUCCESS(fnTable.listDevices(&i, desc.name, FT_LIST_BY_INDEX | FT_OPEN_BY_DESCRIPTION)))
                 return ZenError_Unknown;
 
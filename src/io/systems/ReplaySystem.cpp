@@ -0,0 +1,41 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "io/systems/ReplaySystem.h"
+
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "io/IoCapture.h"
+#include "io/interfaces/ReplayInterface.h"
+
+namespace zen
+{
+    ZenError ReplaySystem::listDevices(std::vector<ZenSensorDesc>&)
+    {
+        return ZenError_None;
+    }
+
+    nonstd::expected<std::unique_ptr<IIoInterface>, ZenSensorInitError> ReplaySystem::obtain(const ZenSensorDesc& desc, IIoDataSubscriber& subscriber) noexcept
+    {
+        const std::string identifier(desc.identifier);
+        const std::string strFast = "fast:";
+        const bool fast = identifier.rfind(strFast, 0) == 0;
+        const std::string path = IoCapture::resolve(fast ? identifier.substr(strFast.size()) : identifier);
+
+        auto records = IoCapture::load(path);
+        if (!records)
+            return nonstd::make_unexpected(ZenSensorInitError_UnknownIdentifier);
+
+        spdlog::info("Replaying {} records of {}{}", records->size(), path, fast ? " as fast as possible" : "");
+        return std::make_unique<ReplayInterface>(subscriber, identifier, std::move(*records), fast);
+    }
+}
@@ -0,0 +1,41 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_IO_SYSTEMS_REPLAYSYSTEM_H_
+#define ZEN_IO_SYSTEMS_REPLAYSYSTEM_H_
+
+#include "io/IIoSystem.h"
+
+namespace zen
+{
+    /**
+    Replays IO captures, see ZenSetIoCaptureDirectory. The identifier is the path of the capture
+    file, relative ones are looked up in the capture directory. It is played back at its captured timing:
+     * LinuxDevice-0001a2b3c4d5e6f7.zencap
+     * /home/user/recorded-sessions/LinuxDevice-0001a2b3c4d5e6f7.zencap
+    or as fast as possible when prefixed with fast:
+     * fast:LinuxDevice-0001a2b3c4d5e6f7.zencap
+    */
+    class ReplaySystem : public IIoSystem
+    {
+    public:
+        constexpr static const char KEY[] = "Replay";
+
+        bool available() override { return true; }
+
+        // this system won't list any devices to connect to, ZenObtainSensor has
+        // to be used with the path of a capture
+        ZenError listDevices(std::vector<ZenSensorDesc>& outDevices) override;
+
+        nonstd::expected<std::unique_ptr<IIoInterface>, ZenSensorInitError> obtain(const ZenSensorDesc& desc, IIoDataSubscriber& subscriber) noexcept override;
+    };
+}
+
+#endif
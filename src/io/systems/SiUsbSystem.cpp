@@ -167,7 +167,7 @@ namespace zen
 
         for (DWORD idx = 0; idx < nDevices; ++idx)
         {
-            ZenSensorDesc desc;
+            ZenSensorDesc desc{};
             if (auto error = SiUsbSystem::fnTable.getProductStringSafe(idx, desc.name, sizeof(ZenSensorDesc::name), SI_RETURN_SERIAL_NUMBER))
                 return ZenError_Io_GetFailed;
 
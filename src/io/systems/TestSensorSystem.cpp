@@ -18,9 +18,13 @@ namespace zen
     namespace
     {
         nonstd::expected<std::unique_ptr<IIoEventInterface>, ZenSensorInitError> make_interface(IIoEventSubscriber& subscriber,
-             std::string const& endpoint)
+             std::string const& identifier)
         {
-            return std::make_unique<TestSensorInterface>(subscriber, endpoint);
+            auto config = TestSensorConfig::parse(identifier);
+            if (!config)
+                return nonstd::make_unexpected(config.error());
+
+            return std::make_unique<TestSensorInterface>(subscriber, identifier, *config);
         }
     }
 
@@ -32,7 +32,9 @@ namespace zen
         bool isHighLevel() override { return true; }
 
         // this system won't list any devices to connect to, ZenObtainSensorByName can
-        // be used to use TestSensor
+        // be used to use TestSensor. The identifier configures the rate, payload and
+        // waveform of its data, see TestSensorConfig. Sensors with different identifiers,
+        // e.g. "instance=1" and "instance=2", are separate instances.
         ZenError listDevices(std::vector<ZenSensorDesc>& outDevices) override;
 
         /** If succesful, obtains the IO interface for the provided sensor description. Otherwise, returns an error. */
@@ -0,0 +1,341 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "io/systems/linux/LinuxDeviceMonitor.h"
+
+#include "io/systems/linux/LinuxDeviceQuery.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+namespace zen
+{
+    namespace
+    {
+        // Multicast group of the kernel, udev re-broadcasts on group 2 with its own header
+        constexpr uint32_t c_kernelUeventGroup = 1;
+
+        // Uevents are limited to a page by the kernel
+        constexpr size_t c_maxUeventSize = 8192;
+
+        int openUeventSocket() noexcept
+        {
+            const int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+            if (fd == -1)
+            {
+                spdlog::warn("Cannot open uevent socket, devices are rescanned for every query: {}", std::strerror(errno));
+                return -1;
+            }
+
+            sockaddr_nl address{};
+            address.nl_family = AF_NETLINK;
+            address.nl_groups = c_kernelUeventGroup;
+            if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == -1)
+            {
+                spdlog::warn("Cannot bind uevent socket, devices are rescanned for every query: {}", std::strerror(errno));
+                ::close(fd);
+                return -1;
+            }
+
+            return fd;
+        }
+    }
+
+    std::optional<Uevent> Uevent::parse(gsl::span<const char> message) noexcept
+    {
+        const std::string_view text(message.data(), message.size());
+
+        // The header "action@devpath" is followed by the same information as key-value pairs
+        const auto headerEnd = text.find('\0');
+        if (headerEnd == std::string_view::npos || text.substr(0, headerEnd).find('@') == std::string_view::npos)
+            return std::nullopt;
+
+        Uevent uevent;
+        size_t begin = headerEnd + 1;
+        while (begin < text.size())
+        {
+            auto end = text.find('\0', begin);
+            if (end == std::string_view::npos)
+                end = text.size();
+
+            const auto entry = text.substr(begin, end - begin);
+            const auto separator = entry.find('=');
+            if (separator != std::string_view::npos)
+            {
+                const auto key = entry.substr(0, separator);
+                const auto value = entry.substr(separator + 1);
+                if (key == "ACTION")
+                    uevent.action = value;
+                else if (key == "SUBSYSTEM")
+                    uevent.subsystem = value;
+                else if (key == "DEVPATH")
+                    uevent.devPath = value;
+                else if (key == "DEVNAME")
+                    uevent.devName = value;
+            }
+
+            begin = end + 1;
+        }
+
+        if (uevent.action.empty() || uevent.devPath.empty())
+            return std::nullopt;
+
+        return uevent;
+    }
+
+    std::unique_ptr<LinuxDeviceMonitor> LinuxDeviceMonitor::create(Callback callback, std::string sysfsRoot) noexcept
+    {
+        // The socket is opened before the scan, so no device which appears in between is missed
+        int socketFd = openUeventSocket();
+
+        int wakeupFd = -1;
+        if (socketFd != -1)
+        {
+            wakeupFd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if (wakeupFd == -1)
+            {
+                spdlog::warn("Cannot create wakeup eventfd of device monitor, devices are rescanned for every query: {}",
+                    std::strerror(errno));
+                ::close(socketFd);
+                socketFd = -1;
+            }
+        }
+
+        return std::unique_ptr<LinuxDeviceMonitor>(
+            new LinuxDeviceMonitor(std::move(callback), std::move(sysfsRoot), socketFd, wakeupFd));
+    }
+
+    LinuxDeviceMonitor::LinuxDeviceMonitor(Callback callback, std::string sysfsRoot, int socketFd, int wakeupFd) noexcept
+        : m_callback(std::move(callback))
+        , m_sysfsRoot(std::move(sysfsRoot))
+        , m_socketFd(socketFd)
+        , m_wakeupFd(wakeupFd)
+        , m_terminate(false)
+    {
+        if (monitoring())
+        {
+            m_devices = scan();
+            m_thread = std::thread(&LinuxDeviceMonitor::run, this);
+        }
+    }
+
+    LinuxDeviceMonitor::~LinuxDeviceMonitor()
+    {
+        if (!monitoring())
+            return;
+
+        m_terminate = true;
+        const uint64_t increment = 1;
+        [[maybe_unused]] const auto result = ::write(m_wakeupFd, &increment, sizeof(increment));
+        m_thread.join();
+
+        ::close(m_wakeupFd);
+        ::close(m_socketFd);
+    }
+
+    std::vector<LinuxDeviceMonitor::Device> LinuxDeviceMonitor::devices() const noexcept
+    {
+        std::vector<Device> devices;
+        if (monitoring())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : m_devices)
+                devices.push_back({ entry.second, entry.first });
+        }
+        else
+        {
+            for (const auto& entry : scan())
+                devices.push_back({ entry.second, entry.first });
+        }
+
+        std::stable_sort(devices.begin(), devices.end(),
+            [](const Device& lhs, const Device& rhs) { return lhs.serialNumber < rhs.serialNumber; });
+        return devices;
+    }
+
+    std::vector<std::string> LinuxDeviceMonitor::deviceFiles(std::string_view serialNumber) const noexcept
+    {
+        std::vector<std::string> deviceFiles;
+        for (const auto& device : devices())
+            if (device.serialNumber == serialNumber)
+                deviceFiles.push_back(device.deviceFile);
+
+        return deviceFiles;
+    }
+
+    void LinuxDeviceMonitor::processUevent(const Uevent& uevent) noexcept
+    {
+        if (uevent.subsystem != "tty" || uevent.devName.empty())
+            return;
+
+        const std::string deviceFile = "/dev/" + uevent.devName;
+
+        std::optional<Device> changed;
+        bool added = false;
+        if (uevent.action == "add")
+        {
+            auto serialNumber = serialNumberOfTty(uevent.devPath);
+            if (!serialNumber)
+                return;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto [it, inserted] = m_devices.insert_or_assign(deviceFile, *serialNumber);
+            if (inserted)
+            {
+                changed = Device{ it->second, it->first };
+                added = true;
+            }
+        }
+        else if (uevent.action == "remove")
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_devices.find(deviceFile);
+            if (it == m_devices.end())
+                return;
+
+            changed = Device{ it->second, it->first };
+            m_devices.erase(it);
+        }
+
+        // The callback is called without holding the table, so it can query it
+        if (changed)
+        {
+            spdlog::info("Serial device {} with serial number {} was {}", changed->deviceFile, changed->serialNumber,
+                added ? "added" : "removed");
+
+            if (m_callback)
+                m_callback(*changed, added);
+        }
+    }
+
+    void LinuxDeviceMonitor::run() noexcept
+    {
+        std::array<pollfd, 2> fds{};
+        fds[0].fd = m_socketFd;
+        fds[0].events = POLLIN;
+        fds[1].fd = m_wakeupFd;
+        fds[1].events = POLLIN;
+
+        std::array<char, c_maxUeventSize> buffer;
+        while (!m_terminate)
+        {
+            if (::poll(fds.data(), fds.size(), -1) == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                spdlog::error("Waiting for uevents failed: {}", std::strerror(errno));
+                return;
+            }
+
+            if (!(fds[0].revents & POLLIN))
+                continue;
+
+            sockaddr_nl sender{};
+            iovec vector{ buffer.data(), buffer.size() };
+            msghdr header{};
+            header.msg_name = &sender;
+            header.msg_namelen = sizeof(sender);
+            header.msg_iov = &vector;
+            header.msg_iovlen = 1;
+
+            const auto nBytes = ::recvmsg(m_socketFd, &header, MSG_DONTWAIT);
+            if (nBytes == -1)
+            {
+                // The kernel drops uevents when the socket buffer overflows, a rescan recovers them
+                if (errno == ENOBUFS)
+                {
+                    spdlog::warn("Uevents were lost, rescanning devices");
+                    rescan();
+                }
+                continue;
+            }
+
+            // Only the kernel is trusted, other processes could send forged uevents
+            if (sender.nl_pid != 0)
+                continue;
+
+            if (auto uevent = Uevent::parse(gsl::span<const char>(buffer.data(), static_cast<size_t>(nBytes))))
+                processUevent(*uevent);
+        }
+    }
+
+    void LinuxDeviceMonitor::rescan() noexcept
+    {
+        auto devices = scan();
+
+        std::vector<std::pair<Device, bool>> changes;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : m_devices)
+            {
+                auto it = devices.find(entry.first);
+                if (it == devices.end() || it->second != entry.second)
+                    changes.emplace_back(Device{ entry.second, entry.first }, false);
+            }
+            for (const auto& entry : devices)
+            {
+                auto it = m_devices.find(entry.first);
+                if (it == m_devices.end() || it->second != entry.second)
+                    changes.emplace_back(Device{ entry.second, entry.first }, true);
+            }
+            m_devices = std::move(devices);
+        }
+
+        if (m_callback)
+            for (const auto& change : changes)
+                m_callback(change.first, change.second);
+    }
+
+    std::map<std::string, std::string> LinuxDeviceMonitor::scan() const noexcept
+    {
+        std::map<std::string, std::string> devices;
+        try
+        {
+            for (const auto& serialDevices : LinuxDeviceQuery::getSiLabsDevices(fs::path(m_sysfsRoot) / "bus/usb/devices"))
+                for (const auto& deviceFile : serialDevices.second)
+                    devices.emplace(deviceFile, serialDevices.first);
+        }
+        catch (const fs::filesystem_error& e)
+        {
+            spdlog::error("Cannot scan USB devices in sysfs: {}", e.what());
+        }
+
+        return devices;
+    }
+
+    std::optional<std::string> LinuxDeviceMonitor::serialNumberOfTty(std::string_view devPath) const noexcept
+    {
+        // The USB device is an ancestor of the tty, e.g. .../1-6 of .../1-6/1-6:1.0/ttyUSB0/tty/ttyUSB0
+        fs::path path = fs::path(m_sysfsRoot) / fs::path(devPath).relative_path();
+        for (; path.has_relative_path() && path != fs::path(m_sysfsRoot); path = path.parent_path())
+        {
+            if (!LinuxDeviceQuery::sysFsGetDeviceProperty(path, "idVendor"))
+                continue;
+
+            if (!LinuxDeviceQuery::isSiLabsDevice(path))
+                return std::nullopt;
+
+            return LinuxDeviceQuery::sysFsGetDeviceProperty(path, "serial");
+        }
+
+        return std::nullopt;
+    }
+}
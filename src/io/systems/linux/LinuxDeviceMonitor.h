@@ -0,0 +1,113 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_IO_SYSTEMS_LINUX_LINUXDEVICEMONITOR_H_
+#define ZEN_IO_SYSTEMS_LINUX_LINUXDEVICEMONITOR_H_
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gsl/span>
+
+namespace zen
+{
+    /** Fields of a kernel uevent which the LinuxDeviceMonitor uses */
+    struct Uevent
+    {
+        std::string action;
+        std::string subsystem;
+        std::string devPath;
+        std::string devName;
+
+        /** Parses a NETLINK_KOBJECT_UEVENT message of the kernel, "action@devpath" followed by
+         * null-terminated KEY=value pairs. Messages of udev are not parsed.
+         */
+        static std::optional<Uevent> parse(gsl::span<const char> message) noexcept;
+    };
+
+    /**
+    Keeps a table of the SiLabs USB serial devices of the system, so listing and obtaining sensors
+    does not walk all of sysfs. The table is filled by one scan of sysfs and kept current by the
+    hotplug events of the kernel, which are received from a NETLINK_KOBJECT_UEVENT socket. Only the
+    sysfs directory of a device which appears is read.
+
+    If the socket cannot be opened, e.g. in a container without network namespace access, every
+    query rescans sysfs like before.
+    */
+    class LinuxDeviceMonitor
+    {
+    public:
+        struct Device
+        {
+            std::string serialNumber;
+            // e.g. /dev/ttyUSB0
+            std::string deviceFile;
+        };
+
+        /** Called from the monitor thread when a device appeared (true) or disappeared (false) */
+        using Callback = std::function<void(const Device&, bool)>;
+
+        /** Starts monitoring the devices, sysfsRoot can be replaced by a prepared directory for tests. Never returns nullptr. */
+        static std::unique_ptr<LinuxDeviceMonitor> create(Callback callback, std::string sysfsRoot = "/sys") noexcept;
+
+        ~LinuxDeviceMonitor();
+
+        LinuxDeviceMonitor(const LinuxDeviceMonitor&) = delete;
+        LinuxDeviceMonitor& operator=(const LinuxDeviceMonitor&) = delete;
+
+        /** Returns all devices, sorted by their serial number */
+        std::vector<Device> devices() const noexcept;
+
+        /** Returns the device files of a serial number, which can in principle appear on multiple devices */
+        std::vector<std::string> deviceFiles(std::string_view serialNumber) const noexcept;
+
+        /** Whether hotplug events keep the table current, otherwise every query rescans sysfs */
+        bool monitoring() const noexcept { return m_socketFd != -1; }
+
+        /** Updates the table with a uevent, called by the monitor thread for every message */
+        void processUevent(const Uevent& uevent) noexcept;
+
+    private:
+        LinuxDeviceMonitor(Callback callback, std::string sysfsRoot, int socketFd, int wakeupFd) noexcept;
+
+        void run() noexcept;
+
+        /** Replaces the table by a scan of sysfs and reports the differences */
+        void rescan() noexcept;
+
+        /** Returns the devices found in sysfs */
+        std::map<std::string, std::string> scan() const noexcept;
+
+        /** Finds the serial number of the SiLabs USB device which a tty belongs to */
+        std::optional<std::string> serialNumberOfTty(std::string_view devPath) const noexcept;
+
+        const Callback m_callback;
+        const std::string m_sysfsRoot;
+        const int m_socketFd;
+        const int m_wakeupFd;
+
+        // Serial number of every device file
+        mutable std::mutex m_mutex;
+        std::map<std::string, std::string> m_devices;
+
+        std::atomic_bool m_terminate;
+        std::thread m_thread;
+    };
+}
+
+#endif
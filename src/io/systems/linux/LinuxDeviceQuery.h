@@ -41,7 +41,7 @@ typedef std::map<std::string, std::vector<std::string>> SiLabsSerialDevices;
 /**
  * Returns the contents of a device in the sysfs tree
  */
-std::optional<std::string> sysFsGetDeviceProperty(fs::path const& devicePath,
+inline std::optional<std::string> sysFsGetDeviceProperty(fs::path const& devicePath,
     std::string const& propertyName) {
     std::ifstream propFile;
 
@@ -61,7 +61,7 @@ std::optional<std::string> sysFsGetDeviceProperty(fs::path const& devicePath,
  * Gets the topmost folder of a sysfs usb device and traverses it to find the name of
  * the tty device assicated.
  */
-std::optional<fs::path> sysFsGetDeviceTtyPath(fs::path const& devicePath) {
+inline std::optional<fs::path> sysFsGetDeviceTtyPath(fs::path const& devicePath) {
     for (auto &p : fs::directory_iterator(devicePath))
     {
         // p is something like /sys/bus/usb/devices/1-6/1-6:1.0
@@ -91,7 +91,7 @@ std::optional<fs::path> sysFsGetDeviceTtyPath(fs::path const& devicePath) {
 /**
  * Returns true if a sysfs USB device is a SiLabs CP210x UART interface chip
  */
-bool isSiLabsDevice(std::string const& devicePath ) {
+inline bool isSiLabsDevice(fs::path const& devicePath) {
     auto vendor = sysFsGetDeviceProperty(devicePath, "idVendor");
     auto product = sysFsGetDeviceProperty(devicePath, "idProduct");
 
@@ -120,10 +120,9 @@ bool isSiLabsDevice(std::string const& devicePath ) {
  * and the serial devices (like "/dev/ttyUSB0") assicated with them.
  * One serial string can in principle appear on multiple devices.
  */
-SiLabsSerialDevices getSiLabsDevices()
+inline SiLabsSerialDevices getSiLabsDevices(fs::path const& sysfs_usb_path = "/sys/bus/usb/devices/")
 {
     SiLabsSerialDevices found_devices;
-    const std::string sysfs_usb_path = "/sys/bus/usb/devices/";
     // list all connected usb devices
     for (auto &usb_device : fs::directory_iterator(sysfs_usb_path))
     {
@@ -151,7 +150,7 @@ SiLabsSerialDevices getSiLabsDevices()
  * specific serial string of SiLabs chip.
  * One serial number can in principle appear on multiple devices.
 */
-std::vector<std::string> getDeviceFileForSiLabsSerial(std::string const &serial_string)
+inline std::vector<std::string> getDeviceFileForSiLabsSerial(std::string const &serial_string)
 {
     auto devices = getSiLabsDevices();
 
@@ -9,27 +9,35 @@
 //===========================================================================//
 
 
-#include "io/systems/linux/LinuxDeviceQuery.h"
 #include "io/systems/linux/LinuxDeviceSystem.h"
 
 #include "io/interfaces/posix/PosixDeviceInterface.h"
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
 
+// termios2 replaces <termios.h>, whose struct termios cannot hold arbitrary baud rates
+#include <asm/termbits.h>
 #include <fcntl.h>
-#include <termios.h>
+#include <linux/serial.h>
+#include <sys/ioctl.h>
 #include <unistd.h>
 
 namespace zen
 {
     namespace
     {
+        constexpr int64_t c_maxBaudRateDeviationPercent = 3;
+
         ZenSensorInitError setupFD(int fd)
         {
-            struct termios config;
-            if (-1 == ::tcgetattr(fd, &config))
+            struct termios2 config;
+            if (-1 == ::ioctl(fd, TCGETS2, &config))
                 return ZenSensorInitError_IoFailed;
 
             config.c_iflag &= ~(IGNBRK | IXANY | INLCR | IGNCR | ICRNL);
@@ -47,46 +55,100 @@ namespace zen
             config.c_cc[VMIN] = 0;                // read doesnt block
             config.c_cc[VTIME] = 5;               // 0.5 seconds read timeout
 
-            if (-1 == ::tcsetattr(fd, TCSANOW, &config))
+            if (-1 == ::ioctl(fd, TCSETS2, &config))
                 return ZenSensorInitError_IoFailed;
 
             return ZenSensorInitError_None;
         }
-    }
-
-    ZenError LinuxDeviceSystem::listDevices(std::vector<ZenSensorDesc>& outDevices)
-    {
-        // LPMS sensors use SiLabs UART interface chips, this call will list them
-        // with all their serial names coming directly from the USB SiLabs driver
-        const auto siLabsDevices = LinuxDeviceQuery::getSiLabsDevices();
 
-        for (const auto& siLabsSerialDevs : siLabsDevices ) {
-            // one serial name can be on multiple ports
-            for (const auto& siLabsDevs: siLabsSerialDevs.second) {
-                ZenSensorDesc desc;
-                auto const siLabsSerialNumber = siLabsSerialDevs.first;
+        ZenSensorDesc makeDesc(const LinuxDeviceMonitor::Device& device, uint32_t baudRate) noexcept
+        {
+            ZenSensorDesc desc{};
+            const auto& serialNumber = device.serialNumber;
+            const auto serialNumberSize = std::min(serialNumber.size(), sizeof(desc.serialNumber) - 1);
+            std::memcpy(desc.name, serialNumber.c_str(), serialNumberSize);
+            std::memcpy(desc.serialNumber, serialNumber.c_str(), serialNumberSize);
 
-                std::memcpy(desc.name, siLabsSerialNumber.c_str(), siLabsSerialNumber.size());
-                desc.name[siLabsSerialNumber.size()] = '\0';
+            std::memcpy(desc.ioType, LinuxDeviceSystem::KEY, sizeof(LinuxDeviceSystem::KEY));
 
-                std::memcpy(desc.serialNumber, siLabsSerialNumber.c_str(), siLabsSerialNumber.size());
-                desc.serialNumber[siLabsSerialNumber.size()] = '\0';
+            // output the device path (like "/dev/ttyUSB0") just for additional information
+            const auto deviceFileSize = std::min(device.deviceFile.size(), sizeof(desc.identifier) - 1);
+            std::memcpy(desc.identifier, device.deviceFile.c_str(), deviceFileSize);
 
-                std::memcpy(desc.ioType, LinuxDeviceSystem::KEY, sizeof(LinuxDeviceSystem::KEY));
+            desc.baudRate = baudRate;
+            return desc;
+        }
 
-                // output the device path (like "/dev/ttyUSB0") just for additional information
-                std::memcpy(desc.identifier, siLabsDevs.c_str(), siLabsDevs.size());
-                desc.identifier[siLabsDevs.size()] = '\0';
+        void enableLowLatency(int fd, const std::string& ttyDevice)
+        {
+            // The driver pushes received bytes to the tty immediately instead of batching them
+            struct serial_struct serial;
+            if (-1 == ::ioctl(fd, TIOCGSERIAL, &serial))
+            {
+                spdlog::warn("Cannot get serial configuration of {}, low latency mode is not enabled: {}",
+                    ttyDevice, std::strerror(errno));
+                return;
+            }
 
-                desc.baudRate = getDefaultBaudrate();
+            serial.flags |= ASYNC_LOW_LATENCY;
+            if (-1 == ::ioctl(fd, TIOCSSERIAL, &serial))
+                spdlog::warn("Cannot enable low latency mode of {}: {}", ttyDevice, std::strerror(errno));
+        }
 
-                outDevices.emplace_back(desc);
+        void setUsbLatencyTimer(const std::string& ttyDevice, uint32_t latencyMs)
+        {
+            // Only USB serial drivers with a latency timer, e.g. ftdi_sio, expose it in sysfs
+            char* realPath = ::realpath(ttyDevice.c_str(), nullptr);
+            if (realPath == nullptr)
+            {
+                spdlog::warn("Cannot resolve device file {} to set its USB latency timer", ttyDevice);
+                return;
             }
+
+            const std::string devicePath(realPath);
+            std::free(realPath);
+
+            const std::string ttyName = devicePath.substr(devicePath.rfind('/') + 1);
+            const std::string timerPath = "/sys/class/tty/" + ttyName + "/device/latency_timer";
+
+            std::ofstream timer(timerPath);
+            if (!(timer << latencyMs << std::flush))
+                spdlog::warn("Cannot set USB latency timer of {}, {} is not writable", ttyDevice, timerPath);
         }
+    }
+
+    ZenError LinuxDeviceSystem::listDevices(std::vector<ZenSensorDesc>& outDevices)
+    {
+        // LPMS sensors use SiLabs UART interface chips, the monitor lists them
+        // with all their serial names coming directly from the USB SiLabs driver.
+        // One serial name can be on multiple ports.
+        for (const auto& device : monitor().devices())
+            outDevices.emplace_back(makeDesc(device, getDefaultBaudrate()));
 
         return ZenError_None;
     }
 
+    LinuxDeviceMonitor& LinuxDeviceSystem::monitor() noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_monitorMutex);
+        if (!m_monitor)
+        {
+            const uint32_t baudRate = getDefaultBaudrate();
+            m_monitor = LinuxDeviceMonitor::create([this, baudRate](const LinuxDeviceMonitor::Device& device, bool added) {
+                if (auto listener = m_listener.load())
+                {
+                    const auto desc = makeDesc(device, baudRate);
+                    if (added)
+                        listener->deviceAdded(desc);
+                    else
+                        listener->deviceRemoved(desc);
+                }
+            });
+        }
+
+        return *m_monitor;
+    }
+
     nonstd::expected<std::unique_ptr<IIoInterface>, ZenSensorInitError> LinuxDeviceSystem::obtain(
         const ZenSensorDesc& desc, IIoDataSubscriber& subscriber) noexcept
     {
@@ -97,14 +159,14 @@ namespace zen
             serialNumberConnectTo = std::string(desc.identifier);
         }
 
-        const auto ttyDevices = [serialNumberConnectTo]() -> std::vector<std::string> {
+        const auto ttyDevices = [this, serialNumberConnectTo]() -> std::vector<std::string> {
             const std::string strDeviceFile = "devicefile:";
             if (serialNumberConnectTo.rfind(strDeviceFile, 0) == 0) {
                 const auto stDeviceFile = serialNumberConnectTo.substr(strDeviceFile.size());
                 spdlog::info("Connecting directly to devicefile {0}", stDeviceFile);
                 return {stDeviceFile};
             } else {
-                return LinuxDeviceQuery::getDeviceFileForSiLabsSerial(serialNumberConnectTo);
+                return monitor().deviceFiles(serialNumberConnectTo);
             }
         }();
 
@@ -120,118 +182,80 @@ namespace zen
 
         const auto ttyDevice = ttyDevices[0];
 
+        const auto& options = desc.serialOptions;
+        const bool lowLatency = (options.flags & ZenSerialIoFlags_LowLatency) != 0;
+
+        // O_SYNC makes every write wait for the transmission, which delays commands in low latency mode
+        const int syncFlag = lowLatency ? 0 : O_SYNC;
+
         spdlog::info("Opening file {} for sensor communication", ttyDevice);
-        const int fdRead = ::open(ttyDevice.data(), O_RDONLY | O_NOCTTY | O_SYNC);
-        const int fdWrite = ::open(ttyDevice.data(), O_WRONLY | O_NOCTTY | O_SYNC);
+        const int fdRead = ::open(ttyDevice.data(), O_RDONLY | O_NOCTTY | syncFlag);
+        const int fdWrite = ::open(ttyDevice.data(), O_WRONLY | O_NOCTTY | syncFlag);
         if (fdRead == -1 || fdWrite == -1) {
             spdlog::error("Error while opening file {} for sensor communication", ttyDevice);
             return nonstd::make_unexpected(ZenSensorInitError_InvalidAddress);
         }
-        
+
+        if (lowLatency)
+            enableLowLatency(fdRead, ttyDevice);
+        if (options.usbLatencyTimerMs != 0)
+            setUsbLatencyTimer(ttyDevice, options.usbLatencyTimerMs);
+
+        // the port has to be raw before the interface starts reading
+        for (const int fd : { fdRead, fdWrite }) {
+            if (ZenSensorInitError error = setupFD(fd); error != ZenSensorInitError_None) {
+                ::close(fdRead);
+                ::close(fdWrite);
+                return nonstd::make_unexpected(error);
+            }
+        }
+
         auto ioInterface = std::make_unique<PosixDeviceInterface<LinuxDeviceSystem>>(subscriber, ttyDevice, fdRead, fdWrite);
+        if (options.readChunkSize != 0)
+            ioInterface->setReadChunkSize(options.readChunkSize);
 
-        if (ZenSensorInitError error = setupFD(fdRead); error != ZenSensorInitError_None)
-            return nonstd::make_unexpected(error);
-        if (ZenSensorInitError error = setupFD(fdWrite); error != ZenSensorInitError_None)
-            return nonstd::make_unexpected(error);
         return std::move(ioInterface);
     }
 
     nonstd::expected<std::vector<int32_t>, ZenError> LinuxDeviceSystem::supportedBaudRates() noexcept
     {
-        std::vector<int32_t> baudRates;
-        baudRates.reserve(22);
-
-        baudRates.emplace_back(50);
-        baudRates.emplace_back(75);
-        baudRates.emplace_back(110);
-        baudRates.emplace_back(134);
-        baudRates.emplace_back(150);
-        baudRates.emplace_back(200);
-        baudRates.emplace_back(300);
-        baudRates.emplace_back(600);
-        baudRates.emplace_back(1200);
-        baudRates.emplace_back(1800);
-        baudRates.emplace_back(2400);
-        baudRates.emplace_back(4800);
-        baudRates.emplace_back(9600);
-        baudRates.emplace_back(19200);
-        baudRates.emplace_back(38400);
-        baudRates.emplace_back(57600);
-        baudRates.emplace_back(115200);
-        baudRates.emplace_back(230400);
-        baudRates.emplace_back(460800);
-        baudRates.emplace_back(500000);
-        baudRates.emplace_back(576000);
-        baudRates.emplace_back(921600);
-
-        return baudRates;
-    }
-
-    constexpr int32_t LinuxDeviceSystem::mapBaudRate(unsigned int baudRate) noexcept
-    {
-        if (baudRate > 576000)
-            return B921600;
-        else if (baudRate > 500000)
-            return B576000;
-        else if (baudRate > 460800)
-            return B500000;
-        else if (baudRate > 230400)
-            return B460800;
-        else if (baudRate > 115200)
-            return B230400;
-        else if (baudRate > 57600)
-            return B115200;
-        else if (baudRate > 38400)
-            return B57600;
-        else if (baudRate > 19200)
-            return B38400;
-        else if (baudRate > 9600)
-            return B19200;
-        else if (baudRate > 4800)
-            return B9600;
-        else if (baudRate > 2400)
-            return B4800;
-        else if (baudRate > 1800)
-            return B2400;
-        else if (baudRate > 1200)
-            return B1800;
-        else if (baudRate > 600)
-            return B1200;
-        else if (baudRate > 300)
-            return B600;
-        else if (baudRate > 200)
-            return B300;
-        else if (baudRate > 150)
-            return B200;
-        else if (baudRate > 134)
-            return B150;
-        else if (baudRate > 110)
-            return B134;
-        else if (baudRate > 75)
-            return B110;
-        else if (baudRate > 50)
-            return B75;
-        else if (baudRate > 0)
-            return B50;
-        else
-            return B0;
+        // With BOTHER any rate can be requested, these are the ones of the Bxxx constants.
+        // The rates above 921600 bit/s are only reached by capable adapters, e.g. FTDI or CP2102N.
+        return std::vector<int32_t>{ 50, 75, 110, 134, 150, 200, 300, 600, 1200, 1800, 2400, 4800, 9600,
+            19200, 38400, 57600, 115200, 230400, 460800, 500000, 576000, 921600, 1000000, 1152000,
+            1500000, 2000000, 2500000, 3000000, 3500000, 4000000 };
     }
 
     ZenError LinuxDeviceSystem::setBaudRateForFD(int fd, int speed) noexcept
     {
-        struct termios config;
-        if (-1 == ::tcgetattr(fd, &config)) {
+        struct termios2 config;
+        if (-1 == ::ioctl(fd, TCGETS2, &config)) {
             spdlog::error("Cannot get configuration of io interface file");
             return ZenError_Io_GetFailed;
         }
 
-        cfsetispeed(&config, speed);
-        cfsetospeed(&config, speed);
-        if (-1 == ::tcsetattr(fd, TCSANOW, &config)) {
+        // BOTHER takes the baud rate in bit/s from c_ispeed and c_ospeed
+        config.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+        config.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+        config.c_ispeed = static_cast<speed_t>(speed);
+        config.c_ospeed = static_cast<speed_t>(speed);
+        if (-1 == ::ioctl(fd, TCSETS2, &config)) {
             spdlog::error("Cannot set configuration of io interface file");
             return ZenError_Io_SetFailed;
         }
+
+        // Drivers round to the closest rate their clock divider reaches, which the UART
+        // of the sensor only tolerates within a few percent
+        if (-1 == ::ioctl(fd, TCGETS2, &config)) {
+            spdlog::error("Cannot get configuration of io interface file");
+            return ZenError_Io_GetFailed;
+        }
+
+        const auto deviation = std::abs(static_cast<int64_t>(config.c_ospeed) - speed);
+        if (deviation * 100 > static_cast<int64_t>(speed) * c_maxBaudRateDeviationPercent) {
+            spdlog::error("Baud rate {} is not supported by the serial adapter, it set {}", speed, config.c_ospeed);
+            return ZenError_Io_SetFailed;
+        }
         return ZenError_None;
     }
 }
@@ -11,7 +11,12 @@
 #ifndef ZEN_IO_SYSTEMS_LINUX_LINUXDEVICESYSTEM_H_
 #define ZEN_IO_SYSTEMS_LINUX_LINUXDEVICESYSTEM_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "io/IIoSystem.h"
+#include "io/systems/linux/LinuxDeviceMonitor.h"
 
 namespace zen
 {
@@ -23,6 +28,9 @@ namespace zen
      * as serialnumber:
      *
      * devicefile:/dev/ttyS0
+     *
+     * The SiLabs devices are kept in a table by a LinuxDeviceMonitor, which is started
+     * with the first query and reports devices which are plugged in or out to the listener.
      */
     class LinuxDeviceSystem final : public IIoSystem
     {
@@ -36,10 +44,21 @@ namespace zen
         nonstd::expected<std::unique_ptr<IIoInterface>, ZenSensorInitError> obtain(const ZenSensorDesc& desc, IIoDataSubscriber& subscriber) noexcept override;
 
         static nonstd::expected<std::vector<int32_t>, ZenError> supportedBaudRates() noexcept;
-        static constexpr int32_t mapBaudRate(unsigned int baudRate) noexcept;
+        /** termios2 takes the baud rate in bit/s, so it is passed on unchanged */
+        static constexpr int32_t mapBaudRate(unsigned int baudRate) noexcept { return static_cast<int32_t>(baudRate); }
         static ZenError setBaudRateForFD(int fd, int speed) noexcept;
 
         uint32_t getDefaultBaudrate() override { return 921600; }
+
+        void setListener(IIoSystemListener* listener) noexcept override { m_listener = listener; }
+
+    private:
+        LinuxDeviceMonitor& monitor() noexcept;
+
+        std::atomic<IIoSystemListener*> m_listener = nullptr;
+
+        std::mutex m_monitorMutex;
+        std::unique_ptr<LinuxDeviceMonitor> m_monitor;
     };
 }
 
@@ -112,7 +112,7 @@ namespace zen
 
             // The strings always fit in the destination fields.
             // "/dev/cu.SLAB_USBtoUART" is 22 characters long.
-            ZenSensorDesc desc;
+            ZenSensorDesc desc{};
             std::memcpy(desc.name, sfn.data(), sfn.size());
             desc.name[sfn.size()] = '\0';
 
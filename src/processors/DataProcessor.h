@@ -11,7 +11,7 @@
 #ifndef ZEN_DATA_PROCESSOR_H_
 #define ZEN_DATA_PROCESSOR_H_
 
-#include "utility/LockingQueue.h"
+#include "EventQueue.h"
 #include "ZenTypes.h"
 
 namespace zen
@@ -26,7 +26,7 @@ namespace zen
 
         virtual ~DataProcessor() = default;
 
-        virtual LockingQueue<ZenEvent>& getEventQueue() = 0;
+        virtual EventQueue& getEventQueue() = 0;
 
         virtual void release() = 0;
 
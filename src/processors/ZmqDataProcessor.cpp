@@ -13,14 +13,14 @@
 namespace zen
 {
 
-ZmqDataProcessor::ZmqDataProcessor() :
+ZmqDataProcessor::ZmqDataProcessor(size_t queueCapacity) :
     m_senderThread([](SenderThreadParams& p ) {
     auto eventResult = p.m_queue.waitToPop();
 
     bool terminate = !eventResult.has_value();
     if (eventResult.has_value()) {
         // check for disconnect
-        terminate = terminate || eventResult->eventType == ZenEventType_SensorDisconnected;
+        terminate = terminate || (*eventResult)->eventType == ZenEventType_SensorDisconnected;
     }
 
     if (terminate) {
@@ -33,7 +33,7 @@ ZmqDataProcessor::ZmqDataProcessor() :
     }
 
     zmq::message_t message;
-    bool streamable = zen::Streaming::toZmqMessage(*eventResult, message);
+    bool streamable = zen::Streaming::toZmqMessage(**eventResult, message);
 
     if (streamable) {
         p.m_publisher->send(message, zmq::send_flags::dontwait);
@@ -45,6 +45,10 @@ ZmqDataProcessor::ZmqDataProcessor() :
     return true;
     })
 {
+    // If the network can't keep up, prefer sending recent data and keep memory bounded.
+    // The overflow policy can be changed before the processor is added to a sensor.
+    m_queue.setType(ZenEventQueueType_Locking, queueCapacity);
+    m_queue.setOverflowPolicy(ZenEventQueueOverflowPolicy_DropOldest);
 }
 
 bool ZmqDataProcessor::connect(const std::string & endpoint) {
@@ -64,7 +68,7 @@ bool ZmqDataProcessor::connect(const std::string & endpoint) {
     return true;
 }
 
-LockingQueue<ZenEvent>& ZmqDataProcessor::getEventQueue() {
+EventQueue& ZmqDataProcessor::getEventQueue() {
     return m_queue;
 }
 
@@ -72,6 +76,8 @@ void ZmqDataProcessor::release() {
     ZenEvent evt;
 
     evt.eventType = ZenEventType_SensorDisconnected;
+    // the disconnect event terminates the sender thread, so it must not be dropped or wait for room
+    m_queue.setOverflowPolicy(ZenEventQueueOverflowPolicy_DropOldest);
     m_queue.push(evt);
     // wait for the thread to terminate
     m_senderThread.stop();
@@ -12,7 +12,6 @@
 #define ZEN_ZMQ_DATA_PROCESSOR_H_
 
 #include "DataProcessor.h"
-#include "utility/LockingQueue.h"
 #include "utility/ManagedThread.h"
 #include "streaming/StreamingProtocol.h"
 
@@ -21,26 +20,29 @@
 
 namespace zen
 {
+    /** Number of events the ZmqDataProcessor buffers by default, before the overflow policy of its queue applies */
+    constexpr size_t c_zmqDataProcessorQueueCapacity = 1024;
+
     /**
     */
     class ZmqDataProcessor final : public DataProcessor {
     public:
-        ZmqDataProcessor();
+        ZmqDataProcessor(size_t queueCapacity = c_zmqDataProcessorQueueCapacity);
 
         bool connect(const std::string & endpoint);
 
-        LockingQueue<ZenEvent>& getEventQueue() override;
+        EventQueue& getEventQueue() override;
 
         void release() override;
 
     private:
         /** Our own event queue where the Sensor class will send new sensor events*/
-        LockingQueue<ZenEvent> m_queue;
+        EventQueue m_queue;
 
         std::string m_endpoint;
         
         struct SenderThreadParams {
-            LockingQueue<ZenEvent>& m_queue;
+            EventQueue& m_queue;
             std::unique_ptr<zmq::socket_t> & m_publisher;
         };
 
@@ -411,12 +411,14 @@ namespace zen
             auto cmdError = setInt32AsBool(ZenImuProperty_OutputLowPrecision, !value);
             if (cmdError == ZenError_None) {
                 m_cache.lowPrecisionMode = value;
+                notifyPropertyChange(property, value);
             }
             return cmdError;
         } else if (property == ZenImuProperty_DegRadOutput) {
             auto cmdError = setInt32AsBool(ZenImuProperty_DegRadOutput, value);
             if (cmdError == ZenError_None) {
                 m_cache.radOutput = value;
+                notifyPropertyChange(property, value);
             }
             return cmdError;
         } else if (property == ZenImuProperty_GyrUseAutoCalibration)
@@ -75,10 +75,18 @@ namespace zen
         void setOutputDataBitset(uint32_t bitset) noexcept { m_cache.outputDataBitset = bitset; }
 
         /** If true, the sensor will output values in low-precision mode (16 bit for floats) */
-        void setLowPrecisionMode(bool modeOne) noexcept { m_cache.lowPrecisionMode = modeOne; }
+        void setLowPrecisionMode(bool modeOne) noexcept
+        {
+            m_cache.lowPrecisionMode = modeOne;
+            notifyPropertyChange(ZenImuProperty_OutputLowPrecision, modeOne);
+        }
 
         /** Manually initializes the output unit, if true sensor will ouput angles in rad */
-        void setRadOutput(bool radOutput) noexcept { m_cache.radOutput = radOutput; }
+        void setRadOutput(bool radOutput) noexcept
+        {
+            m_cache.radOutput = radOutput;
+            notifyPropertyChange(ZenImuProperty_DegRadOutput, radOutput);
+        }
 
     private:
 
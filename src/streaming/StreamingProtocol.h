@@ -132,7 +132,9 @@ namespace zen {
             zmqOut.rebuild(completeBuffer.data(), completeBuffer.size());
         }
 
-        inline bool toZmqMessage(ZenEvent const& evt, zmq::message_t & zmqOut) {
+        /** Accepts a ZenEvent or the internal CompactEvent, which share their member names */
+        template <class TEvent>
+        inline bool toZmqMessage(TEvent const& evt, zmq::message_t & zmqOut) {
             // todo: this needs to be refactored when the event type numbering scheme is fixed
             // right now the component numbers for IMU and GNSS are hard-coded
             if (evt.component.handle == 1) {
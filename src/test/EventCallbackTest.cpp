@@ -0,0 +1,50 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "OpenZen.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+TEST(EventCallback, bypassesEventQueue) {
+    auto client = zen::make_client();
+    ASSERT_EQ(ZenError_None, client.first);
+
+    auto sensor = client.second.obtainSensorByName("TestSensor", "");
+    ASSERT_EQ(ZenSensorInitError_None, sensor.first);
+
+    std::atomic_int nImuEvents(0);
+    ASSERT_EQ(ZenError_None, sensor.second.onEvent([&nImuEvents](const ZenEvent& event) {
+        if (event.eventType == ZenEventType_ImuData)
+            ++nImuEvents;
+    }));
+
+    // the TestSensor publishes at 100 Hz
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_GT(nImuEvents.load(), 0);
+
+    // events which arrived before the callback was registered may still be queued
+    while (client.second.pollNextEvent()) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(client.second.pollNextEvent().has_value());
+
+    // unregistering delivers events to the queue again
+    ASSERT_EQ(ZenError_None, sensor.second.onEvent(nullptr));
+    const int nCallbackEvents = nImuEvents.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_TRUE(client.second.pollNextEvent().has_value());
+    ASSERT_EQ(nCallbackEvents, nImuEvents.load());
+
+    sensor.second.release();
+    client.second.close();
+}
@@ -0,0 +1,69 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "CompactEvent.h"
+#include "SensorClient.h"
+
+#include <cstring>
+#include <vector>
+
+TEST(CompactEvent, roundTripImuData) {
+    ZenEvent event{};
+    event.eventType = ZenEventType_ImuData;
+    event.sensor.handle = 7;
+    event.component.handle = 1;
+    event.data.imuData.frameCount = 12;
+    event.data.imuData.a[2] = 9.81f;
+    event.receivedTimestampNs = 1000;
+    event.queuedTimestampNs = 1500;
+
+    zen::CompactEvent compact;
+    zen::toCompactEvent(event, compact);
+
+    ZenEvent converted{};
+    zen::toZenEvent(compact, converted);
+    ASSERT_EQ(ZenEventType_ImuData, converted.eventType);
+    ASSERT_EQ(7u, converted.sensor.handle);
+    ASSERT_EQ(1u, converted.component.handle);
+    ASSERT_EQ(1000u, converted.receivedTimestampNs);
+    ASSERT_EQ(1500u, converted.queuedTimestampNs);
+    ASSERT_EQ(0, std::memcmp(&event.data.imuData, &converted.data.imuData, sizeof(ZenEventData_Imu)));
+}
+
+TEST(SensorClient, sensorFoundBypassesQueue) {
+    zen::SensorClient client(0);
+
+    ZenEvent found{};
+    found.eventType = ZenEventType_SensorFound;
+    std::strcpy(found.data.sensorFound.name, "LPMS-IG1");
+
+    ZenEvent progress{};
+    progress.eventType = ZenEventType_SensorListingProgress;
+    progress.data.sensorListingProgress.progress = 0.5f;
+
+    client.notifyEvent(found);
+    client.notifyEvent(progress);
+    std::strcpy(found.data.sensorFound.name, "LPMS-B2");
+    client.notifyEvent(found);
+
+    auto first = client.pollNextEvent();
+    ASSERT_TRUE(first.has_value());
+    ASSERT_EQ(ZenEventType_SensorFound, first->eventType);
+    ASSERT_STREQ("LPMS-IG1", first->data.sensorFound.name);
+
+    std::vector<ZenEvent> events(4);
+    ASSERT_EQ(2u, client.pollNextEvents(gsl::make_span(events)));
+    ASSERT_EQ(ZenEventType_SensorListingProgress, events[0].eventType);
+    ASSERT_FLOAT_EQ(0.5f, events[0].data.sensorListingProgress.progress);
+    ASSERT_EQ(ZenEventType_SensorFound, events[1].eventType);
+    ASSERT_STREQ("LPMS-B2", events[1].data.sensorFound.name);
+}
@@ -0,0 +1,109 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "EventFilter.h"
+#include "OpenZen.h"
+
+#include <chrono>
+#include <thread>
+
+TEST(EventFilter, acceptsEvent) {
+    ZenEvent event{};
+    event.eventType = ZenEventType_GnssData;
+    event.component.handle = 2;
+
+    ASSERT_TRUE(zen::acceptsEvent(zen::c_acceptAllEventsFilter, event));
+
+    ZenEventFilter imuOnly{ {0}, ZenEventType_ImuData, ZenEventType_ImuData };
+    ASSERT_FALSE(zen::acceptsEvent(imuOnly, event));
+
+    ZenEventFilter component{ {2}, ZenEventType_None, ZenEventType_Max };
+    ASSERT_TRUE(zen::acceptsEvent(component, event));
+    component.component.handle = 1;
+    ASSERT_FALSE(zen::acceptsEvent(component, event));
+}
+
+TEST(EventDecimator, keepEveryNthPerComponent) {
+    zen::EventDecimator decimator;
+    const ZenEventDecimation everyThird{ 3, 0 };
+
+    ZenEvent imu{};
+    imu.eventType = ZenEventType_ImuData;
+    imu.component.handle = 1;
+    ZenEvent gnss{};
+    gnss.eventType = ZenEventType_GnssData;
+    gnss.component.handle = 2;
+
+    int nImu = 0;
+    int nGnss = 0;
+    for (int i = 0; i < 9; ++i) {
+        nImu += decimator.accept(imu, everyThird) ? 1 : 0;
+        if (i % 3 == 0)
+            nGnss += decimator.accept(gnss, everyThird) ? 1 : 0;
+    }
+    ASSERT_EQ(3, nImu);
+    ASSERT_EQ(1, nGnss);
+
+    // control events are never decimated
+    ZenEvent disconnected{};
+    disconnected.eventType = ZenEventType_SensorDisconnected;
+    ASSERT_TRUE(decimator.accept(disconnected, everyThird));
+    ASSERT_TRUE(decimator.accept(disconnected, everyThird));
+}
+
+TEST(EventDecimator, minInterval) {
+    using namespace std::chrono_literals;
+    zen::EventDecimator decimator;
+    const ZenEventDecimation interval{ 0, 10000 };
+
+    ZenEvent imu{};
+    imu.eventType = ZenEventType_ImuData;
+
+    const auto start = zen::EventDecimator::Clock::now();
+    ASSERT_TRUE(decimator.accept(imu, interval, start));
+    ASSERT_FALSE(decimator.accept(imu, interval, start + 5ms));
+    ASSERT_TRUE(decimator.accept(imu, interval, start + 10ms));
+    ASSERT_FALSE(decimator.accept(imu, interval, start + 19ms));
+    ASSERT_TRUE(decimator.accept(imu, interval, start + 21ms));
+}
+
+TEST(EventFilter, filtersBeforeEnqueue) {
+    auto client = zen::make_client();
+    ASSERT_EQ(ZenError_None, client.first);
+
+    // the TestSensor publishes IMU data of component 1 at 100 Hz
+    ASSERT_EQ(ZenError_None, client.second.setEventFilter({ {0}, ZenEventType_GnssData, ZenEventType_GnssData }));
+    auto sensor = client.second.obtainSensorByName("TestSensor", "");
+    ASSERT_EQ(ZenSensorInitError_None, sensor.first);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(client.second.pollNextEvent().has_value());
+
+    ASSERT_EQ(ZenError_None, sensor.second.setEventFilter({ {2}, ZenEventType_None, ZenEventType_Max }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(client.second.pollNextEvent().has_value());
+
+    ASSERT_EQ(ZenError_None, sensor.second.setEventFilter({ {1}, ZenEventType_ImuData, ZenEventType_ImuData }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto event = client.second.pollNextEvent();
+    ASSERT_TRUE(event.has_value());
+    ASSERT_EQ(ZenEventType_ImuData, event->eventType);
+
+    // the sensor falls back to the filter of the client
+    ASSERT_EQ(ZenError_None, sensor.second.resetEventFilter());
+    while (client.second.pollNextEvent()) {}
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_FALSE(client.second.pollNextEvent().has_value());
+
+    sensor.second.release();
+    client.second.close();
+}
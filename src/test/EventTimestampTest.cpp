@@ -0,0 +1,77 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "OpenZenCAPI.h"
+#include "communication/Modbus.h"
+#include "communication/ModbusCommunicator.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+    class TimestampRecorder : public zen::IModbusFrameSubscriber
+    {
+    public:
+        ZenError processReceivedData(uint8_t, uint16_t, gsl::span<const std::byte>, uint64_t receivedTimestampNs) noexcept override
+        {
+            timestamps.push_back(receivedTimestampNs);
+            return ZenError_None;
+        }
+
+        std::vector<uint64_t> timestamps;
+    };
+}
+
+TEST(EventTimestamp, frameCarriesTimestampOfCompletingRead) {
+    TimestampRecorder recorder;
+    zen::ModbusCommunicator communicator(recorder, std::make_unique<zen::modbus::LpFrameFactory>(),
+        std::make_unique<zen::modbus::LpFrameParser>());
+
+    const std::vector<std::byte> payload{ std::byte(1), std::byte(2), std::byte(3), std::byte(4) };
+    const zen::modbus::LpFrameFactory lpFactory;
+    const zen::modbus::IFrameFactory& factory = lpFactory;
+    const auto frame = factory.makeFrame(1, 9, payload.data(), static_cast<uint16_t>(payload.size()));
+
+    // the frame is split across two reads, it is complete with the second one
+    zen::IIoDataSubscriber& ioSubscriber = communicator;
+    const auto split = frame.size() / 2;
+    ASSERT_EQ(ZenError_None, ioSubscriber.processData(gsl::make_span(frame.data(), split), 100));
+    ASSERT_TRUE(recorder.timestamps.empty());
+    ASSERT_EQ(ZenError_None, ioSubscriber.processData(gsl::make_span(frame.data() + split, frame.size() - split), 200));
+
+    ASSERT_EQ(1u, recorder.timestamps.size());
+    ASSERT_EQ(200u, recorder.timestamps[0]);
+}
+
+TEST(EventTimestamp, sensorEventsAreStampedOnReceiveAndQueue) {
+    ZenClientHandle_t client;
+    ASSERT_EQ(ZenError_None, ZenInit(&client));
+
+    const uint64_t start = ZenGetHostTimestampNs();
+
+    ZenSensorHandle_t sensor;
+    ASSERT_EQ(ZenSensorInitError_None, ZenObtainSensorByName(client, "TestSensor", "", 0, &sensor));
+
+    // the TestSensor publishes IMU data of component 1 at 100 Hz
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    ZenEvent event;
+    ASSERT_TRUE(ZenPollNextEvent(client, &event));
+    ASSERT_EQ(ZenEventType_ImuData, event.eventType);
+    ASSERT_GE(event.receivedTimestampNs, start);
+    ASSERT_GE(event.queuedTimestampNs, event.receivedTimestampNs);
+    ASSERT_GE(ZenGetHostTimestampNs(), event.queuedTimestampNs);
+
+    ASSERT_EQ(ZenError_None, ZenReleaseSensor(client, sensor));
+    ASSERT_EQ(ZenError_None, ZenShutdown(client));
+}
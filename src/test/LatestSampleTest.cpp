@@ -0,0 +1,43 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "OpenZenCAPI.h"
+
+#include <chrono>
+#include <thread>
+
+TEST(LatestSample, snapshotWithoutDrainingQueue) {
+    ZenClientHandle_t client;
+    ASSERT_EQ(ZenError_None, ZenInit(&client));
+
+    ZenSensorHandle_t sensor;
+    ASSERT_EQ(ZenSensorInitError_None, ZenObtainSensorByName(client, "TestSensor", "", 0, &sensor));
+
+    // the TestSensor publishes IMU data of component 1 at 100 Hz
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    ZenImuData imuData{};
+    uint64_t seq = 0;
+    ASSERT_EQ(ZenError_None, ZenSensorComponentGetLatestImuData(client, sensor, { 1 }, &imuData, &seq));
+    ASSERT_GT(seq, 0u);
+    ASSERT_EQ(24.0f, imuData.g1[1]);
+
+    ZenGnssData gnssData{};
+    ASSERT_EQ(ZenError_WrongDataType, ZenSensorComponentGetLatestGnssData(client, sensor, { 1 }, &gnssData, &seq));
+    ASSERT_EQ(ZenError_None, ZenSensorComponentGetLatestGnssData(client, sensor, { 2 }, &gnssData, &seq));
+    ASSERT_EQ(0u, seq);
+    ASSERT_EQ(ZenError_InvalidComponentHandle, ZenSensorComponentGetLatestImuData(client, sensor, { 0 }, &imuData, &seq));
+    ASSERT_EQ(ZenError_IsNull, ZenSensorComponentGetLatestImuData(client, sensor, { 1 }, &imuData, nullptr));
+
+    ASSERT_EQ(ZenError_None, ZenReleaseSensor(client, sensor));
+    ASSERT_EQ(ZenError_None, ZenShutdown(client));
+}
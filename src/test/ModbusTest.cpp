@@ -11,6 +11,7 @@
 #include <gtest/gtest.h>
 
 #include "communication/Modbus.h"
+#include "communication/ModbusCommunicator.h"
 
 #include <vector>
 
@@ -94,3 +95,195 @@ TEST(Modbus, parsePacketWithCrapInfront) {
 
     ASSERT_TRUE(lpParser.finished());
 }
+
+namespace
+{
+    std::vector<std::byte> makeFrame(uint8_t address, uint16_t function, const std::vector<std::byte>& data)
+    {
+        const zen::modbus::LpFrameFactory factory;
+        const zen::modbus::IFrameFactory& frameFactory = factory;
+        auto frame = frameFactory.makeFrame(address, function, data.data(), static_cast<uint16_t>(data.size()));
+        // the factory writes the length as one byte
+        frame[6] = std::byte((data.size() >> 8) & 0xff);
+        return frame;
+    }
+
+    /** Reads the frame statistics of the communicator while it delivers a frame, like an event callback */
+    class StatisticsReadingSubscriber : public zen::IModbusFrameSubscriber
+    {
+    public:
+        ZenError processReceivedData(uint8_t, uint16_t, gsl::span<const std::byte>, uint64_t) noexcept override
+        {
+            statistics.push_back(communicator->frameStatistics());
+            return ZenError_None;
+        }
+
+        zen::ModbusCommunicator* communicator = nullptr;
+        std::vector<ZenFrameStatistics> statistics;
+    };
+}
+
+TEST(Modbus, parseStreamInChunks) {
+    // payloads of all sizes, also above 1024 bytes where the checksum sums in several blocks
+    std::vector<std::vector<std::byte>> payloads;
+    for (size_t length : { 0, 1, 7, 8, 9, 63, 255, 256, 1030, 3000 }) {
+        std::vector<std::byte> payload(length);
+        for (size_t idx = 0; idx < length; ++idx)
+            payload[idx] = std::byte((idx * 131 + length) & 0xff);
+        payloads.push_back(payload);
+    }
+
+    std::vector<std::byte> stream;
+    for (size_t idx = 0; idx < payloads.size(); ++idx) {
+        // garbage between the frames
+        for (auto garbage : { 0x00, 0x0d, 0x0a, 0xff })
+            stream.push_back(std::byte(garbage));
+
+        const auto frame = makeFrame(uint8_t(idx), uint16_t(idx + 300), payloads[idx]);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    for (size_t chunkSize : { 1, 2, 3, 7, 11, 64, 256, 100000 }) {
+        zen::modbus::LpFrameParser parser;
+        size_t nFrames = 0;
+        for (size_t offset = 0; offset < stream.size(); offset += chunkSize) {
+            gsl::span<const std::byte> data(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+            while (!data.empty()) {
+                if (parser.parse(data) != zen::modbus::FrameParseError_None) {
+                    parser.reset();
+                    data = data.subspan(1);
+                    continue;
+                }
+
+                if (parser.finished()) {
+                    const auto& frame = parser.frame();
+                    ASSERT_LT(nFrames, payloads.size());
+                    ASSERT_EQ(nFrames, frame.address);
+                    ASSERT_EQ(nFrames + 300, frame.function);
+                    ASSERT_EQ(payloads[nFrames], std::vector<std::byte>(frame.data.begin(), frame.data.end()))
+                        << "chunk size " << chunkSize;
+                    ++nFrames;
+                    parser.reset();
+                }
+            }
+        }
+        ASSERT_EQ(payloads.size(), nFrames) << "chunk size " << chunkSize;
+    }
+}
+
+TEST(Modbus, parseDetectsCorruption) {
+    const std::vector<std::byte> payload{ std::byte(1), std::byte(2), std::byte(3) };
+
+    auto corruptData = makeFrame(1, 2, payload);
+    corruptData[8] = std::byte(7);
+    gsl::span<const std::byte> data(corruptData);
+    zen::modbus::LpFrameParser parser;
+    ASSERT_EQ(zen::modbus::FrameParseError_ChecksumInvalid, parser.parse(data));
+
+    auto corruptEnd = makeFrame(1, 2, payload);
+    corruptEnd.back() = std::byte(0x0d);
+    data = corruptEnd;
+    parser.reset();
+    ASSERT_EQ(zen::modbus::FrameParseError_ExpectedEnd, parser.parse(data));
+}
+
+TEST(Modbus, completeFrameIsNotCopied) {
+    const std::vector<std::byte> payload{ std::byte(1), std::byte(2), std::byte(3), std::byte(4) };
+    const auto frame = makeFrame(1, 2, payload);
+
+    // a complete frame points into the parsed data
+    zen::modbus::LpFrameParser parser;
+    gsl::span<const std::byte> data(frame);
+    ASSERT_EQ(zen::modbus::FrameParseError_None, parser.parse(data));
+    ASSERT_TRUE(parser.finished());
+    ASSERT_EQ(frame.data() + 7, parser.frame().data.data());
+    ASSERT_EQ(payload.size(), parser.frame().data.size());
+
+    // frames split across reads are reassembled in the same buffer every time
+    const std::byte* reassembled = nullptr;
+    for (int repetition = 0; repetition < 3; ++repetition) {
+        parser.reset();
+        gsl::span<const std::byte> first(frame.data(), 5);
+        gsl::span<const std::byte> second(frame.data() + 5, frame.size() - 5);
+        ASSERT_EQ(zen::modbus::FrameParseError_None, parser.parse(first));
+        ASSERT_FALSE(parser.finished());
+        ASSERT_EQ(zen::modbus::FrameParseError_None, parser.parse(second));
+        ASSERT_TRUE(parser.finished());
+
+        const auto& parsed = parser.frame();
+        ASSERT_EQ(payload, std::vector<std::byte>(parsed.data.begin(), parsed.data.end()));
+        if (reassembled) {
+            ASSERT_EQ(reassembled, parsed.data.data());
+        }
+        reassembled = parsed.data.data();
+    }
+}
+
+TEST(Modbus, resyncRecoversFrames) {
+    const std::vector<std::byte> payload{ std::byte(1), std::byte(2), std::byte(3), std::byte(4) };
+
+    std::vector<std::vector<std::byte>> validFrames;
+    for (uint8_t address = 0; address < 4; ++address)
+        validFrames.push_back(makeFrame(address, 10, payload));
+
+    // a start byte in the noise which announces more data than any sensor sends
+    const std::vector<std::byte> falseHeader{ std::byte(0x3a), std::byte(1), std::byte(0), std::byte(2), std::byte(0),
+        std::byte(0xff), std::byte(0xff) };
+
+    auto corruptData = makeFrame(5, 10, payload);
+    corruptData[8] = std::byte(7);
+
+    auto corruptEnd = makeFrame(6, 10, payload);
+    corruptEnd.back() = std::byte(0x0d);
+
+    std::vector<std::byte> stream;
+    for (const auto& part : { validFrames[0], falseHeader, validFrames[1], corruptData, validFrames[2], corruptEnd, validFrames[3] })
+        stream.insert(stream.end(), part.begin(), part.end());
+
+    for (size_t chunkSize : { 1, 2, 5, 7, 16, 100000 }) {
+        zen::modbus::LpFrameParser parser;
+        std::vector<uint8_t> addresses;
+        for (size_t offset = 0; offset < stream.size(); offset += chunkSize) {
+            gsl::span<const std::byte> data(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+            while (!data.empty()) {
+                if (parser.parse(data) != zen::modbus::FrameParseError_None) {
+                    parser.resync(data);
+                    continue;
+                }
+
+                if (parser.finished()) {
+                    addresses.push_back(parser.frame().address);
+                    parser.reset();
+                }
+            }
+        }
+
+        ASSERT_EQ(std::vector<uint8_t>({ 0, 1, 2, 3 }), addresses) << "chunk size " << chunkSize;
+        ASSERT_EQ(1u, parser.statistics().checksumErrors) << "chunk size " << chunkSize;
+        ASSERT_EQ(2u, parser.statistics().framingErrors) << "chunk size " << chunkSize;
+        ASSERT_EQ(falseHeader.size() + corruptData.size() + corruptEnd.size(), parser.statistics().bytesDiscarded)
+            << "chunk size " << chunkSize;
+    }
+}
+
+TEST(Modbus, frameStatisticsDuringDelivery) {
+    const std::vector<std::byte> payload{ std::byte(1), std::byte(2) };
+    auto corrupt = makeFrame(1, 10, payload);
+    corrupt[7] = std::byte(7);
+
+    std::vector<std::byte> stream;
+    for (const auto& part : { corrupt, makeFrame(2, 10, payload) })
+        stream.insert(stream.end(), part.begin(), part.end());
+
+    StatisticsReadingSubscriber subscriber;
+    zen::ModbusCommunicator communicator(subscriber, std::make_unique<zen::modbus::LpFrameFactory>(),
+        std::make_unique<zen::modbus::LpFrameParser>());
+    subscriber.communicator = &communicator;
+
+    // the subscriber reads the statistics while the frame is delivered, without waiting for the parser
+    zen::IIoDataSubscriber& ioSubscriber = communicator;
+    ASSERT_EQ(ZenError_None, ioSubscriber.processData(stream, 0));
+    ASSERT_EQ(1u, subscriber.statistics.size());
+    ASSERT_EQ(1u, subscriber.statistics[0].checksumErrors);
+    ASSERT_EQ(corrupt.size(), subscriber.statistics[0].bytesDiscarded);
+}
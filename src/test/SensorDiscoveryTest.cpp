@@ -0,0 +1,131 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "OpenZen.h"
+#include "SensorManager.h"
+#include "io/IoManager.h"
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <string>
+
+namespace
+{
+    /** Lists one sensor named after the IO system, once the listing is released */
+    class ListingIoSystem : public zen::IIoSystem
+    {
+    public:
+        ListingIoSystem(std::string name, std::shared_future<void> release)
+            : m_name(std::move(name))
+            , m_release(std::move(release))
+        {}
+
+        bool available() override { return true; }
+
+        ZenError listDevices(std::vector<ZenSensorDesc>& outDevices) override
+        {
+            if (m_release.valid())
+                m_release.wait();
+
+            ZenSensorDesc desc{};
+            std::strcpy(desc.name, m_name.c_str());
+            std::strcpy(desc.ioType, m_name.c_str());
+            outDevices.push_back(desc);
+            return ZenError_None;
+        }
+
+        nonstd::expected<std::unique_ptr<zen::IIoInterface>, ZenSensorInitError> obtain(const ZenSensorDesc&,
+            zen::IIoDataSubscriber&) noexcept override
+        {
+            return nonstd::make_unexpected(ZenSensorInitError_UnsupportedIoType);
+        }
+
+    private:
+        const std::string m_name;
+        const std::shared_future<void> m_release;
+    };
+
+    struct Listing
+    {
+        bool fastFound = false;
+        bool hungFound = false;
+        bool hungTimedOut = false;
+        std::chrono::steady_clock::duration duration;
+    };
+
+    Listing listSensors(zen::ZenClient& client)
+    {
+        Listing listing;
+        const auto start = std::chrono::steady_clock::now();
+        EXPECT_EQ(ZenError_None, client.listSensorsAsync());
+        while (auto event = client.waitForNextEventFor(std::chrono::seconds(15))) {
+            if (event->eventType == ZenEventType_SensorFound) {
+                listing.fastFound = listing.fastFound || std::string(event->data.sensorFound.name) == "DiscoveryFast";
+                listing.hungFound = listing.hungFound || std::string(event->data.sensorFound.name) == "DiscoveryHung";
+            } else if (event->eventType == ZenEventType_SensorListingProgress) {
+                const auto& progress = event->data.sensorListingProgress;
+                if (progress.complete)
+                    break;
+
+                // the sensors of an IO system are notified before its progress
+                if (std::string(progress.ioType) == "DiscoveryFast") {
+                    EXPECT_TRUE(listing.fastFound);
+                    EXPECT_FALSE(progress.timedOut);
+                } else if (std::string(progress.ioType) == "DiscoveryHung") {
+                    listing.hungTimedOut = progress.timedOut;
+                }
+            }
+        }
+        listing.duration = std::chrono::steady_clock::now() - start;
+        return listing;
+    }
+}
+
+TEST(SensorDiscovery, skipsHungIoSystems) {
+    std::promise<void> release;
+    ASSERT_TRUE(zen::IoManager::get().registerIoSystem("DiscoveryFast",
+        std::make_unique<ListingIoSystem>("DiscoveryFast", std::shared_future<void>())));
+    ASSERT_TRUE(zen::IoManager::get().registerIoSystem("DiscoveryHung",
+        std::make_unique<ListingIoSystem>("DiscoveryHung", release.get_future().share())));
+
+    auto client = zen::make_client();
+    ASSERT_EQ(ZenError_None, client.first);
+
+    ASSERT_EQ(ZenError_None, client.second.setEventQueueType(ZenEventQueueType_Locking));
+
+    zen::SensorManager::get().setListDevicesTimeout(std::chrono::milliseconds(500));
+    auto listing = listSensors(client.second);
+    ASSERT_TRUE(listing.fastFound);
+    ASSERT_FALSE(listing.hungFound);
+    ASSERT_TRUE(listing.hungTimedOut);
+    ASSERT_LT(listing.duration, std::chrono::seconds(5));
+
+    // the discovery may still publish to the event queue, so it cannot be replaced anymore
+    ASSERT_EQ(ZenError_AlreadyInitialized, client.second.setEventQueueType(ZenEventQueueType_LockFree));
+
+    // the IO system is not called again while it is still listing
+    zen::SensorManager::get().setListDevicesTimeout(std::chrono::seconds(10));
+    listing = listSensors(client.second);
+    ASSERT_TRUE(listing.fastFound);
+    ASSERT_TRUE(listing.hungTimedOut);
+    ASSERT_LT(listing.duration, std::chrono::seconds(5));
+
+    release.set_value();
+    listing = listSensors(client.second);
+    ASSERT_TRUE(listing.fastFound);
+    ASSERT_TRUE(listing.hungFound);
+    ASSERT_FALSE(listing.hungTimedOut);
+
+    zen::SensorManager::get().setListDevicesTimeout(std::chrono::seconds(30));
+    client.second.close();
+}
@@ -79,3 +79,56 @@ TEST(ConnectionNegotiator, connectIg1Sensor) {
     ASSERT_EQ(g_zenSensorType_Gnss, sensorConfig->components[1].id);
     */
 }
+
+TEST(ConnectionNegotiator, commonBaudRatesAreDescending) {
+    const auto baudRates = ConnectionNegotiator::commonBaudRates({ 9600, 115200, 921600, 2000000, 4000000 });
+    ASSERT_EQ((std::vector<unsigned int>{ 2000000, 921600, 115200, 9600 }), baudRates);
+    ASSERT_TRUE(ConnectionNegotiator::commonBaudRates({ 5000, 33000 }).empty());
+}
+
+TEST(ConnectionNegotiator, detectBaudRate) {
+    ConnectionNegotiator negotiator;
+
+    // the sensor only replies at 921600, which is probed after the default rate and the higher ones
+    MockbusCommunicator mockbus(negotiator,
+      {
+        {uint8_t(0), uint8_t(EDevicePropertyV1::GetFirmwareInfo),
+          uint8_t(EDevicePropertyV1::GetFirmwareInfo),
+          { std::byte(0), std::byte(0), std::byte(0), std::byte(23) }
+        },
+        {uint8_t(0), uint8_t(EDevicePropertyV0::SetCommandMode),
+            uint8_t(EDevicePropertyV0::Ack),
+            {}
+        }
+      },
+      921600, { 115200, 921600, 1500000, 2000000 }
+      );
+
+    auto sensorConfig = negotiator.negotiate(mockbus, 0, 115200);
+    ASSERT_TRUE(sensorConfig);
+    ASSERT_EQ(921600u, mockbus.currentBaudRate());
+    ASSERT_EQ((std::vector<unsigned int>{ 115200, 2000000, 1500000, 921600 }), mockbus.baudRateHistory());
+}
+
+TEST(ConnectionNegotiator, detectDefaultBaudRateFirst) {
+    ConnectionNegotiator negotiator;
+
+    MockbusCommunicator mockbus(negotiator,
+      {
+        {uint8_t(0), uint8_t(EDevicePropertyV1::GetFirmwareInfo),
+          uint8_t(EDevicePropertyV1::GetFirmwareInfo),
+          { std::byte(0), std::byte(0), std::byte(0), std::byte(23) }
+        },
+        {uint8_t(0), uint8_t(EDevicePropertyV0::SetCommandMode),
+            uint8_t(EDevicePropertyV0::Ack),
+            {}
+        }
+      },
+      921600, { 115200, 921600, 1500000, 2000000 }
+      );
+
+    // a sensor at the default rate of the IO system does not wait for probes at other rates
+    auto sensorConfig = negotiator.negotiate(mockbus, 0, 921600);
+    ASSERT_TRUE(sensorConfig);
+    ASSERT_EQ((std::vector<unsigned int>{ 921600 }), mockbus.baudRateHistory());
+}
@@ -53,14 +53,28 @@ public:
   */
   typedef std::vector< std::tuple< uint8_t, uint8_t, uint8_t, std::vector<std::byte>>> RepliesVector;
 
-  MockbusCommunicator(IModbusFrameSubscriber& subscriber, RepliesVector replies) noexcept :
+  /**
+    The sensor only replies while the baud rate is set to sensorBaudRate, zero replies
+    at every baud rate. supportedBaudRates are the ones of the mocked IO interface.
+  */
+  MockbusCommunicator(IModbusFrameSubscriber& subscriber, RepliesVector replies,
+    unsigned int sensorBaudRate = 0, std::vector<int32_t> supportedBaudRates = {}) noexcept :
   ModbusCommunicator( subscriber, std::make_unique<DummyFrameFactory>(),
-  std::make_unique<DummyFrameParser>() ), m_replies(replies)
+  std::make_unique<DummyFrameParser>() ), m_replies(replies),
+  m_sensorBaudRate(sensorBaudRate), m_supportedBaudRates(std::move(supportedBaudRates))
     {
 
   }
 
-  ZenError send(uint8_t address, uint16_t function, gsl::span<const std::byte>) noexcept override {
+  ZenError send(uint8_t address, uint16_t function, gsl::span<const std::byte>,
+    IIoInterface::SendCompletion completion = nullptr) noexcept override {
+    // the frame is transmitted immediately
+    if (completion)
+      completion(m_sendResult);
+
+    if (m_sensorBaudRate != 0 && m_baudRate != m_sensorBaudRate)
+      return ZenError_None;
+
     // check if we can supply that result
     auto itReply = std::find_if(m_replies.begin(), m_replies.end(),
       [address,function](auto const& entry ){
@@ -76,7 +90,7 @@ public:
         std::vector<std::byte> bb = reply_data;
         std::this_thread::sleep_for( std::chrono::milliseconds(100));
         gsl::span<std::byte> byteSpan(bb.data(), bb.size());
-        local_subscriber->processReceivedData(address, reply_function, byteSpan );
+        local_subscriber->processReceivedData(address, reply_function, byteSpan, hostTimestampNs());
       }));
     } else {
       spdlog::error("Mock reply for address {} and function {} not found",
@@ -87,13 +101,34 @@ public:
   }
 
   /** Set Baudrate of IO interface (bit/s) */
-  ZenError setBaudRate(unsigned int) noexcept override {
+  ZenError setBaudRate(unsigned int rate) noexcept override {
+    m_baudRate = rate;
+    m_baudRateHistory.push_back(rate);
     return ZenError_None;
   }
 
+  nonstd::expected<std::vector<int32_t>, ZenError> supportedBaudRates() const noexcept override {
+    if (m_supportedBaudRates.empty())
+      return nonstd::make_unexpected(ZenError_NotSupported);
+    return m_supportedBaudRates;
+  }
+
+  unsigned int currentBaudRate() const noexcept { return m_baudRate; }
+
+  /** Result of the transmissions passed to send completions */
+  void setSendResult(ZenError result) noexcept { m_sendResult = result; }
+
+  /** All baud rates which were set, in order */
+  const std::vector<unsigned int>& baudRateHistory() const noexcept { return m_baudRateHistory; }
+
 
 private:
   const RepliesVector m_replies;
+  const unsigned int m_sensorBaudRate;
+  const std::vector<int32_t> m_supportedBaudRates;
+  unsigned int m_baudRate = 0;
+  std::vector<unsigned int> m_baudRateHistory;
+  ZenError m_sendResult = ZenError_None;
   std::vector<std::future<void>> m_futureReplies;
 
 };
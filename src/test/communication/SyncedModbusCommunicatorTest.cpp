@@ -0,0 +1,67 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "communication/ConnectionNegotiator.h"
+#include "communication/SyncedModbusCommunicator.h"
+
+#include "MockbusCommunicator.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+using namespace zen;
+
+TEST(SyncedModbusCommunicator, ignoredAckIsNotTakenByWaiter) {
+    ConnectionNegotiator negotiator;
+    SyncedModbusCommunicator communicator(std::make_unique<MockbusCommunicator>(negotiator,
+        MockbusCommunicator::RepliesVector{}));
+
+    // e.g. an RTK correction, which is queued before the property request
+    ASSERT_EQ(ZenError_None, communicator.sendAndIgnoreAck(0, 1, {}));
+
+    auto request = std::async(std::launch::async, [&communicator]() {
+        return communicator.sendAndWaitForAck(0, 2, 2, {});
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // the acknowledgement of the correction arrives first
+    communicator.publishAck(2, ZenError_None);
+    ASSERT_EQ(std::future_status::timeout, request.wait_for(std::chrono::milliseconds(50)));
+
+    communicator.publishAck(2, ZenError_FW_FunctionFailed);
+    ASSERT_EQ(ZenError_FW_FunctionFailed, request.get());
+
+    // the acknowledgement of a correction which arrives without a waiter is consumed as well
+    ASSERT_EQ(ZenError_None, communicator.sendAndIgnoreAck(0, 1, {}));
+    communicator.publishAck(2, ZenError_None);
+
+    auto nextRequest = std::async(std::launch::async, [&communicator]() {
+        return communicator.sendAndWaitForAck(0, 2, 2, {});
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    communicator.publishAck(2, ZenError_FW_FunctionFailed);
+    ASSERT_EQ(ZenError_FW_FunctionFailed, nextRequest.get());
+}
+
+TEST(SyncedModbusCommunicator, sendErrorEndsWait) {
+    ConnectionNegotiator negotiator;
+    auto mockbus = std::make_unique<MockbusCommunicator>(negotiator, MockbusCommunicator::RepliesVector{});
+    mockbus->setSendResult(ZenError_Io_SendFailed);
+    SyncedModbusCommunicator communicator(std::move(mockbus));
+
+    // the failed transmission is reported instead of waiting for the timeout
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(ZenError_Io_SendFailed, communicator.sendAndWaitForAck(0, 2, 2, {}));
+    ASSERT_EQ(ZenError_Io_SendFailed, communicator.sendAndWaitForResult<float>(0, 3, 3, {}).error());
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
@@ -10,7 +10,12 @@
 
 #include <gtest/gtest.h>
 
+#include "components/GnssComponent.h"
 #include "components/SensorParsingUtil.h"
+#include "communication/ConnectionNegotiator.h"
+#include "communication/SyncedModbusCommunicator.h"
+#include "properties/Ig1GnssProperties.h"
+#include "test/communication/MockbusCommunicator.h"
 
 #include <vector>
 #include <iomanip>
@@ -39,4 +44,67 @@ TEST(GnssComponent, parseCoordinateResolution) {
     // check if the relative distance was conserved
     ASSERT_NEAR(0.0000001, latFloat_move1 - latFloat, 0.00000001);
     ASSERT_NEAR(0.0000001, lonFloat_move1 - lonFloat, 0.00000001);
-}
\ No newline at end of file
+}
+
+namespace {
+    template <class T>
+    void appendScalar(std::vector<std::byte>& packet, T value) {
+        const auto bytes = reinterpret_cast<const std::byte*>(&value);
+        packet.insert(packet.end(), bytes, bytes + sizeof(value));
+    }
+}
+
+TEST(GnssComponent, parseDataPackage) {
+    using namespace zen;
+
+    ConnectionNegotiator negotiator;
+    auto mockPtr = std::make_unique<MockbusCommunicator>(negotiator, MockbusCommunicator::RepliesVector() );
+    auto syncMockPtr = std::make_unique<SyncedModbusCommunicator>(std::move(mockPtr));
+    auto properties = std::make_unique<Ig1GnssProperties>(*syncMockPtr.get());
+
+    properties->setGpsOutputDataBitset(
+        (uint64_t(1) << 0) | // iTOW, skipped
+        (uint64_t(1) << 1) | // year
+        (uint64_t(1) << 6) | // second
+        (uint64_t(1) << 10) | // fix type
+        (uint64_t(1) << 11) | // flags
+        (uint64_t(1) << 14) | // longitude
+        (uint64_t(1) << 15) | // latitude
+        (uint64_t(1) << 17) | // height above mean sea level, skipped
+        (uint64_t(1) << 28) | // heading of vehicle
+        (uint64_t(1) << (32 + 2)) // attitude roll, skipped
+    );
+
+    GnssComponent gnssComp(std::move(properties), *syncMockPtr.get(), 0);
+
+    std::vector<std::byte> packet;
+    appendScalar<uint32_t>(packet, 250);
+    appendScalar<uint32_t>(packet, 123456);
+    appendScalar<uint16_t>(packet, 2024);
+    appendScalar<uint8_t>(packet, 42);
+    appendScalar<uint8_t>(packet, ZenGnssFixType_3dFix);
+    appendScalar<uint8_t>(packet, 0x80);
+    appendScalar<int32_t>(packet, 1397242735);
+    appendScalar<int32_t>(packet, 356635894);
+    appendScalar<int32_t>(packet, -7);
+    appendScalar<int32_t>(packet, 9000000);
+    appendScalar<int32_t>(packet, -7);
+
+    auto parsed = gnssComp.processEventData(ZenEventType_GnssData, packet);
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(250, parsed->gnssData.frameCount);
+    ASSERT_NEAR(0.5, parsed->gnssData.timestamp, 1e-9);
+    ASSERT_EQ(2024, parsed->gnssData.year);
+    ASSERT_EQ(0, parsed->gnssData.month);
+    ASSERT_EQ(42, parsed->gnssData.second);
+    ASSERT_EQ(ZenGnssFixType_3dFix, parsed->gnssData.fixType);
+    ASSERT_EQ(ZenGnssFixCarrierPhaseSolution_FixedAmbiguities, parsed->gnssData.carrierPhaseSolution);
+    ASSERT_NEAR(139.7242735, parsed->gnssData.longitude, 1e-9);
+    ASSERT_NEAR(35.6635894, parsed->gnssData.latitude, 1e-9);
+    ASSERT_NEAR(90.0, parsed->gnssData.headingOfVehicle, 1e-9);
+    ASSERT_EQ(0.0, parsed->gnssData.height);
+
+    // a truncated sample fails as a whole
+    packet.pop_back();
+    ASSERT_EQ(ZenError_Io_MsgCorrupt, gnssComp.processEventData(ZenEventType_GnssData, packet).error());
+}
@@ -830,3 +830,54 @@ TEST(ImuIg1Component, parseDataPackage_16bit_rad_output) {
 
     ASSERT_NEAR(-23.1f, parsed->imuData.temperature, 0.01f);
 }
+
+TEST(ImuIg1Component, parseDataPackage_settingsChanged) {
+
+    ConnectionNegotiator negotiator;
+    auto mockPtr = std::make_unique<MockbusCommunicator>(negotiator, MockbusCommunicator::RepliesVector() );
+    auto syncMockPtr = std::make_unique<SyncedModbusCommunicator>(std::move(mockPtr));
+    auto properties = std::make_unique<Ig1ImuProperties>(*syncMockPtr.get());
+    auto& ig1Properties = *properties;
+
+    properties->setOutputDataBitset(
+        (1 << 1) | // calibrated accelerometer
+        (1 << 6) | // Align Calib Gyro 0
+        (1 << 16)  // Temperature
+    );
+    properties->setRadOutput(false);
+    properties->setLowPrecisionMode(false);
+
+    ImuIg1Component imuComp(std::move(properties), *syncMockPtr.get(), 0, true, true);
+
+    std::vector<std::byte> vecPacket32;
+    for (auto v : { uint32_to_bytes(500), float_to_bytes(1.0f), float_to_bytes(2.0f), float_to_bytes(3.0f),
+        float_to_bytes(4.0f), float_to_bytes(5.0f), float_to_bytes(6.0f), float_to_bytes(25.5f) })
+        vecPacket32.insert(vecPacket32.end(), v.begin(), v.end());
+
+    auto parsed = imuComp.processEventData(ZenEventType_ImuData, vecPacket32);
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(500u, parsed->imuData.frameCount);
+    ASSERT_FLOAT_EQ(3.0f, parsed->imuData.a[2]);
+    ASSERT_FLOAT_EQ(4.0f, parsed->imuData.g1[0]);
+    ASSERT_FLOAT_EQ(25.5f, parsed->imuData.temperature);
+
+    // the sample of the 32-bit settings is too short once the sensor outputs radians in 16-bit
+    ig1Properties.setLowPrecisionMode(true);
+    ig1Properties.setRadOutput(true);
+    auto tooShort = std::vector<std::byte>(vecPacket32.begin(), vecPacket32.begin() + 4 + 7 * 2 - 1);
+    ASSERT_EQ(ZenError_Io_MsgCorrupt, imuComp.processEventData(ZenEventType_ImuData, tooShort).error());
+
+    std::vector<std::byte> vecPacket16;
+    for (auto v : { uint32_to_bytes(501), float_to_int16_to_bytes(1.0f, 1000.0f), float_to_int16_to_bytes(2.0f, 1000.0f),
+        float_to_int16_to_bytes(3.0f, 1000.0f), float_to_int16_to_bytes(0.5f, 1000.0f), float_to_int16_to_bytes(-0.5f, 1000.0f),
+        float_to_int16_to_bytes(1.0f, 1000.0f), float_to_int16_to_bytes(25.5f, 100.0f) })
+        vecPacket16.insert(vecPacket16.end(), v.begin(), v.end());
+
+    parsed = imuComp.processEventData(ZenEventType_ImuData, vecPacket16);
+    ASSERT_TRUE(parsed);
+    ASSERT_EQ(501u, parsed->imuData.frameCount);
+    ASSERT_NEAR(3.0f, parsed->imuData.a[2], 0.001f);
+    ASSERT_NEAR(0.5f * c_radToDeg, parsed->imuData.g1[0], 0.01f);
+    ASSERT_NEAR(-0.5f * c_radToDeg, parsed->imuData.g1[1], 0.01f);
+    ASSERT_NEAR(25.5f, parsed->imuData.temperature, 0.01f);
+}
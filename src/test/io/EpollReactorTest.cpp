@@ -0,0 +1,237 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "io/interfaces/linux/EpollReactor.h"
+#include "io/interfaces/posix/PosixDeviceInterface.h"
+
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+    class ReadRecorder : public zen::IReactorReadHandler, public zen::IIoDataSubscriber
+    {
+    public:
+        ZenError processRead(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept override
+        {
+            return processData(data, receivedTimestampNs);
+        }
+
+        ZenError processData(gsl::span<const std::byte> data, uint64_t receivedTimestampNs) noexcept override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_data.insert(m_data.end(), data.begin(), data.end());
+            m_lastTimestampNs = receivedTimestampNs;
+            return ZenError_None;
+        }
+
+        std::vector<std::byte> waitForData(size_t size)
+        {
+            for (int i = 0; i < 200; ++i) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_data.size() >= size)
+                        return m_data;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_data;
+        }
+
+        uint64_t lastTimestampNs()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_lastTimestampNs;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<std::byte> m_data;
+        uint64_t m_lastTimestampNs = 0;
+    };
+
+    struct PipeSystem
+    {
+        constexpr static const char KEY[] = "Pipe";
+
+        static nonstd::expected<std::vector<int32_t>, ZenError> supportedBaudRates() noexcept { return std::vector<int32_t>{ 921600 }; }
+        static constexpr int32_t mapBaudRate(unsigned int baudRate) noexcept { return static_cast<int32_t>(baudRate); }
+        static ZenError setBaudRateForFD(int, int) noexcept { return ZenError_None; }
+    };
+
+    std::vector<std::byte> makePayload(size_t size, uint8_t seed) {
+        std::vector<std::byte> payload(size);
+        for (size_t i = 0; i < size; ++i)
+            payload[i] = std::byte(uint8_t(seed + i));
+        return payload;
+    }
+}
+
+TEST(EpollReactor, readBufferSizeFollowsBaudRate) {
+    ASSERT_EQ(zen::EpollReactor::c_minReadBufferSize, zen::EpollReactor::readBufferSizeForBaudRate(9600));
+    ASSERT_EQ(1024u, zen::EpollReactor::readBufferSizeForBaudRate(921600));
+    ASSERT_EQ(zen::EpollReactor::c_maxReadBufferSize, zen::EpollReactor::readBufferSizeForBaudRate(100000000));
+    ASSERT_EQ(ZenError_InvalidArgument, zen::EpollReactor::setThreadCount(0));
+}
+
+TEST(EpollReactor, multiplexesManyDevices) {
+    auto reactor = zen::EpollReactor::shared();
+    ASSERT_TRUE(reactor);
+    ASSERT_EQ(reactor, zen::EpollReactor::shared());
+
+    constexpr size_t nDevices = 8;
+    std::array<std::array<int, 2>, nDevices> pipes;
+    std::array<ReadRecorder, nDevices> recorders;
+    for (size_t idx = 0; idx < nDevices; ++idx) {
+        ASSERT_EQ(0, ::pipe(pipes[idx].data()));
+        ASSERT_EQ(ZenError_None, reactor->add(pipes[idx][0], recorders[idx], zen::EpollReactor::c_minReadBufferSize));
+    }
+
+    // more bytes than fit into one read buffer, which have to arrive in order
+    const size_t payloadSize = 3 * zen::EpollReactor::c_minReadBufferSize + 17;
+    for (size_t idx = 0; idx < nDevices; ++idx) {
+        const auto payload = makePayload(payloadSize, uint8_t(idx));
+        ASSERT_EQ(ssize_t(payloadSize), ::write(pipes[idx][1], payload.data(), payload.size()));
+    }
+
+    for (size_t idx = 0; idx < nDevices; ++idx) {
+        ASSERT_EQ(makePayload(payloadSize, uint8_t(idx)), recorders[idx].waitForData(payloadSize));
+        ASSERT_GT(recorders[idx].lastTimestampNs(), 0u);
+    }
+
+    // removed devices are not read anymore
+    reactor->remove(pipes[0][0]);
+    const std::byte extra{ 42 };
+    ASSERT_EQ(1, ::write(pipes[0][1], &extra, 1));
+    ASSERT_EQ(1, ::write(pipes[1][1], &extra, 1));
+    ASSERT_EQ(payloadSize + 1, recorders[1].waitForData(payloadSize + 1).size());
+    ASSERT_EQ(payloadSize, recorders[0].waitForData(payloadSize).size());
+
+    for (size_t idx = 0; idx < nDevices; ++idx) {
+        reactor->remove(pipes[idx][0]);
+        ::close(pipes[idx][0]);
+        ::close(pipes[idx][1]);
+    }
+}
+
+TEST(EpollReactor, deviceInterfacePublishesReads) {
+    std::array<int, 2> toHost, toDevice;
+    ASSERT_EQ(0, ::pipe(toHost.data()));
+    ASSERT_EQ(0, ::pipe(toDevice.data()));
+
+    ReadRecorder recorder;
+    {
+        zen::PosixDeviceInterface<PipeSystem> ioInterface(recorder, "pipe", toHost[0], toDevice[1]);
+        ASSERT_EQ(ZenError_None, ioInterface.setBaudRate(921600));
+
+        const auto payload = makePayload(2000, 3);
+        ASSERT_EQ(ssize_t(payload.size()), ::write(toHost[1], payload.data(), payload.size()));
+        ASSERT_EQ(payload, recorder.waitForData(payload.size()));
+
+        ASSERT_EQ(ZenError_None, ioInterface.send(payload));
+        std::vector<std::byte> sent(payload.size());
+        ASSERT_EQ(ssize_t(sent.size()), ::read(toDevice[0], sent.data(), sent.size()));
+        ASSERT_EQ(payload, sent);
+    }
+
+    // the interface closed its ends of the pipes
+    ::close(toHost[1]);
+    ::close(toDevice[0]);
+}
+
+TEST(EpollReactor, readChunkSizeBoundsReads) {
+    std::array<int, 2> toHost, toDevice;
+    ASSERT_EQ(0, ::pipe(toHost.data()));
+    ASSERT_EQ(0, ::pipe(toDevice.data()));
+
+    ReadRecorder recorder;
+    {
+        zen::PosixDeviceInterface<PipeSystem> ioInterface(recorder, "pipe", toHost[0], toDevice[1]);
+
+        // an explicit chunk size is kept when the baud rate changes
+        constexpr size_t chunkSize = 64;
+        ioInterface.setReadChunkSize(chunkSize);
+        ASSERT_EQ(ZenError_None, ioInterface.setBaudRate(921600));
+
+        const auto payload = makePayload(1000, 5);
+        ASSERT_EQ(ssize_t(payload.size()), ::write(toHost[1], payload.data(), payload.size()));
+        ASSERT_EQ(payload, recorder.waitForData(payload.size()));
+
+        const auto statistics = ioInterface.ioStatistics();
+        ASSERT_TRUE(statistics);
+        ASSERT_EQ(payload.size(), statistics->bytesRead);
+        ASSERT_GE(statistics->readCount, (payload.size() + chunkSize - 1) / chunkSize);
+        ASSERT_GE(statistics->maxReadLatencyNs, statistics->meanReadLatencyNs);
+    }
+
+    ::close(toHost[1]);
+    ::close(toDevice[0]);
+}
+
+TEST(EpollReactor, queuedSendsKeepTheirOrder) {
+    std::array<int, 2> toHost, toDevice;
+    ASSERT_EQ(0, ::pipe(toHost.data()));
+    ASSERT_EQ(0, ::pipe(toDevice.data()));
+
+    ReadRecorder recorder;
+    {
+        zen::PosixDeviceInterface<PipeSystem> ioInterface(recorder, "pipe", toHost[0], toDevice[1]);
+
+        // more data than fits into the pipe, so writes are partial and wait for the device
+        constexpr size_t nFrames = 100;
+        constexpr size_t frameSize = 1000;
+        std::mutex mutex;
+        std::vector<size_t> completed;
+        std::vector<std::byte> expected;
+        for (size_t idx = 0; idx < nFrames; ++idx) {
+            auto frame = makePayload(frameSize, uint8_t(idx));
+            expected.insert(expected.end(), frame.begin(), frame.end());
+            ASSERT_EQ(ZenError_None, ioInterface.sendAsync(std::move(frame), [&mutex, &completed, idx](ZenError error) {
+                ASSERT_EQ(ZenError_None, error);
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back(idx);
+            }));
+        }
+
+        std::vector<std::byte> received(expected.size());
+        size_t nReceived = 0;
+        while (nReceived < received.size()) {
+            const auto nBytes = ::read(toDevice[0], received.data() + nReceived, received.size() - nReceived);
+            ASSERT_GT(nBytes, 0);
+            nReceived += size_t(nBytes);
+        }
+        ASSERT_EQ(expected, received);
+
+        for (int i = 0; i < 200; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (completed.size() == nFrames)
+                    break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(nFrames, completed.size());
+        for (size_t idx = 0; idx < nFrames; ++idx)
+            ASSERT_EQ(idx, completed[idx]);
+    }
+
+    ::close(toHost[1]);
+    ::close(toDevice[0]);
+}
@@ -0,0 +1,135 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "io/systems/linux/LinuxDeviceMonitor.h"
+#include "io/systems/linux/LinuxDeviceSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#include <asm/termbits.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+TEST(LinuxDeviceSystem, setsArbitraryBaudRate) {
+    // a pseudo terminal stores any baud rate like a capable USB serial adapter
+    const int master = ::posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, master);
+    ASSERT_EQ(0, ::grantpt(master));
+    ASSERT_EQ(0, ::unlockpt(master));
+    const int fd = ::open(::ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_NE(-1, fd);
+
+    for (const unsigned int baudRate : { 2000000u, 1234567u, 921600u }) {
+        const auto speed = zen::LinuxDeviceSystem::mapBaudRate(baudRate);
+        ASSERT_EQ(ZenError_None, zen::LinuxDeviceSystem::setBaudRateForFD(fd, speed));
+
+        struct termios2 config;
+        ASSERT_EQ(0, ::ioctl(fd, TCGETS2, &config));
+        ASSERT_EQ(baudRate, config.c_ispeed);
+        ASSERT_EQ(baudRate, config.c_ospeed);
+    }
+
+    const auto baudRates = zen::LinuxDeviceSystem::supportedBaudRates();
+    ASSERT_TRUE(baudRates);
+    ASSERT_NE(baudRates->end(), std::find(baudRates->begin(), baudRates->end(), 2000000));
+
+    ::close(fd);
+    ::close(master);
+}
+
+namespace
+{
+    /** Adds a USB serial device to a sysfs tree and returns the DEVPATH of its tty */
+    std::string addUsbSerialDevice(const std::filesystem::path& root, const std::string& port,
+        const std::string& vendor, const std::string& serial, const std::string& tty)
+    {
+        const auto device = root / "devices/usb1" / port;
+        const auto ttyPath = device / (port + ":1.0") / tty / "tty" / tty;
+        std::filesystem::create_directories(ttyPath);
+        std::ofstream(device / "idVendor") << vendor << "\n";
+        std::ofstream(device / "idProduct") << "ea60\n";
+        std::ofstream(device / "serial") << serial << "\n";
+
+        std::filesystem::create_directories(root / "bus/usb/devices");
+        std::filesystem::create_directory_symlink(device, root / "bus/usb/devices" / port);
+
+        return "/" + std::filesystem::relative(ttyPath, root).string();
+    }
+
+    std::string uevent(const std::string& action, const std::string& devPath, const std::string& tty)
+    {
+        const std::string header = action + "@" + devPath;
+        return header + '\0' + "ACTION=" + action + '\0' + "DEVPATH=" + devPath + '\0'
+            + "SUBSYSTEM=tty" + '\0' + "MAJOR=188" + '\0' + "DEVNAME=" + tty + '\0' + "SEQNUM=4711" + '\0';
+    }
+}
+
+TEST(LinuxDeviceMonitor, parseUevent) {
+    const auto message = uevent("add", "/devices/usb1/1-6/1-6:1.0/ttyUSB0/tty/ttyUSB0", "ttyUSB0");
+    const auto parsed = zen::Uevent::parse(gsl::span<const char>(message.data(), message.size()));
+    ASSERT_TRUE(parsed.has_value());
+    ASSERT_EQ("add", parsed->action);
+    ASSERT_EQ("tty", parsed->subsystem);
+    ASSERT_EQ("/devices/usb1/1-6/1-6:1.0/ttyUSB0/tty/ttyUSB0", parsed->devPath);
+    ASSERT_EQ("ttyUSB0", parsed->devName);
+
+    // udev re-broadcasts uevents with a binary header
+    const std::string udev = std::string("libudev") + '\0' + "ACTION=add" + '\0';
+    ASSERT_FALSE(zen::Uevent::parse(gsl::span<const char>(udev.data(), udev.size())).has_value());
+}
+
+TEST(LinuxDeviceMonitor, tracksHotplug) {
+    const auto root = std::filesystem::temp_directory_path() / ("openzen-sysfs-" + std::to_string(::getpid()));
+    std::filesystem::remove_all(root);
+    addUsbSerialDevice(root, "1-6", "10c4", "lpmsig1000123", "ttyUSB0");
+    const auto ftdiPath = addUsbSerialDevice(root, "1-7", "0403", "ft12345", "ttyUSB1");
+
+    std::vector<std::pair<std::string, bool>> changes;
+    auto monitor = zen::LinuxDeviceMonitor::create([&changes](const zen::LinuxDeviceMonitor::Device& device, bool added) {
+        changes.emplace_back(device.deviceFile, added);
+    }, root.string());
+    ASSERT_NE(nullptr, monitor);
+
+    auto devices = monitor->devices();
+    ASSERT_EQ(1u, devices.size());
+    ASSERT_EQ("lpmsig1000123", devices[0].serialNumber);
+    ASSERT_EQ("/dev/ttyUSB0", devices[0].deviceFile);
+
+    // the sysfs directory exists before the kernel sends the uevent
+    const auto addedPath = addUsbSerialDevice(root, "1-8", "10c4", "lpmsig1000456", "ttyUSB2");
+    const auto message = uevent("add", addedPath, "ttyUSB2");
+    monitor->processUevent(*zen::Uevent::parse(gsl::span<const char>(message.data(), message.size())));
+    monitor->processUevent({ "add", "tty", ftdiPath, "ttyUSB1" });
+    ASSERT_EQ(std::vector<std::string>{ "/dev/ttyUSB2" }, monitor->deviceFiles("lpmsig1000456"));
+    ASSERT_EQ(2u, monitor->devices().size());
+
+    std::filesystem::remove_all(root / "devices/usb1/1-6");
+    std::filesystem::remove(root / "bus/usb/devices/1-6");
+    monitor->processUevent({ "remove", "tty", "/devices/usb1/1-6/1-6:1.0/ttyUSB0/tty/ttyUSB0", "ttyUSB0" });
+    devices = monitor->devices();
+    ASSERT_EQ(1u, devices.size());
+    ASSERT_EQ("lpmsig1000456", devices[0].serialNumber);
+    ASSERT_TRUE(monitor->deviceFiles("lpmsig1000123").empty());
+
+    // without a uevent socket every query rescans and nothing is reported
+    if (monitor->monitoring()) {
+        const std::vector<std::pair<std::string, bool>> expected{ { "/dev/ttyUSB2", true }, { "/dev/ttyUSB0", false } };
+        ASSERT_EQ(expected, changes);
+    }
+
+    monitor.reset();
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,467 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include "test/io/PtySensorSimulator.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+#include "InternalTypes.h"
+
+namespace zen
+{
+    namespace
+    {
+        using Property = EDevicePropertyV1;
+
+        constexpr uint16_t fn(Property property) { return static_cast<uint16_t>(property); }
+
+        // Setters which store a value for their getter
+        constexpr std::array<std::pair<Property, Property>, 29> c_registers = {{
+            { Property::SetImuTransmitData, Property::GetImuTransmitData },
+            { Property::SetImuId, Property::GetImuId },
+            { Property::SetStreamFreq, Property::GetStreamFreq },
+            { Property::SetDegGradOutput, Property::GetDegGradOutput },
+            { Property::SetAccRange, Property::GetAccRange },
+            { Property::SetGyrRange, Property::GetGyrRange },
+            { Property::SetEnableGyrAutoCalibration, Property::GetEnableGyrAutoCalibration },
+            { Property::SetGyrThreshold, Property::GetGyrThreshold },
+            { Property::SetMagRange, Property::GetMagRange },
+            { Property::SetMagCalibrationTimeout, Property::GetMagCalibrationTimeout },
+            { Property::SetFilterMode, Property::GetFilterMode },
+            { Property::SetCanStartId, Property::GetCanStartId },
+            { Property::SetCanBaudRate, Property::GetCanBaudRate },
+            { Property::SetCanDataPrecision, Property::GetCanDataPrecision },
+            { Property::SetCanMode, Property::GetCanMode },
+            { Property::SetCanMapping, Property::GetCanMapping },
+            { Property::SetCanHeartbeat, Property::GetCanHeartbeat },
+            { Property::SetUartBaudrate, Property::GetUartBaudrate },
+            { Property::SetUartFormat, Property::GetUartFormat },
+            { Property::SetUartAsciiCharacter, Property::GetUartAsciiCharacter },
+            { Property::SetLpBusDataPrecision, Property::GetLpBusDataPrecision },
+            { Property::SetGpsTransmitData, Property::GetGpsTransmitData },
+            { Property::SetGyrFilter, Property::GetGyrFilter },
+            // Commands without a value
+            { Property::WriteRegisters, Property::Ack },
+            { Property::SetOrientationOffsetMode, Property::Ack },
+            { Property::ResetOrientationOffset, Property::Ack },
+            { Property::StartGyroCalibration, Property::Ack },
+            { Property::StartMagCalibration, Property::Ack },
+            { Property::StopMagCalibration, Property::Ack },
+        }};
+
+        struct OutputField
+        {
+            unsigned int count;
+            // Denominators of 16-bit output, see ImuIg1Component::parseSensorData
+            float degreeDenominator;
+            float radianDenominator;
+            bool angular;
+        };
+
+        // Fields of GetRawImuSensorData in the order of their bit in the output bitset
+        constexpr std::array<OutputField, 17> c_outputFields = {{
+            { 3, 1000.0f, 1000.0f, false },   // raw accelerometer (g)
+            { 3, 1000.0f, 1000.0f, false },   // calibrated accelerometer (g)
+            { 3, 10.0f, 1000.0f, true },      // raw gyroscope 0
+            { 3, 10.0f, 100.0f, true },       // raw gyroscope 1
+            { 3, 10.0f, 1000.0f, true },      // bias calibrated gyroscope 0
+            { 3, 10.0f, 100.0f, true },       // bias calibrated gyroscope 1
+            { 3, 10.0f, 1000.0f, true },      // alignment calibrated gyroscope 0
+            { 3, 10.0f, 100.0f, true },       // alignment calibrated gyroscope 1
+            { 3, 100.0f, 100.0f, false },     // raw magnetometer (uT)
+            { 3, 100.0f, 100.0f, false },     // calibrated magnetometer (uT)
+            { 3, 100.0f, 100.0f, true },      // angular velocity
+            { 4, 10000.0f, 10000.0f, false }, // quaternion
+            { 3, 100.0f, 10000.0f, true },    // euler angles
+            { 3, 1000.0f, 1000.0f, false },   // linear acceleration (g)
+            { 1, 1.0f, 1.0f, false },         // pressure (not output by the firmware)
+            { 1, 1.0f, 1.0f, false },         // altitude (not output by the firmware)
+            { 1, 100.0f, 100.0f, false },     // temperature (degree celsius)
+        }};
+
+        constexpr double c_pi = 3.14159265358979323846;
+
+        /** Values of the output field at time t (s), angles in degrees */
+        std::array<float, 4> syntheticValues(size_t bit, double t)
+        {
+            const double yaw = 30.0 * std::sin(2.0 * c_pi * 0.5 * t);
+            const double yawRate = 30.0 * 2.0 * c_pi * 0.5 * std::cos(2.0 * c_pi * 0.5 * t);
+            const double halfYaw = yaw * c_pi / 360.0;
+
+            switch (bit)
+            {
+            case 0:
+            case 1:
+                return { 0.0f, 0.0f, -1.0f, 0.0f };
+            case 8:
+            case 9:
+                return { static_cast<float>(30.0 * std::cos(yaw * c_pi / 180.0)), static_cast<float>(-30.0 * std::sin(yaw * c_pi / 180.0)), -40.0f, 0.0f };
+            case 11:
+                return { static_cast<float>(std::cos(halfYaw)), 0.0f, 0.0f, static_cast<float>(std::sin(halfYaw)) };
+            case 12:
+                return { 0.0f, 0.0f, static_cast<float>(yaw), 0.0f };
+            case 13:
+            case 15:
+                return { 0.0f, 0.0f, 0.0f, 0.0f };
+            case 14:
+                return { 1013.25f, 0.0f, 0.0f, 0.0f };
+            case 16:
+                return { 25.0f, 0.0f, 0.0f, 0.0f };
+            default:
+                // gyroscopes and angular velocity
+                return { 0.0f, 0.0f, static_cast<float>(yawRate), 0.0f };
+            }
+        }
+
+        template <typename T>
+        void append(std::vector<std::byte>& buffer, T value)
+        {
+            const auto bytes = reinterpret_cast<const std::byte*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        std::vector<std::byte> makeString(const std::string& value)
+        {
+            std::vector<std::byte> buffer(24, std::byte(0));
+            std::memcpy(buffer.data(), value.data(), std::min(value.size(), buffer.size()));
+            return buffer;
+        }
+    }
+
+    std::unique_ptr<PtySensorSimulator> PtySensorSimulator::create(PtySensorSimulatorOptions options) noexcept
+    {
+        const int masterFd = ::posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (masterFd == -1)
+        {
+            spdlog::error("Cannot open pseudo-terminal: {}", std::strerror(errno));
+            return nullptr;
+        }
+
+        if (::grantpt(masterFd) != 0 || ::unlockpt(masterFd) != 0)
+        {
+            spdlog::error("Cannot unlock pseudo-terminal: {}", std::strerror(errno));
+            ::close(masterFd);
+            return nullptr;
+        }
+
+        std::string deviceFile = ::ptsname(masterFd);
+        const int slaveFd = ::open(deviceFile.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (slaveFd == -1)
+        {
+            spdlog::error("Cannot open pseudo-terminal {}: {}", deviceFile, std::strerror(errno));
+            ::close(masterFd);
+            return nullptr;
+        }
+
+        // The host configures the terminal as well, but frames must not be altered before it connected
+        struct termios config;
+        if (::tcgetattr(slaveFd, &config) == 0)
+        {
+            ::cfmakeraw(&config);
+            ::tcsetattr(slaveFd, TCSANOW, &config);
+        }
+
+        return std::unique_ptr<PtySensorSimulator>(new PtySensorSimulator(std::move(options), masterFd, slaveFd, std::move(deviceFile)));
+    }
+
+    PtySensorSimulator::PtySensorSimulator(PtySensorSimulatorOptions options, int masterFd, int slaveFd, std::string deviceFile) noexcept
+        : m_options(std::move(options))
+        , m_masterFd(masterFd)
+        , m_slaveFd(slaveFd)
+        , m_deviceFile(std::move(deviceFile))
+        , m_factory(std::make_unique<modbus::LpFrameFactory>())
+        , m_streaming(m_options.streaming)
+        , m_samplesSent(0)
+        , m_samplesDropped(0)
+        , m_commandsReceived(0)
+        , m_sampleIndex(0)
+        , m_terminate(false)
+    {
+        restoreFactorySettings();
+        m_thread = std::thread(&PtySensorSimulator::run, this);
+    }
+
+    PtySensorSimulator::~PtySensorSimulator()
+    {
+        m_terminate = true;
+        m_thread.join();
+
+        ::close(m_slaveFd);
+        ::close(m_masterFd);
+    }
+
+    void PtySensorSimulator::restoreFactorySettings() noexcept
+    {
+        m_registers.clear();
+        setRegister(fn(Property::GetImuTransmitData), m_options.outputDataBitset);
+        setRegister(fn(Property::GetImuId), m_options.sensorId);
+        setRegister(fn(Property::GetStreamFreq), m_options.samplingRate);
+        setRegister(fn(Property::GetDegGradOutput), 0);
+        setRegister(fn(Property::GetAccRange), 8);
+        setRegister(fn(Property::GetGyrRange), 2000);
+        setRegister(fn(Property::GetEnableGyrAutoCalibration), 1);
+        setRegister(fn(Property::GetMagRange), 8);
+        setRegister(fn(Property::GetMagCalibrationTimeout), 20);
+        setRegister(fn(Property::GetFilterMode), 1);
+        setRegister(fn(Property::GetUartBaudrate), 921600);
+        setRegister(fn(Property::GetLpBusDataPrecision), 1);
+
+        std::vector<std::byte> threshold;
+        append(threshold, 0.05f);
+        m_registers[fn(Property::GetGyrThreshold)] = std::move(threshold);
+
+        std::vector<std::byte> gpsBitset;
+        append<uint32_t>(gpsBitset, 0);
+        append<uint32_t>(gpsBitset, 0);
+        m_registers[fn(Property::GetGpsTransmitData)] = std::move(gpsBitset);
+
+        m_registers[fn(Property::GetCanMapping)] = std::vector<std::byte>(16 * sizeof(int32_t), std::byte(0));
+    }
+
+    uint32_t PtySensorSimulator::registerValue(uint16_t getter) const noexcept
+    {
+        auto it = m_registers.find(getter);
+        if (it == m_registers.end() || it->second.size() < sizeof(uint32_t))
+            return 0;
+
+        uint32_t value;
+        std::memcpy(&value, it->second.data(), sizeof(value));
+        return value;
+    }
+
+    void PtySensorSimulator::setRegister(uint16_t getter, uint32_t value) noexcept
+    {
+        std::vector<std::byte> buffer;
+        append(buffer, value);
+        m_registers[getter] = std::move(buffer);
+    }
+
+    std::chrono::nanoseconds PtySensorSimulator::samplePeriod() const noexcept
+    {
+        const uint32_t rate = std::max<uint32_t>(registerValue(fn(Property::GetStreamFreq)), 1);
+        return std::chrono::nanoseconds(1000000000 / rate);
+    }
+
+    void PtySensorSimulator::run() noexcept
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Bounds the time until a termination is noticed
+        constexpr auto maxWait = std::chrono::milliseconds(20);
+
+        std::array<std::byte, 4096> buffer;
+        auto nextSample = clock::now();
+
+        while (!m_terminate)
+        {
+            auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(maxWait);
+            if (m_streaming)
+                timeout = std::clamp<std::chrono::nanoseconds>(nextSample - clock::now(), std::chrono::nanoseconds(0), timeout);
+
+            pollfd pfd{};
+            pfd.fd = m_masterFd;
+            pfd.events = POLLIN | (m_pending.empty() ? 0 : POLLOUT);
+
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            const timespec ts{ static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count()) };
+            if (::ppoll(&pfd, 1, &ts, nullptr) == -1 && errno != EINTR)
+            {
+                spdlog::error("Polling pseudo-terminal {} failed: {}", m_deviceFile, std::strerror(errno));
+                return;
+            }
+
+            if (pfd.revents & POLLIN)
+            {
+                const auto nBytes = ::read(m_masterFd, buffer.data(), buffer.size());
+                gsl::span<const std::byte> data(buffer.data(), nBytes > 0 ? static_cast<size_t>(nBytes) : 0);
+                while (!data.empty())
+                {
+                    if (m_parser.parse(data) != modbus::FrameParseError_None)
+                    {
+                        m_parser.reset();
+                        data = data.subspan(1);
+                        continue;
+                    }
+
+                    if (m_parser.finished())
+                    {
+                        const auto& frame = m_parser.frame();
+                        processCommand(frame.function, frame.data);
+                        m_parser.reset();
+                    }
+                }
+            }
+
+            if (m_streaming)
+            {
+                const auto now = clock::now();
+                const auto period = samplePeriod();
+
+                // Catch up with short delays of the thread, but do not send a burst after a long one
+                if (now - nextSample > 100 * period)
+                    nextSample = now;
+
+                while (nextSample <= now)
+                {
+                    sendSample();
+                    nextSample += period;
+                }
+            }
+            else
+            {
+                nextSample = clock::now();
+            }
+
+            flush();
+        }
+    }
+
+    void PtySensorSimulator::processCommand(uint16_t function, gsl::span<const std::byte> data) noexcept
+    {
+        ++m_commandsReceived;
+
+        switch (static_cast<Property>(function))
+        {
+        case Property::GotoCommandMode:
+            m_streaming = false;
+            return reply(fn(Property::Ack));
+
+        case Property::GotoStreamMode:
+            m_streaming = true;
+            return reply(fn(Property::Ack));
+
+        case Property::RestoreFactorySettings:
+            restoreFactorySettings();
+            return reply(fn(Property::Ack));
+
+        case Property::GetSensorStatus:
+        {
+            std::vector<std::byte> status;
+            append<uint32_t>(status, m_streaming ? 1 : 0);
+            return reply(function, status);
+        }
+
+        case Property::GetRawImuSensorData:
+            return sendSample();
+
+        case Property::GetSensorModel:
+            return reply(function, makeString(m_options.sensorModel));
+
+        case Property::GetFirmwareInfo:
+            return reply(function, makeString("OpenZen simulator 1.0"));
+
+        case Property::GetSerialNumber:
+            return reply(function, makeString("SIM-" + m_deviceFile.substr(m_deviceFile.find_last_of('/') + 1)));
+
+        case Property::GetFilterVersion:
+            return reply(function, makeString("1.0"));
+
+        case Property::SetTimestamp:
+            if (data.size() == sizeof(uint32_t))
+                std::memcpy(&m_sampleIndex, data.data(), sizeof(m_sampleIndex));
+            return reply(fn(Property::Ack));
+
+        case Property::SaveGpsState:
+        case Property::ClearGpsState:
+        case Property::SetRtkCorrection:
+            return reply(fn(Property::Ack));
+
+        default:
+            break;
+        }
+
+        for (const auto& [setter, getter] : c_registers)
+        {
+            if (function == fn(setter))
+            {
+                if (getter != Property::Ack)
+                    m_registers[fn(getter)].assign(data.begin(), data.end());
+                return reply(fn(Property::Ack));
+            }
+
+            if (function == fn(getter) && getter != Property::Ack)
+                return reply(function, m_registers[function]);
+        }
+
+        spdlog::debug("Simulated sensor on {} does not support function {}", m_deviceFile, function);
+        reply(fn(Property::Nack));
+    }
+
+    void PtySensorSimulator::sendSample() noexcept
+    {
+        const uint32_t bitset = registerValue(fn(Property::GetImuTransmitData));
+        const bool radianOutput = registerValue(fn(Property::GetDegGradOutput)) != 0;
+        const bool lowPrecision = registerValue(fn(Property::GetLpBusDataPrecision)) == 0;
+        const double t = m_sampleIndex * std::chrono::duration<double>(samplePeriod()).count();
+
+        std::vector<std::byte> sample;
+        sample.reserve(256);
+        append(sample, m_sampleIndex++);
+
+        for (size_t bit = 0; bit < c_outputFields.size(); ++bit)
+        {
+            if ((bitset & (1u << bit)) == 0)
+                continue;
+
+            const auto& field = c_outputFields[bit];
+            const auto values = syntheticValues(bit, t);
+            for (unsigned int idx = 0; idx < field.count; ++idx)
+            {
+                float value = values[idx];
+                if (field.angular && radianOutput)
+                    value = static_cast<float>(value * c_pi / 180.0);
+
+                if (lowPrecision)
+                    append(sample, static_cast<int16_t>(std::lround(value * (radianOutput ? field.radianDenominator : field.degreeDenominator))));
+                else
+                    append(sample, value);
+            }
+        }
+
+        if (m_pending.size() >= c_maxPendingBytes)
+        {
+            ++m_samplesDropped;
+            return;
+        }
+
+        reply(fn(Property::GetRawImuSensorData), sample);
+        ++m_samplesSent;
+    }
+
+    void PtySensorSimulator::reply(uint16_t function, gsl::span<const std::byte> data) noexcept
+    {
+        const auto frame = m_factory->makeFrame(m_options.sensorId, function, data.data(), static_cast<uint16_t>(data.size()));
+        m_pending.insert(m_pending.end(), frame.begin(), frame.end());
+    }
+
+    void PtySensorSimulator::flush() noexcept
+    {
+        while (!m_pending.empty())
+        {
+            const auto nBytes = ::write(m_masterFd, m_pending.data(), m_pending.size());
+            if (nBytes <= 0)
+                return;
+
+            m_pending.erase(m_pending.begin(), m_pending.begin() + nBytes);
+        }
+    }
+}
@@ -0,0 +1,132 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_TEST_IO_PTYSENSORSIMULATOR_H_
+#define ZEN_TEST_IO_PTYSENSORSIMULATOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gsl/span>
+
+#include "communication/Modbus.h"
+
+namespace zen
+{
+    struct PtySensorSimulatorOptions
+    {
+        /** Reply to EDevicePropertyV1::GetSensorModel, selects the sensor configuration of the host */
+        std::string sensorModel = "LPMS-IG1-RS232";
+
+        /** Initial output bitset, see EDevicePropertyV1::SetImuTransmitData. Defaults to calibrated
+         * accelerometer, aligned gyroscope 0, calibrated magnetometer, quaternion and euler angles.
+         */
+        uint32_t outputDataBitset = (1 << 1) | (1 << 6) | (1 << 9) | (1 << 11) | (1 << 12);
+
+        /** Initial streaming rate (Hz), see EDevicePropertyV1::SetStreamFreq */
+        uint32_t samplingRate = 100;
+
+        /** Whether the sensor streams before it receives a command, like an IG1 after power-up */
+        bool streaming = true;
+
+        /** Address of the frames sent by the sensor */
+        uint8_t sensorId = 1;
+    };
+
+    /**
+    Simulates an IG1 sensor on a Linux pseudo-terminal, so the whole stack from LinuxDeviceSystem
+    over the connection negotiation down to the parsing of IMU samples can be exercised without
+    hardware. Connect to it with the LinuxDevice IO system and identifier().
+
+    The simulator answers the EDevicePropertyV1 commands the host uses, stores the values of all
+    setters and streams GetRawImuSensorData frames with synthetic waveforms for the configured
+    output bitset, precision and units. The timestamp field of a sample counts the samples instead
+    of 2 ms ticks, so samples lost on the way to the host show up as gaps.
+    */
+    class PtySensorSimulator
+    {
+    public:
+        /** Bytes buffered for the host before samples are dropped, like a sensor which cannot stall its UART */
+        constexpr static size_t c_maxPendingBytes = 65536;
+
+        /** Opens a pseudo-terminal and starts the sensor, nullptr if no pseudo-terminal is available */
+        static std::unique_ptr<PtySensorSimulator> create(PtySensorSimulatorOptions options = {}) noexcept;
+
+        ~PtySensorSimulator();
+
+        PtySensorSimulator(const PtySensorSimulator&) = delete;
+        PtySensorSimulator& operator=(const PtySensorSimulator&) = delete;
+
+        /** Path of the pseudo-terminal the host connects to */
+        const std::string& deviceFile() const noexcept { return m_deviceFile; }
+
+        /** Sensor identifier for the LinuxDevice IO system */
+        std::string identifier() const { return "devicefile:" + m_deviceFile; }
+
+        bool streaming() const noexcept { return m_streaming; }
+
+        uint64_t samplesSent() const noexcept { return m_samplesSent; }
+        uint64_t samplesDropped() const noexcept { return m_samplesDropped; }
+        uint64_t commandsReceived() const noexcept { return m_commandsReceived; }
+
+    private:
+        PtySensorSimulator(PtySensorSimulatorOptions options, int masterFd, int slaveFd, std::string deviceFile) noexcept;
+
+        void run() noexcept;
+
+        void processCommand(uint16_t function, gsl::span<const std::byte> data) noexcept;
+
+        void sendSample() noexcept;
+
+        void reply(uint16_t function, gsl::span<const std::byte> data = {}) noexcept;
+
+        void flush() noexcept;
+
+        uint32_t registerValue(uint16_t getter) const noexcept;
+
+        void setRegister(uint16_t getter, uint32_t value) noexcept;
+
+        void restoreFactorySettings() noexcept;
+
+        std::chrono::nanoseconds samplePeriod() const noexcept;
+
+        const PtySensorSimulatorOptions m_options;
+        const int m_masterFd;
+        // Held open, so the master does not report a hang-up while the host is not connected
+        const int m_slaveFd;
+        const std::string m_deviceFile;
+
+        std::unique_ptr<modbus::IFrameFactory> m_factory;
+        modbus::LpFrameParser m_parser;
+
+        // Values of the getters, which their setter stores
+        std::map<uint16_t, std::vector<std::byte>> m_registers;
+
+        std::vector<std::byte> m_pending;
+
+        std::atomic_bool m_streaming;
+        std::atomic_uint64_t m_samplesSent;
+        std::atomic_uint64_t m_samplesDropped;
+        std::atomic_uint64_t m_commandsReceived;
+        uint32_t m_sampleIndex;
+
+        std::atomic_bool m_terminate;
+        std::thread m_thread;
+    };
+}
+
+#endif
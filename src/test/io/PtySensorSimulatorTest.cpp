@@ -0,0 +1,89 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "OpenZen.h"
+#include "test/io/PtySensorSimulator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace {
+    class SampleRecorder
+    {
+    public:
+        void process(const ZenEvent& event)
+        {
+            if (event.eventType != ZenEventType_ImuData)
+                return;
+
+            const auto& imu = event.data.imuData;
+            if (m_count > 0 && imu.frameCount != m_lastFrameCount + 1)
+                ++m_gaps;
+
+            const float norm = std::sqrt(imu.q[0] * imu.q[0] + imu.q[1] * imu.q[1] + imu.q[2] * imu.q[2] + imu.q[3] * imu.q[3]);
+            if (std::abs(norm - 1.0f) > 0.01f)
+                ++m_invalid;
+
+            m_lastFrameCount = imu.frameCount;
+            ++m_count;
+        }
+
+        std::atomic_int m_count{0};
+        std::atomic_int m_gaps{0};
+        std::atomic_int m_invalid{0};
+
+    private:
+        int32_t m_lastFrameCount = 0;
+    };
+}
+
+TEST(PtySensorSimulator, streamsThroughLinuxDeviceSystem) {
+    zen::PtySensorSimulatorOptions options;
+    options.samplingRate = 200;
+    auto simulator = zen::PtySensorSimulator::create(options);
+    ASSERT_TRUE(simulator);
+
+    auto client = zen::make_client();
+    ASSERT_EQ(ZenError_None, client.first);
+
+    auto sensor = client.second.obtainSensorByName("LinuxDevice", simulator->identifier());
+    ASSERT_EQ(ZenSensorInitError_None, sensor.first);
+    ASSERT_TRUE(simulator->streaming());
+
+    auto imu = sensor.second.getAnyComponentOfType(g_zenSensorType_Imu);
+    ASSERT_TRUE(imu);
+
+    SampleRecorder recorder;
+    ASSERT_EQ(ZenError_None, sensor.second.onEvent([&recorder](const ZenEvent& event) { recorder.process(event); }));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_GT(recorder.m_count.load(), 50);
+    ASSERT_EQ(0, recorder.m_gaps.load());
+    ASSERT_EQ(0, recorder.m_invalid.load());
+
+    // properties are stored by the simulator and change the streamed samples
+    ASSERT_EQ(ZenError_None, imu->setInt32Property(ZenImuProperty_SamplingRate, 500));
+    ASSERT_EQ(500, imu->getInt32Property(ZenImuProperty_SamplingRate).second);
+    ASSERT_EQ(ZenError_None, imu->setBoolProperty(ZenImuProperty_OutputLinearAcc, true));
+    ASSERT_EQ(ZenError_None, imu->setBoolProperty(ZenImuProperty_OutputLowPrecision, true));
+
+    const int countBefore = recorder.m_count.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_GT(recorder.m_count.load() - countBefore, 150);
+    ASSERT_EQ(0, recorder.m_invalid.load());
+    ASSERT_EQ(0u, simulator->samplesDropped());
+
+    sensor.second.release();
+    client.second.close();
+}
@@ -0,0 +1,201 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "InternalTypes.h"
+#include "SensorClient.h"
+#include "communication/ConnectionNegotiator.h"
+#include "communication/Modbus.h"
+#include "communication/ModbusCommunicator.h"
+#include "io/IoCapture.h"
+#include "io/interfaces/ReplayInterface.h"
+#include "io/systems/ReplaySystem.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace zen;
+
+namespace {
+    std::vector<std::byte> makeFrame(uint16_t function, std::vector<std::byte> data = {})
+    {
+        modbus::LpFrameFactory lpFactory;
+        const modbus::IFrameFactory& factory = lpFactory;
+        return factory.makeFrame(0, function, data.data(), static_cast<uint16_t>(data.size()));
+    }
+
+    ZenSensorDesc replayDesc(const std::string& identifier)
+    {
+        ZenSensorDesc desc{};
+        std::strncpy(desc.ioType, ReplaySystem::KEY, sizeof(desc.ioType) - 1);
+        std::strncpy(desc.identifier, identifier.c_str(), sizeof(desc.identifier) - 1);
+        return desc;
+    }
+
+    void recordNegotiation(IoCapture& capture)
+    {
+        capture.record(IoCaptureDirection::Sent, makeFrame(uint16_t(EDevicePropertyV0::SetCommandMode)), 1000);
+        capture.record(IoCaptureDirection::Received, makeFrame(uint16_t(EDevicePropertyV0::Ack)), 2000);
+        capture.record(IoCaptureDirection::Sent, makeFrame(uint16_t(EDevicePropertyV1::GetFirmwareInfo)), 3000);
+        capture.record(IoCaptureDirection::Received, makeFrame(uint16_t(EDevicePropertyV1::GetFirmwareInfo),
+            { std::byte(0), std::byte(0), std::byte(0), std::byte(23) }), 4000);
+    }
+}
+
+TEST(Replay, captureRoundTrip) {
+    const std::string path = testing::TempDir() + "captureRoundTrip" + IoCapture::c_fileExtension;
+    const std::vector<std::byte> sent = { std::byte(1), std::byte(2) };
+    const std::vector<std::byte> received = { std::byte(3), std::byte(4), std::byte(5) };
+
+    {
+        auto capture = IoCapture::open(path);
+        ASSERT_TRUE(capture);
+        capture->record(IoCaptureDirection::Sent, sent, 10);
+        capture->record(IoCaptureDirection::Received, received, 20);
+        capture->record(IoCaptureDirection::Received, {}, 30);
+    }
+
+    auto records = IoCapture::load(path);
+    ASSERT_TRUE(records);
+    ASSERT_EQ(3u, records->size());
+    ASSERT_EQ(10u, (*records)[0].timestampNs);
+    ASSERT_EQ(IoCaptureDirection::Sent, (*records)[0].direction);
+    ASSERT_EQ(sent, (*records)[0].data);
+    ASSERT_EQ(20u, (*records)[1].timestampNs);
+    ASSERT_EQ(IoCaptureDirection::Received, (*records)[1].direction);
+    ASSERT_EQ(received, (*records)[1].data);
+    ASSERT_TRUE((*records)[2].data.empty());
+
+    std::remove(path.c_str());
+    ASSERT_FALSE(IoCapture::load(path));
+}
+
+TEST(Replay, rejectCorruptRecordSize) {
+    const std::string path = testing::TempDir() + "rejectCorruptRecordSize" + IoCapture::c_fileExtension;
+    {
+        auto capture = IoCapture::open(path);
+        ASSERT_TRUE(capture);
+        const std::vector<std::byte> data = { std::byte(1), std::byte(2) };
+        capture->record(IoCaptureDirection::Received, data, 10);
+    }
+
+    // the size of the record follows the magic and its timestamp
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(sizeof(IoCapture::c_magic) - 1 + sizeof(uint64_t));
+        const uint32_t size = 0xfffffff0;
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    }
+
+    auto records = IoCapture::load(path);
+    ASSERT_FALSE(records);
+    ASSERT_EQ(ZenError_Io_MsgCorrupt, records.error());
+
+    std::remove(path.c_str());
+}
+
+TEST(Replay, negotiateWithCapturedReplies) {
+    const std::string path = testing::TempDir() + "negotiateWithCapturedReplies" + IoCapture::c_fileExtension;
+
+    // a legacy sensor which streams ten frames after the negotiation, one of them split and preceded by garbage
+    constexpr size_t streamedFrames = 10;
+    {
+        auto capture = IoCapture::open(path);
+        ASSERT_TRUE(capture);
+        recordNegotiation(*capture);
+
+        std::vector<std::byte> stream = { std::byte(0xff) };
+        for (size_t idx = 0; idx < streamedFrames; ++idx) {
+            const auto frame = makeFrame(9, std::vector<std::byte>(32, std::byte(idx)));
+            stream.insert(stream.end(), frame.begin(), frame.end());
+        }
+        const auto middle = stream.size() / 2;
+        capture->record(IoCaptureDirection::Received, gsl::make_span(stream.data(), middle), 5000);
+        capture->record(IoCaptureDirection::Received, gsl::make_span(stream.data() + middle, stream.size() - middle), 6000);
+    }
+
+    ConnectionNegotiator negotiator;
+    ModbusCommunicator communicator(negotiator, std::make_unique<modbus::LpFrameFactory>(), std::make_unique<modbus::LpFrameParser>());
+
+    ReplaySystem system;
+    auto ioInterface = system.obtain(replayDesc("fast:" + path), communicator);
+    ASSERT_TRUE(ioInterface);
+    auto& replay = static_cast<ReplayInterface&>(**ioInterface);
+    ASSERT_TRUE(replay.equals(replayDesc("fast:" + path)));
+    ASSERT_FALSE(replay.equals(replayDesc(path)));
+    communicator.init(std::move(*ioInterface));
+
+    auto sensorConfig = negotiator.negotiate(communicator, 57600);
+    ASSERT_TRUE(sensorConfig);
+    ASSERT_EQ(0, sensorConfig->version);
+
+    for (int i = 0; i < 200 && !replay.finished(); ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ASSERT_TRUE(replay.finished());
+
+    const auto statistics = replay.replayStatistics();
+    ASSERT_EQ(2 + streamedFrames, statistics.frames);
+    ASSERT_EQ(4u, replay.ioStatistics()->readCount);
+    ASSERT_EQ(statistics.bytes, replay.ioStatistics()->bytesRead);
+
+    std::remove(path.c_str());
+}
+
+TEST(Replay, replayCreatedCaptureByName) {
+    const auto directory = std::filesystem::temp_directory_path() / "openzen-replay-test" / "recorded-sessions-of-the-lab";
+    std::filesystem::create_directories(directory);
+    IoCapture::setDirectory(directory.string());
+
+    ZenSensorDesc sensorDesc{};
+    std::strncpy(sensorDesc.ioType, "LinuxDevice", sizeof(sensorDesc.ioType) - 1);
+    std::strncpy(sensorDesc.identifier, "devicefile:/dev/ttyUSB0", sizeof(sensorDesc.identifier) - 1);
+
+    std::string path;
+    {
+        auto capture = IoCapture::create(sensorDesc);
+        ASSERT_TRUE(capture);
+        path = capture->path();
+        recordNegotiation(*capture);
+    }
+
+    // the name of the capture is short enough for an identifier, also with the fast: prefix
+    const std::string identifier = "fast:" + std::filesystem::path(path).filename().string();
+    ASSERT_LT(identifier.size(), sizeof(ZenSensorDesc::identifier));
+
+    ConnectionNegotiator negotiator;
+    ModbusCommunicator communicator(negotiator, std::make_unique<modbus::LpFrameFactory>(), std::make_unique<modbus::LpFrameParser>());
+
+    ReplaySystem system;
+    auto ioInterface = system.obtain(replayDesc(identifier), communicator);
+    IoCapture::setDirectory("");
+    ASSERT_TRUE(ioInterface);
+    communicator.init(std::move(*ioInterface));
+
+    auto sensorConfig = negotiator.negotiate(communicator, 57600);
+    ASSERT_TRUE(sensorConfig);
+    ASSERT_EQ(0, sensorConfig->version);
+
+    std::filesystem::remove_all(directory.parent_path());
+}
+
+TEST(Replay, rejectTruncatedIdentifier) {
+    SensorClient client(0);
+    const std::string path = "fast:/home/user/recorded-sessions/LinuxDevice-devicefile__dev_ttyUSB0-1602912345678901234.zencap";
+    auto sensor = client.obtain(ReplaySystem::KEY, path, 0);
+    ASSERT_FALSE(sensor);
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier, sensor.error());
+}
@@ -0,0 +1,104 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "io/interfaces/TestSensorInterface.h"
+#include "OpenZen.h"
+
+#include <chrono>
+#include <map>
+
+TEST(TestSensorConfig, parse) {
+    auto defaults = zen::TestSensorConfig::parse("");
+    ASSERT_TRUE(defaults.has_value());
+    ASSERT_EQ(100u, defaults->rate);
+    ASSERT_TRUE(defaults->imu);
+    ASSERT_FALSE(defaults->gnss);
+    ASSERT_EQ(zen::TestSensorWaveform::Constant, defaults->waveform);
+    ASSERT_EQ(0u, defaults->instance);
+
+    auto config = zen::TestSensorConfig::parse("rate=0;payload=imu+gnss;waveform=noise;instance=63;");
+    ASSERT_TRUE(config.has_value());
+    ASSERT_EQ(0u, config->rate);
+    ASSERT_TRUE(config->imu);
+    ASSERT_TRUE(config->gnss);
+    ASSERT_EQ(zen::TestSensorWaveform::Noise, config->waveform);
+    ASSERT_EQ(63u, config->instance);
+
+    auto gnssOnly = zen::TestSensorConfig::parse("payload=gnss");
+    ASSERT_TRUE(gnssOnly.has_value());
+    ASSERT_FALSE(gnssOnly->imu);
+    ASSERT_TRUE(gnssOnly->gnss);
+
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier, zen::TestSensorConfig::parse("rate=fast").error());
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier, zen::TestSensorConfig::parse("rate=-1").error());
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier, zen::TestSensorConfig::parse("payload=mag").error());
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier, zen::TestSensorConfig::parse("waveform=square").error());
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier, zen::TestSensorConfig::parse("speed=10").error());
+}
+
+TEST(TestSensorSystem, multipleInstances) {
+    auto client = zen::make_client();
+    ASSERT_EQ(ZenError_None, client.first);
+
+    ASSERT_EQ(ZenSensorInitError_UnknownIdentifier,
+        client.second.obtainSensorByName("TestSensor", "waveform=square").first);
+
+    auto first = client.second.obtainSensorByName("TestSensor", "rate=2000;payload=imu+gnss;waveform=sine;instance=1");
+    ASSERT_EQ(ZenSensorInitError_None, first.first);
+    auto second = client.second.obtainSensorByName("TestSensor", "rate=2000;payload=imu+gnss;waveform=sine;instance=2");
+    ASSERT_EQ(ZenSensorInitError_None, second.first);
+    ASSERT_NE(first.second.sensor().handle, second.second.sensor().handle);
+
+    struct Received
+    {
+        int imu = 0;
+        int gnss = 0;
+        int lastImuFrame = -1;
+        int lastGnssFrame = -1;
+    };
+    std::map<uintptr_t, Received> received;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(250);
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto event = client.second.pollNextEvent();
+        if (!event)
+            continue;
+
+        // every instance publishes with its own handle and frame count
+        ASSERT_TRUE(event->sensor.handle == first.second.sensor().handle
+            || event->sensor.handle == second.second.sensor().handle);
+        auto& counts = received[event->sensor.handle];
+        if (event->eventType == ZenEventType_ImuData) {
+            ASSERT_EQ(1u, event->component.handle);
+            ASSERT_GT(event->data.imuData.frameCount, counts.lastImuFrame);
+            counts.lastImuFrame = event->data.imuData.frameCount;
+            ++counts.imu;
+        } else if (event->eventType == ZenEventType_GnssData) {
+            ASSERT_EQ(2u, event->component.handle);
+            ASSERT_EQ(ZenGnssFixType_3dFix, event->data.gnssData.fixType);
+            ASSERT_GT(event->data.gnssData.frameCount, counts.lastGnssFrame);
+            counts.lastGnssFrame = event->data.gnssData.frameCount;
+            ++counts.gnss;
+        }
+    }
+
+    ASSERT_EQ(2u, received.size());
+    for (const auto& entry : received) {
+        // 500 samples are due in 250 ms, leave room for slow machines
+        ASSERT_GT(entry.second.imu, 100);
+        ASSERT_GT(entry.second.gnss, 100);
+    }
+
+    first.second.release();
+    second.second.release();
+    client.second.close();
+}
@@ -0,0 +1,104 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "utility/LockingQueue.h"
+
+#include <atomic>
+#include <thread>
+
+TEST(LockingQueue, unboundedByDefault) {
+    zen::LockingQueue<int> queue;
+    for (int i = 0; i < 10000; ++i)
+        ASSERT_TRUE(queue.push(i));
+}
+
+TEST(LockingQueue, dropNewest) {
+    zen::LockingQueue<int> queue;
+    queue.setCapacity(2);
+    queue.setOverflowPolicy(zen::QueueOverflowPolicy::DropNewest);
+
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+    ASSERT_FALSE(queue.push(3));
+
+    ASSERT_EQ(1, *queue.tryToPop());
+    ASSERT_EQ(2, *queue.tryToPop());
+    ASSERT_FALSE(queue.tryToPop().has_value());
+}
+
+TEST(LockingQueue, dropOldest) {
+    zen::LockingQueue<int> queue;
+    queue.setCapacity(2);
+    queue.setOverflowPolicy(zen::QueueOverflowPolicy::DropOldest);
+
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+    ASSERT_FALSE(queue.push(3));
+
+    ASSERT_EQ(2, *queue.tryToPop());
+    ASSERT_EQ(3, *queue.tryToPop());
+}
+
+TEST(LockingQueue, blockUntilConsumed) {
+    zen::LockingQueue<int> queue;
+    queue.setCapacity(1);
+    queue.setOverflowPolicy(zen::QueueOverflowPolicy::Block);
+    ASSERT_TRUE(queue.push(1));
+
+    std::atomic_bool pushed(false);
+    std::thread producer([&]() {
+        pushed = queue.push(2);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(pushed);
+
+    ASSERT_EQ(1, *queue.tryToPop());
+    producer.join();
+    ASSERT_TRUE(pushed);
+    ASSERT_EQ(2, *queue.tryToPop());
+}
+
+TEST(LockingQueue, interruptBlockedProducer) {
+    zen::LockingQueue<int> queue;
+    queue.setCapacity(1);
+    queue.setOverflowPolicy(zen::QueueOverflowPolicy::Block);
+    ASSERT_TRUE(queue.push(1));
+
+    std::atomic_bool pushed(true);
+    std::thread producer([&]() {
+        pushed = queue.push(2);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.interruptBlockingPush();
+    producer.join();
+    queue.resumeBlockingPush();
+
+    // the blocked element was dropped instead
+    ASSERT_FALSE(pushed);
+    ASSERT_EQ(1, *queue.tryToPop());
+    ASSERT_FALSE(queue.tryToPop().has_value());
+}
+
+TEST(LockingQueue, pushOrReplace) {
+    zen::LockingQueue<int> queue;
+    const auto isOdd = [](int value) { return value % 2 != 0; };
+
+    ASSERT_TRUE(queue.pushOrReplace(2, isOdd));
+    ASSERT_TRUE(queue.pushOrReplace(3, isOdd));
+    ASSERT_TRUE(queue.pushOrReplace(5, isOdd));
+
+    ASSERT_EQ(2, *queue.tryToPop());
+    ASSERT_EQ(5, *queue.tryToPop());
+    ASSERT_FALSE(queue.tryToPop().has_value());
+}
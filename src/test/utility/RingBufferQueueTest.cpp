@@ -0,0 +1,271 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "EventQueue.h"
+#include "utility/RingBufferQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+TEST(RingBufferQueue, capacityRoundedToPowerOfTwo) {
+    zen::RingBufferQueue<int> queue(100);
+    ASSERT_EQ(128u, queue.capacity());
+}
+
+TEST(RingBufferQueue, pushFailsWhenFull) {
+    zen::RingBufferQueue<int> queue(4);
+
+    for (int i = 0; i < 4; ++i)
+        ASSERT_TRUE(queue.push(i));
+    ASSERT_FALSE(queue.push(4));
+    ASSERT_EQ(4u, queue.size());
+
+    // first in, first out and the slot becomes usable again
+    ASSERT_EQ(0, *queue.tryToPop());
+    ASSERT_TRUE(queue.push(5));
+
+    for (int expected : { 1, 2, 3, 5 })
+        ASSERT_EQ(expected, *queue.tryToPop());
+    ASSERT_FALSE(queue.tryToPop().has_value());
+}
+
+TEST(RingBufferQueue, waitToPopForTimesOut) {
+    zen::RingBufferQueue<int> queue(4);
+    ASSERT_FALSE(queue.waitToPopFor(std::chrono::milliseconds(10)).has_value());
+}
+
+TEST(RingBufferQueue, multipleProducersSingleConsumer) {
+    constexpr int nProducers = 4;
+    constexpr int nValuesPerProducer = 20000;
+
+    zen::RingBufferQueue<int> queue(256);
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < nProducers; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (int i = 0; i < nValuesPerProducer; ++i) {
+                while (!queue.push(producer * nValuesPerProducer + i))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    // values of each producer have to arrive in order and none may be lost
+    std::vector<int> lastValue(nProducers, -1);
+    for (int received = 0; received < nProducers * nValuesPerProducer; ++received) {
+        auto value = queue.waitToPopFor(std::chrono::seconds(5));
+        ASSERT_TRUE(value.has_value());
+
+        const int producer = *value / nValuesPerProducer;
+        const int index = *value % nValuesPerProducer;
+        ASSERT_EQ(lastValue[producer] + 1, index);
+        lastValue[producer] = index;
+    }
+
+    for (auto& thread : producers)
+        thread.join();
+
+    ASSERT_FALSE(queue.tryToPop().has_value());
+}
+
+TEST(EventQueue, switchToLockFree) {
+    zen::EventQueue queue;
+    ASSERT_EQ(ZenEventQueueType_Locking, queue.type());
+
+    ZenEvent event{};
+    event.eventType = ZenEventType_ImuData;
+    ASSERT_TRUE(queue.push(event));
+
+    // switching the container drops all queued events
+    ASSERT_EQ(ZenError_None, queue.setType(ZenEventQueueType_LockFree, 2));
+    ASSERT_EQ(ZenEventQueueType_LockFree, queue.type());
+    ASSERT_FALSE(queue.tryToPop().has_value());
+
+    ASSERT_TRUE(queue.push(event));
+    ASSERT_TRUE(queue.push(event));
+    ASSERT_FALSE(queue.push(event));
+
+    auto popped = queue.waitToPop();
+    ASSERT_TRUE(popped.has_value());
+    ASSERT_EQ(ZenEventType_ImuData, (*popped)->eventType);
+
+    ASSERT_EQ(ZenError_InvalidArgument, queue.setType(ZenEventQueueType_Max));
+}
+
+TEST(EventQueue, popManyFromBothContainers) {
+    for (auto type : { ZenEventQueueType_Locking, ZenEventQueueType_LockFree }) {
+        zen::EventQueue queue;
+        ASSERT_EQ(ZenError_None, queue.setType(type, 16));
+
+        for (int i = 0; i < 5; ++i) {
+            ZenEvent event{};
+            event.eventType = ZenEventType_ImuData;
+            event.data.imuData.frameCount = i;
+            ASSERT_TRUE(queue.push(event));
+        }
+
+        std::vector<zen::SharedEvent> events(3);
+        ASSERT_EQ(3u, queue.tryToPopMany(events.begin(), events.size()));
+        ASSERT_EQ(0, events[0]->data.imuData.frameCount);
+        ASSERT_EQ(2, events[2]->data.imuData.frameCount);
+
+        ASSERT_EQ(2u, queue.waitToPopManyFor(events.begin(), events.size(), std::chrono::milliseconds(10)));
+        ASSERT_EQ(3, events[0]->data.imuData.frameCount);
+        ASSERT_EQ(4, events[1]->data.imuData.frameCount);
+
+        ASSERT_EQ(0u, queue.tryToPopMany(events.begin(), events.size()));
+        ASSERT_EQ(0u, queue.waitToPopManyFor(events.begin(), events.size(), std::chrono::milliseconds(10)));
+    }
+}
+
+TEST(EventQueue, lockFreeOverflowPolicies) {
+    zen::EventQueue queue;
+    ASSERT_EQ(ZenError_None, queue.setType(ZenEventQueueType_LockFree, 2));
+    ASSERT_EQ(2u, queue.capacity());
+
+    ZenEvent event{};
+    event.eventType = ZenEventType_ImuData;
+    for (int i = 0; i < 2; ++i) {
+        event.data.imuData.frameCount = i;
+        ASSERT_TRUE(queue.push(event));
+    }
+
+    ASSERT_EQ(ZenError_None, queue.setOverflowPolicy(ZenEventQueueOverflowPolicy_DropOldest));
+    event.data.imuData.frameCount = 2;
+    ASSERT_FALSE(queue.push(event));
+    ASSERT_EQ(1, (*queue.tryToPop())->data.imuData.frameCount);
+
+    // a blocked producer is released by an interrupt and drops its event
+    ASSERT_EQ(ZenError_None, queue.setOverflowPolicy(ZenEventQueueOverflowPolicy_Block));
+    ASSERT_TRUE(queue.push(event));
+
+    std::atomic_bool pushed(true);
+    std::thread producer([&]() {
+        pushed = queue.push(event);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.interruptBlockingPush();
+    producer.join();
+    queue.resumeBlockingPush();
+    ASSERT_FALSE(pushed);
+
+    ASSERT_EQ(ZenError_InvalidArgument, queue.setOverflowPolicy(ZenEventQueueOverflowPolicy_Max));
+}
+
+TEST(EventQueue, subscribersShareEvent) {
+    zen::EventQueue locking;
+    zen::EventQueue lockFree;
+    ASSERT_EQ(ZenError_None, lockFree.setType(ZenEventQueueType_LockFree, 4));
+
+    ZenEvent event{};
+    event.eventType = ZenEventType_ImuData;
+    event.data.imuData.frameCount = 42;
+
+    auto shared = zen::SharedEvent::make(event);
+    ASSERT_TRUE(locking.push(shared));
+    ASSERT_TRUE(lockFree.push(shared));
+    ASSERT_EQ(3u, shared.useCount());
+
+    // popped handles release the queue's reference once they are destroyed
+    ASSERT_EQ(42, (*locking.tryToPop())->data.imuData.frameCount);
+    ASSERT_EQ(2u, shared.useCount());
+
+    std::vector<zen::SharedEvent> events(2);
+    ASSERT_EQ(1u, lockFree.tryToPopMany(events.begin(), events.size()));
+    ASSERT_EQ(42, events[0]->data.imuData.frameCount);
+    events.clear();
+    ASSERT_EQ(1u, shared.useCount());
+}
+
+TEST(EventQueue, conflateSamples) {
+    zen::EventQueue queue;
+    ASSERT_EQ(ZenError_None, queue.setType(ZenEventQueueType_Conflating));
+
+    ZenEvent event{};
+    event.eventType = ZenEventType_ImuData;
+    event.component.handle = 1;
+    for (int i = 0; i < 5; ++i) {
+        event.data.imuData.frameCount = i;
+        ASSERT_TRUE(queue.push(event));
+    }
+
+    ZenEvent gnss{};
+    gnss.eventType = ZenEventType_GnssData;
+    gnss.component.handle = 2;
+    ASSERT_TRUE(queue.push(gnss));
+
+    // control events are never conflated
+    ZenEvent disconnected{};
+    disconnected.eventType = ZenEventType_SensorDisconnected;
+    ASSERT_TRUE(queue.push(disconnected));
+    ASSERT_TRUE(queue.push(disconnected));
+
+    // the unread sample keeps its place in the queue but carries the newest data
+    auto imu = queue.tryToPop();
+    ASSERT_EQ(ZenEventType_ImuData, (*imu)->eventType);
+    ASSERT_EQ(4, (*imu)->data.imuData.frameCount);
+    ASSERT_EQ(ZenEventType_GnssData, (*queue.tryToPop())->eventType);
+    ASSERT_EQ(ZenEventType_SensorDisconnected, (*queue.tryToPop())->eventType);
+    ASSERT_EQ(ZenEventType_SensorDisconnected, (*queue.tryToPop())->eventType);
+    ASSERT_FALSE(queue.tryToPop().has_value());
+}
+
+#ifdef __linux__
+namespace {
+    bool isReadable(int fd) {
+        pollfd pfd{ fd, POLLIN, 0 };
+        return ::poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+    }
+}
+
+TEST(EventQueue, notificationFdCoalescesBursts) {
+    for (auto type : { ZenEventQueueType_Locking, ZenEventQueueType_LockFree }) {
+        zen::EventQueue queue;
+        ASSERT_EQ(ZenError_None, queue.setType(type));
+
+        ZenEvent event{};
+        event.eventType = ZenEventType_ImuData;
+        ASSERT_TRUE(queue.push(event));
+
+        // events queued before the eventfd was requested are signalled as well
+        const auto fd = queue.notificationFd();
+        ASSERT_TRUE(fd.has_value());
+        ASSERT_EQ(*fd, *queue.notificationFd());
+        ASSERT_TRUE(isReadable(*fd));
+
+        for (int i = 0; i < 10; ++i)
+            ASSERT_TRUE(queue.push(event));
+
+        uint64_t counter = 0;
+        ASSERT_EQ(ssize_t(sizeof(counter)), ::read(*fd, &counter, sizeof(counter)));
+        ASSERT_EQ(1u, counter);
+
+        std::vector<zen::SharedEvent> events;
+        ASSERT_EQ(11u, queue.tryToPopMany(std::back_inserter(events), 64));
+        ASSERT_FALSE(isReadable(*fd));
+
+        // the first push after draining signals again, the eventfd is reset by the empty pop
+        ASSERT_TRUE(queue.push(event));
+        ASSERT_TRUE(isReadable(*fd));
+        ASSERT_TRUE(queue.tryToPop().has_value());
+        ASSERT_TRUE(isReadable(*fd));
+        ASSERT_FALSE(queue.tryToPop().has_value());
+        ASSERT_FALSE(isReadable(*fd));
+    }
+}
+#endif
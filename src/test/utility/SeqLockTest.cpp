@@ -0,0 +1,57 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#include <gtest/gtest.h>
+
+#include "utility/SeqLock.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+TEST(SeqLock, loadBeforeStore) {
+    zen::SeqLock<int> latest;
+    int value = 7;
+    ASSERT_EQ(0u, latest.load(value));
+    ASSERT_EQ(7, value);
+
+    latest.store(1);
+    latest.store(2);
+    ASSERT_EQ(2u, latest.load(value));
+    ASSERT_EQ(2, value);
+}
+
+TEST(SeqLock, readersNeverSeeTornValues) {
+    using Sample = std::array<uint64_t, 32>;
+    zen::SeqLock<Sample> latest;
+    std::atomic_bool done(false);
+
+    std::thread writer([&]() {
+        for (uint64_t i = 1; i <= 200000; ++i)
+            latest.update([i](Sample& sample) { sample.fill(i); });
+        done = true;
+    });
+
+    uint64_t lastSeq = 0;
+    while (!done) {
+        Sample sample;
+        const uint64_t seq = latest.load(sample);
+        if (seq == 0)
+            continue;
+
+        // all elements come from the same write, which is the write the sequence counts
+        for (auto element : sample)
+            ASSERT_EQ(seq, element);
+        ASSERT_GE(seq, lastSeq);
+        lastSeq = seq;
+    }
+
+    writer.join();
+}
@@ -0,0 +1,29 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_UTILITY_HOSTCLOCK_H_
+#define ZEN_UTILITY_HOSTCLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+
+namespace zen
+{
+    /** Monotonic host time in nanoseconds, used to stamp received and queued events.
+     *  Only differences between two values are meaningful.
+     */
+    inline uint64_t hostTimestampNs() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+#endif
@@ -11,6 +11,7 @@
 #ifndef ZEN_UTILITY_LOCKINGQUEUE_H_
 #define ZEN_UTILITY_LOCKINGQUEUE_H_
 
+#include <algorithm>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
@@ -18,12 +19,24 @@
 
 namespace zen
 {
+    /** Behaviour of a bounded queue when an element is pushed while it is full */
+    enum class QueueOverflowPolicy
+    {
+        DropOldest,
+        DropNewest,
+        Block
+    };
+
     template <typename T, typename Container = std::deque<T>>
     class LockingQueue
     {
     public:
         LockingQueue()
-            : m_nWaiters(0)
+            : m_capacity(0)
+            , m_policy(QueueOverflowPolicy::DropNewest)
+            , m_nWaiters(0)
+            , m_nBlockedProducers(0)
+            , m_nInterrupts(0)
             , m_terminate(false)
         {}
 
@@ -34,9 +47,10 @@ namespace zen
 
             lock.unlock();
             m_cv.notify_all();
+            m_notFullCv.notify_all();
 
             lock.lock();
-            m_cv.wait(lock, [this]() { return m_nWaiters == 0; });
+            m_cv.wait(lock, [this]() { return m_nWaiters == 0 && m_nBlockedProducers == 0; });
         }
 
         void clear()
@@ -47,32 +61,112 @@ namespace zen
 
             lock.unlock();
             m_cv.notify_all();
+            m_notFullCv.notify_all();
 
             lock.lock();
-            m_cv.wait(lock, [this]() { return m_nWaiters == 0; });
+            m_cv.wait(lock, [this]() { return m_nWaiters == 0 && m_nBlockedProducers == 0; });
             m_terminate = false;
         }
 
-        void push(const T& value)
+        /** Limits the number of queued elements, zero means unbounded */
+        void setCapacity(size_t capacity)
         {
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_container.push_back(value);
-            m_cv.notify_one();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_capacity = capacity;
+            while (m_capacity != 0 && m_container.size() > m_capacity)
+                m_container.pop_front();
+
+            m_notFullCv.notify_all();
+        }
+
+        void setOverflowPolicy(QueueOverflowPolicy policy)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_policy = policy;
+            m_notFullCv.notify_all();
+        }
+
+        /** While interrupted, pushing to a full queue with QueueOverflowPolicy::Block drops the
+         * new element instead of waiting. Interrupts nest and have to be undone by resumeBlockingPush.
+         */
+        void interruptBlockingPush()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_nInterrupts;
+            m_notFullCv.notify_all();
         }
 
-        void push(T&& value)
+        void resumeBlockingPush()
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_container.push_back(std::move(value));
-            m_cv.notify_one();
+            --m_nInterrupts;
+        }
+
+        /** Returns false if an element was dropped because the queue is full */
+        bool push(const T& value)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            const auto room = makeRoom(lock);
+            if (room != Room::Full)
+            {
+                m_container.push_back(value);
+                m_cv.notify_one();
+            }
+            return room == Room::Available;
+        }
+
+        bool push(T&& value)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            const auto room = makeRoom(lock);
+            if (room != Room::Full)
+            {
+                m_container.push_back(std::move(value));
+                m_cv.notify_one();
+            }
+            return room == Room::Available;
+        }
+
+        /** Replaces the first queued element for which matches returns true, otherwise pushes the value.
+         * Returns false if an element was dropped because the queue is full.
+         */
+        template <class Predicate>
+        bool pushOrReplace(const T& value, Predicate matches)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto it = std::find_if(m_container.begin(), m_container.end(), matches);
+            if (it != m_container.end())
+            {
+                *it = value;
+                return true;
+            }
+
+            const auto room = makeRoom(lock);
+            if (room != Room::Full)
+            {
+                m_container.push_back(value);
+                m_cv.notify_one();
+            }
+            return room == Room::Available;
         }
 
         template <class... Args>
-        void emplace(Args&&... args)
+        bool emplace(Args&&... args)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            const auto room = makeRoom(lock);
+            if (room != Room::Full)
+            {
+                m_container.emplace_back(std::forward<Args>(args)...);
+                m_cv.notify_one();
+            }
+            return room == Room::Available;
+        }
+
+        bool empty() const noexcept
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_container.emplace_back(std::forward<Args>(args)...);
-            m_cv.notify_one();
+            return m_container.empty();
         }
 
         std::optional<T> tryToPop() noexcept
@@ -83,6 +177,7 @@ namespace zen
 
             std::optional<T> result(std::move(m_container.front()));
             m_container.pop_front();
+            notifyBlockedProducers();
             return result;
         }
 
@@ -113,15 +208,117 @@ namespace zen
 
             std::optional<T> result(std::move(m_container.front()));
             m_container.pop_front();
+            notifyBlockedProducers();
             return result;
         }
 
+        /** Moves up to maxCount elements to out while holding the lock once, and returns how many were moved */
+        template <class OutputIt>
+        size_t tryToPopMany(OutputIt out, size_t maxCount) noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return popMany(out, maxCount);
+        }
+
+        /** Waits until at least one element is available, then moves up to maxCount elements to out */
+        template <class OutputIt, class Rep, class Period>
+        size_t waitToPopManyFor(OutputIt out, size_t maxCount, std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            if (maxCount == 0)
+                return 0;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            ++m_nWaiters;
+            m_cv.wait_for(lock, waitTime, [this]() { return !m_container.empty() || m_terminate; });
+            --m_nWaiters;
+
+            if (m_terminate)
+            {
+                lock.unlock();
+                m_cv.notify_all();
+                return 0;
+            }
+
+            return popMany(out, maxCount);
+        }
+
     private:
+        enum class Room
+        {
+            Available,
+            DroppedOldest,
+            Full
+        };
+
+        Room makeRoom(std::unique_lock<std::mutex>& lock)
+        {
+            if (m_policy == QueueOverflowPolicy::Block && isFull())
+            {
+                ++m_nBlockedProducers;
+                m_notFullCv.wait(lock, [this]() {
+                    return !isFull() || m_policy != QueueOverflowPolicy::Block || m_nInterrupts != 0 || m_terminate;
+                });
+                --m_nBlockedProducers;
+
+                if (m_terminate)
+                {
+                    m_cv.notify_all();
+                    return Room::Full;
+                }
+            }
+
+            return makeRoomWithoutBlocking();
+        }
+
+        Room makeRoomWithoutBlocking()
+        {
+            if (!isFull())
+                return Room::Available;
+
+            if (m_policy == QueueOverflowPolicy::DropOldest)
+            {
+                m_container.pop_front();
+                return Room::DroppedOldest;
+            }
+
+            return Room::Full;
+        }
+
+        bool isFull() const noexcept
+        {
+            return m_capacity != 0 && m_container.size() >= m_capacity;
+        }
+
+        void notifyBlockedProducers() noexcept
+        {
+            if (m_nBlockedProducers != 0)
+                m_notFullCv.notify_all();
+        }
+
+        template <class OutputIt>
+        size_t popMany(OutputIt out, size_t maxCount) noexcept
+        {
+            const size_t count = std::min(maxCount, m_container.size());
+            auto end = m_container.begin() + count;
+            std::move(m_container.begin(), end, out);
+            m_container.erase(m_container.begin(), end);
+            if (count != 0)
+                notifyBlockedProducers();
+            return count;
+        }
+
         Container m_container;
         std::condition_variable m_cv;
-        std::mutex m_mutex;
+        std::condition_variable m_notFullCv;
+        mutable std::mutex m_mutex;
+
+        size_t m_capacity;
+        QueueOverflowPolicy m_policy;
 
         unsigned int m_nWaiters;
+        unsigned int m_nBlockedProducers;
+        unsigned int m_nInterrupts;
         bool m_terminate;
     };
 }
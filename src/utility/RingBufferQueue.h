@@ -0,0 +1,293 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_UTILITY_RINGBUFFERQUEUE_H_
+#define ZEN_UTILITY_RINGBUFFERQUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace zen
+{
+    /** Size used to pad the producer and consumer indices onto separate cache lines */
+    constexpr size_t c_cacheLineSize = 64;
+
+    /**
+    Bounded lock-free queue with a fixed capacity, based on the sequence-numbered ring buffer
+    by Dmitry Vyukov. Any number of threads may push and pop concurrently, but the typical
+    use is many sensors pushing into a queue that is drained by a single consumer.
+
+    Producers and consumers never take a lock, except when a consumer is blocked in waitToPop.
+    Only then does a producer pay for a condition variable notification, so blocking is an
+    opt-in slow path.
+    */
+    template <typename T>
+    class RingBufferQueue
+    {
+    public:
+        /** The capacity is rounded up to the next power of two */
+        explicit RingBufferQueue(size_t capacity)
+            : m_mask(roundUpToPowerOfTwo(capacity) - 1)
+            , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+            , m_nWaiters(0)
+            , m_terminate(false)
+        {
+            for (size_t idx = 0; idx <= m_mask; ++idx)
+                m_cells[idx].sequence.store(idx, std::memory_order_relaxed);
+
+            m_head.value.store(0, std::memory_order_relaxed);
+            m_tail.value.store(0, std::memory_order_relaxed);
+        }
+
+        ~RingBufferQueue()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_terminate = true;
+
+            lock.unlock();
+            m_cv.notify_all();
+
+            lock.lock();
+            m_cv.wait(lock, [this]() { return m_nWaiters.load() == 0; });
+        }
+
+        RingBufferQueue(const RingBufferQueue&) = delete;
+        RingBufferQueue& operator=(const RingBufferQueue&) = delete;
+
+        size_t capacity() const noexcept { return m_mask + 1; }
+
+        /** Returns an estimate of the number of queued elements */
+        size_t size() const noexcept
+        {
+            const size_t tail = m_tail.value.load(std::memory_order_acquire);
+            const size_t head = m_head.value.load(std::memory_order_acquire);
+            return head > tail ? head - tail : 0;
+        }
+
+        bool empty() const noexcept { return size() == 0; }
+
+        /** Drops all queued elements and releases any waiting consumers */
+        void clear()
+        {
+            while (tryToPop()) {}
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_terminate = true;
+
+            lock.unlock();
+            m_cv.notify_all();
+
+            lock.lock();
+            m_cv.wait(lock, [this]() { return m_nWaiters.load() == 0; });
+            m_terminate = false;
+        }
+
+        /** Returns false if the queue is full, in which case the value is not queued */
+        bool push(const T& value) noexcept
+        {
+            return emplace(value);
+        }
+
+        bool push(T&& value) noexcept
+        {
+            return emplace(std::move(value));
+        }
+
+        template <class... Args>
+        bool emplace(Args&&... args) noexcept
+        {
+            Cell* cell;
+            size_t pos = m_head.value.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0)
+                {
+                    if (m_head.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    pos = m_head.value.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = T(std::forward<Args>(args)...);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+
+            notifyWaiters();
+            return true;
+        }
+
+        std::optional<T> tryToPop() noexcept
+        {
+            Cell* cell;
+            size_t pos = m_tail.value.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                cell = &m_cells[pos & m_mask];
+                const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (diff == 0)
+                {
+                    if (m_tail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                {
+                    return std::nullopt;
+                }
+                else
+                {
+                    pos = m_tail.value.load(std::memory_order_relaxed);
+                }
+            }
+
+            std::optional<T> result(std::move(cell->value));
+            cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+            return result;
+        }
+
+        std::optional<T> waitToPop() noexcept
+        {
+            return waitToPopWith([this](std::unique_lock<std::mutex>& lock, auto predicate) {
+                m_cv.wait(lock, predicate);
+            });
+        }
+
+        template <class Rep, class Period>
+        std::optional<T> waitToPopFor(std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            return waitToPopWith([this, waitTime](std::unique_lock<std::mutex>& lock, auto predicate) {
+                m_cv.wait_for(lock, waitTime, predicate);
+            });
+        }
+
+        /** Moves up to maxCount elements to out and returns how many were moved */
+        template <class OutputIt>
+        size_t tryToPopMany(OutputIt out, size_t maxCount) noexcept
+        {
+            size_t count = 0;
+            for (; count < maxCount; ++count)
+            {
+                auto value = tryToPop();
+                if (!value)
+                    break;
+
+                *out++ = std::move(*value);
+            }
+            return count;
+        }
+
+        /** Waits until at least one element is available, then moves up to maxCount elements to out */
+        template <class OutputIt, class Rep, class Period>
+        size_t waitToPopManyFor(OutputIt out, size_t maxCount, std::chrono::duration<Rep, Period> waitTime) noexcept
+        {
+            if (maxCount == 0)
+                return 0;
+
+            auto first = waitToPopFor(waitTime);
+            if (!first)
+                return 0;
+
+            *out++ = std::move(*first);
+            return 1 + tryToPopMany(out, maxCount - 1);
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic_size_t sequence;
+            T value;
+        };
+
+        struct alignas(c_cacheLineSize) PaddedIndex
+        {
+            std::atomic_size_t value;
+        };
+
+        static size_t roundUpToPowerOfTwo(size_t value) noexcept
+        {
+            size_t result = 2;
+            while (result < value)
+                result <<= 1;
+            return result;
+        }
+
+        template <class WaitFunction>
+        std::optional<T> waitToPopWith(WaitFunction wait) noexcept
+        {
+            if (auto result = tryToPop())
+                return result;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            // Producers only notify when they observe a waiter, so the waiter has to be
+            // registered before the queue is checked again under the lock.
+            m_nWaiters.fetch_add(1);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            std::optional<T> result;
+            wait(lock, [this, &result]() {
+                if (m_terminate)
+                    return true;
+
+                result = tryToPop();
+                return result.has_value();
+            });
+            m_nWaiters.fetch_sub(1);
+
+            if (m_terminate)
+            {
+                lock.unlock();
+                m_cv.notify_all();
+                return std::nullopt;
+            }
+
+            return result;
+        }
+
+        void notifyWaiters() noexcept
+        {
+            // Pairs with the registration of the waiter in waitToPopFor
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_nWaiters.load(std::memory_order_relaxed) != 0)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_cv.notify_one();
+            }
+        }
+
+        PaddedIndex m_head;
+        PaddedIndex m_tail;
+
+        alignas(c_cacheLineSize) const size_t m_mask;
+        const std::unique_ptr<Cell[]> m_cells;
+
+        std::condition_variable m_cv;
+        std::mutex m_mutex;
+
+        std::atomic_uint m_nWaiters;
+        bool m_terminate;
+    };
+}
+
+#endif
@@ -0,0 +1,103 @@
+//===========================================================================//
+//
+// Copyright (C) 2020 LP-Research Inc.
+//
+// This file is part of OpenZen, under the MIT License.
+// See https://bitbucket.org/lpresearch/openzen/src/master/LICENSE for details
+// SPDX-License-Identifier: MIT
+//
+//===========================================================================//
+
+#ifndef ZEN_UTILITY_SEQLOCK_H_
+#define ZEN_UTILITY_SEQLOCK_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace zen
+{
+    /**
+    Holds the latest value written by a single writer thread, which any number of reader threads
+    can copy without taking a lock. The value is double buffered, so the writer never waits and a
+    reader reads the buffer the writer left last. A reader only has to retry if the writer
+    overwrote that buffer while it was copying it, which takes two more writes during one copy.
+    */
+    template <typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock copies its value byte-wise");
+
+    public:
+        SeqLock() noexcept
+            : m_version(0)
+        {
+            for (auto& buffer : m_buffers)
+                buffer.sequence.store(0, std::memory_order_relaxed);
+        }
+
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator=(const SeqLock&) = delete;
+
+        /** Lets write fill the next buffer in place. Must only be called by the writer thread */
+        template <class WriteFunction>
+        void update(WriteFunction write) noexcept
+        {
+            const uint64_t version = m_version.load(std::memory_order_relaxed) + 1;
+            auto& buffer = m_buffers[version & 1];
+
+            // An odd sequence marks the buffer as being written
+            buffer.sequence.store((version << 1) | 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            write(buffer.value);
+
+            buffer.sequence.store(version << 1, std::memory_order_release);
+            m_version.store(version, std::memory_order_release);
+        }
+
+        void store(const T& value) noexcept
+        {
+            update([&value](T& buffer) { std::memcpy(&buffer, &value, sizeof(T)); });
+        }
+
+        /** Copies the latest value to out and returns how many values were written so far.
+            Returns zero and leaves out untouched if no value was written yet. */
+        uint64_t load(T& out) const noexcept
+        {
+            for (;;)
+            {
+                const uint64_t version = m_version.load(std::memory_order_acquire);
+                if (version == 0)
+                    return 0;
+
+                const auto& buffer = m_buffers[version & 1];
+                const uint64_t before = buffer.sequence.load(std::memory_order_acquire);
+                if (before != version << 1)
+                    continue;
+
+                std::memcpy(&out, &buffer.value, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (buffer.sequence.load(std::memory_order_relaxed) == before)
+                    return version;
+            }
+        }
+
+        /** Returns how many values were written so far */
+        uint64_t version() const noexcept { return m_version.load(std::memory_order_acquire); }
+
+    private:
+        struct Buffer
+        {
+            std::atomic_uint64_t sequence;
+            T value;
+        };
+
+        std::atomic_uint64_t m_version;
+        Buffer m_buffers[2];
+    };
+}
+
+#endif